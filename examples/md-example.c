@@ -82,7 +82,7 @@ MakerDialogPropertySpec propSpecs[]={
     },
 
     {"KBType", MKDG_TYPE_STRING,
-	MKDG_PROPERTY_FLAG_FIXED_SET | MKDG_PROPERTY_FLAG_PREFER_RADIO_BUTTONS,
+	MKDG_PROPERTY_FLAG_FIXED_SET | MKDG_PROPERTY_FLAG_PREFER_RADIO_BUTTONS | MKDG_PROPERTY_FLAG_ENUM,
 //	MKDG_PROPERTY_FLAG_FIXED_SET | MKDG_PROPERTY_FLAG_HAS_TRANSLATION ,
 	"default", kbType_ids, NULL, NULL, NULL,
 	0.0, 25.0, 1.0, 0,
@@ -119,7 +119,7 @@ MakerDialogPropertySpec propSpecs[]={
 };
 
 void applyFunc(MakerDialogPropertyContext *ctx, MkdgValue *value){
-    g_printf("Key %s= %s\n", ctx->spec->key, mkdg_value_to_string(value,ctx->spec->toStringFormat));
+    g_printf("Key %s= %s\n", ctx->spec->key, mkdg_value_codec_to_string(mkdg_property_spec_get_codec(ctx->spec), value));
 }
 
 
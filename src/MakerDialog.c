@@ -29,8 +29,13 @@ extern gint makerDialogVerboseLevel;
 Mkdg *mkdg_new(){
     Mkdg *mDialog=g_new(Mkdg,1);
     mDialog->title=NULL;
+    mDialog->flags=0;
     mDialog->buttonSpecs=NULL;
     mDialog->propertyTable=mkdg_property_table_new();
+    mDialog->propertyArray=g_ptr_array_new();
+    mDialog->propertyIndex=NULL;
+    mDialog->dirtyBits=g_array_new(FALSE, TRUE, sizeof(gulong));
+    mDialog->dirtyPageBits=g_array_new(FALSE, TRUE, sizeof(gulong));
     mDialog->pageRoot=g_node_new(mDialog);
     mDialog->maxSizeInPixel.width=-1;
     mDialog->maxSizeInPixel.height=-1;
@@ -84,14 +89,155 @@ static GNode *mkdg_prepare_group_node(Mkdg *mDialog, const gchar *pageName, cons
     return result;
 }
 
-void mkdg_add_property(Mkdg *mDialog, MkdgPropertyContext *ctx){
+/* Rule targets are resolved on first evaluation, see mkdg_property_foreach_control_rule() */
+static void mkdg_prepare_rule_targets(MkdgPropertyContext *ctx){
+    if (!ctx->spec->rules || ctx->ruleTargets)
+	return;
+    gint i,count=0;
+    while(ctx->spec->rules[count].key!=NULL){
+	count++;
+    }
+    if (count==0)
+	return;
+    ctx->ruleTargets=g_new(MkdgPropertyHandle, count);
+    for(i=0;i<count;i++){
+	ctx->ruleTargets[i]=MKDG_PROPERTY_HANDLE_INVALID;
+    }
+}
+
+/*=== Start dirty bits ===*/
+#define MD_DIRTY_WORD_BITS	(sizeof(gulong)*8)
+#define MD_DIRTY_FLAGS		(MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED | MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED)
+
+/* Bitmaps are grown when properties are added, so setters do not allocate */
+static void md_dirty_bits_reserve(GArray *bits, guint count){
+    guint wordCount=(count+MD_DIRTY_WORD_BITS-1)/MD_DIRTY_WORD_BITS;
+    if (wordCount>bits->len)
+	g_array_set_size(bits, wordCount);
+}
+
+static void md_dirty_bits_set(GArray *bits, guint i){
+    g_array_index(bits, gulong, i/MD_DIRTY_WORD_BITS) |= 1UL << (i % MD_DIRTY_WORD_BITS);
+}
+
+static gboolean md_dirty_bits_test(GArray *bits, guint i){
+    if (i/MD_DIRTY_WORD_BITS>=bits->len)
+	return FALSE;
+    return (g_array_index(bits, gulong, i/MD_DIRTY_WORD_BITS) & (1UL << (i % MD_DIRTY_WORD_BITS))) ? TRUE : FALSE;
+}
+
+void mkdg_mark_dirty(Mkdg *mDialog, MkdgPropertyHandle handle){
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+    if (!ctx)
+	return;
+    md_dirty_bits_set(mDialog->dirtyBits, handle);
+    md_dirty_bits_set(mDialog->dirtyPageBits, ctx->pageId);
+}
+
+/*
+ * Page bits are only cleared here, they are rebuilt from
+ * the properties which are still dirty.
+ */
+guint mkdg_get_dirty_handles(Mkdg *mDialog, MkdgPropertyContextFlags flags, MkdgPropertyHandle *handles){
+    GArray *bits=mDialog->dirtyBits;
+    guint w, foundCount=0;
+    if (mDialog->dirtyPageBits->len)
+	memset(mDialog->dirtyPageBits->data, 0, mDialog->dirtyPageBits->len*sizeof(gulong));
+    for(w=0;w<bits->len;w++){
+	gulong word=g_array_index(bits, gulong, w);
+	gint b=-1;
+	while((b=g_bit_nth_lsf(word, b))>=0){
+	    MkdgPropertyHandle handle=w*MD_DIRTY_WORD_BITS+b;
+	    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+	    if (!(ctx->flags & MD_DIRTY_FLAGS)){
+		g_array_index(bits, gulong, w) &= ~(1UL << b);
+		continue;
+	    }
+	    md_dirty_bits_set(mDialog->dirtyPageBits, ctx->pageId);
+	    if (ctx->flags & flags){
+		if (handles)
+		    handles[foundCount]=handle;
+		foundCount++;
+	    }
+	}
+    }
+    return foundCount;
+}
+
+gboolean mkdg_page_is_dirty(Mkdg *mDialog, const gchar *pageName){
+    GNode *pageNode=mkdg_find_page_node(mDialog, pageName);
+    if (!pageNode)
+	return FALSE;
+    gint pageId=g_node_child_position(mDialog->pageRoot, pageNode);
+    if (!md_dirty_bits_test(mDialog->dirtyPageBits, pageId))
+	return FALSE;
+    /* Page may be saved or applied since the bit was set */
+    mkdg_get_dirty_handles(mDialog, 0, NULL);
+    return md_dirty_bits_test(mDialog->dirtyPageBits, pageId);
+}
+
+guint mkdg_apply_dirty(Mkdg *mDialog){
+    /* Count first, so the cost scales with the unapplied properties */
+    guint count=mkdg_get_dirty_handles(mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED, NULL);
+    if (count==0)
+	return 0;
+    MkdgPropertyHandle *handles=g_new(MkdgPropertyHandle, count);
+    guint i, appliedCount=0;
+    mkdg_get_dirty_handles(mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED, handles);
+    for(i=0;i<count;i++){
+	if (mkdg_apply_value_by_handle(mDialog, handles[i]))
+	    appliedCount++;
+    }
+    g_free(handles);
+    MKDG_DEBUG_MSG(3, "[I3] apply_dirty() %u of %u applied", appliedCount, count);
+    return appliedCount;
+}
+/*=== End dirty bits ===*/
+
+gboolean mkdg_add_property(Mkdg *mDialog, MkdgPropertyContext *ctx){
     MKDG_DEBUG_MSG(2, "[I2] add_property( , %s)",ctx->spec->key);
+    if (mDialog->propertyIndex){
+	g_warning("mkdg_add_property(): %s is not added, as properties are frozen.", ctx->spec->key);
+	return FALSE;
+    }
+    MkdgPropertyContext *oldCtx=mkdg_property_table_lookup(mDialog->propertyTable, ctx->spec->key);
+    if (oldCtx){
+	ctx->id=oldCtx->id;
+	g_ptr_array_index(mDialog->propertyArray, ctx->id)=ctx;
+	/* Old key node would refer to the freed context */
+	GNode *oldKeyNode=g_node_find(mDialog->pageRoot, G_PRE_ORDER, G_TRAVERSE_LEAVES, oldCtx);
+	if (oldKeyNode)
+	    g_node_destroy(oldKeyNode);
+    }else{
+	ctx->id=mDialog->propertyArray->len;
+	g_ptr_array_add(mDialog->propertyArray, ctx);
+    }
+    /* Old context, if any, is freed here */
     mkdg_property_table_insert(mDialog->propertyTable, ctx);
+    mkdg_prepare_rule_targets(ctx);
     GNode *propGroupNode=mkdg_prepare_group_node(mDialog, ctx->spec->pageName, ctx->spec->groupName);
     GNode *propKeyNode=g_node_new((gpointer) ctx);
     g_node_append(propGroupNode,propKeyNode);
 //    mkdg_property_get_default(ctx->spec);
     ctx->mDialog=mDialog;
+    ctx->pageId=g_node_child_position(mDialog->pageRoot, propGroupNode->parent);
+    md_dirty_bits_reserve(mDialog->dirtyBits, mDialog->propertyArray->len);
+    md_dirty_bits_reserve(mDialog->dirtyPageBits, g_node_n_children(mDialog->pageRoot));
+    if (ctx->flags & MD_DIRTY_FLAGS)
+	mkdg_mark_dirty(mDialog, ctx->id);
+    return TRUE;
+}
+
+gboolean mkdg_freeze(Mkdg *mDialog){
+    if (mDialog->propertyIndex)
+	return TRUE;
+    mDialog->propertyIndex=mkdg_property_index_new(
+	    (MkdgPropertyContext **) mDialog->propertyArray->pdata, mDialog->propertyArray->len);
+    return (mDialog->propertyIndex) ? TRUE : FALSE;
+}
+
+gboolean mkdg_is_frozen(Mkdg *mDialog){
+    return (mDialog->propertyIndex) ? TRUE : FALSE;
 }
 
 void mkdg_destroy(Mkdg *mDialog){
@@ -104,6 +250,11 @@ void mkdg_destroy(Mkdg *mDialog){
     }
 
     g_node_destroy(mDialog->pageRoot);
+    if (mDialog->propertyIndex)
+	mkdg_property_index_free(mDialog->propertyIndex);
+    g_ptr_array_free(mDialog->propertyArray, TRUE);
+    g_array_free(mDialog->dirtyBits, TRUE);
+    g_array_free(mDialog->dirtyPageBits, TRUE);
     mkdg_property_table_destroy(mDialog->propertyTable);
     g_free(mDialog->title);
     if (mDialog->flags & MKDG_FLAG_FREE_ALL){
@@ -118,19 +269,49 @@ void mkdg_destroy(Mkdg *mDialog){
 }
 
 MkdgValue *mkdg_get_value(Mkdg *mDialog, const gchar *key){
-    MkdgPropertyContext *ctx=mkdg_get_property_context(mDialog, key);
-    if (ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE)
+    return mkdg_get_value_by_handle(mDialog, mkdg_property_handle(mDialog, key));
+}
+
+MkdgValue *mkdg_get_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle){
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+    if (!ctx || !(ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE))
 	return NULL;
     return ctx->value;
 }
 
 MkdgPropertyContext *mkdg_get_property_context(Mkdg *mDialog, const gchar *key){
+    if (mDialog->propertyIndex)
+	return mkdg_get_property_context_by_handle(mDialog,
+		mkdg_property_index_lookup(mDialog->propertyIndex, key));
     return mkdg_property_table_lookup(mDialog->propertyTable, key);
 }
 
+MkdgPropertyContext *mkdg_get_property_context_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle){
+    if (handle<0 || (guint) handle>=mDialog->propertyArray->len)
+	return NULL;
+    return (MkdgPropertyContext *) g_ptr_array_index(mDialog->propertyArray, handle);
+}
+
+MkdgPropertyHandle mkdg_property_handle(Mkdg *mDialog, const gchar *key){
+    if (mDialog->propertyIndex)
+	return mkdg_property_index_lookup(mDialog->propertyIndex, key);
+    MkdgPropertyContext *ctx=mkdg_get_property_context(mDialog, key);
+    return (ctx) ? ctx->id : MKDG_PROPERTY_HANDLE_INVALID;
+}
+
+guint mkdg_get_property_count(Mkdg *mDialog){
+    return mDialog->propertyArray->len;
+}
+
 gboolean mkdg_apply_value(Mkdg *mDialog, const gchar *key){
     MKDG_DEBUG_MSG(2,"[I2] apply_value( , %s)",key);
-    MkdgPropertyContext *ctx=mkdg_get_property_context(mDialog, key);
+    return mkdg_apply_value_by_handle(mDialog, mkdg_property_handle(mDialog, key));
+}
+
+gboolean mkdg_apply_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle){
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+    if (!ctx)
+	return FALSE;
 
     gboolean ret=TRUE;
     if (ctx->validateFunc && (!ctx->validateFunc(ctx->spec, ctx->value))){
@@ -149,12 +330,18 @@ gboolean mkdg_apply_value(Mkdg *mDialog, const gchar *key){
 
 gboolean mkdg_set_value(Mkdg *mDialog, const gchar *key, MkdgValue *value){
     MKDG_DEBUG_MSG(2,"[I2] set_value( , %s, )", key);
-    MkdgPropertyContext *ctx=mkdg_get_property_context(mDialog, key);
+    return mkdg_set_value_by_handle(mDialog, mkdg_property_handle(mDialog, key), value);
+}
+
+gboolean mkdg_set_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle, MkdgValue *value){
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+    if (!ctx)
+	return FALSE;
     if (!value){
 	return mkdg_property_set_default(ctx);
     }
     if (MKDG_DEBUG_RUN(3)){
-	gchar *str=mkdg_value_to_string(value, ctx->spec->toStringFormat);
+	gchar *str=mkdg_value_codec_to_string(mkdg_property_spec_get_codec(ctx->spec), value);
 	g_debug("[I3] set_value( , %s, ) value=%s",ctx->spec->key, str);
 	g_free(str);
     }
@@ -176,4 +363,88 @@ gboolean mkdg_set_value(Mkdg *mDialog, const gchar *key, MkdgValue *value){
     return ret;
 }
 
+/*=== Start set values ===*/
+typedef struct{
+    MkdgPropertyHandle handle;
+    guint index;
+} MdSetValuesEntry;
+
+/* Order by handle, then by the position in keys, so the last value of a key comes last */
+static gint md_set_values_entry_compare(const void *a, const void *b){
+    const MdSetValuesEntry *entry1=(const MdSetValuesEntry *) a;
+    const MdSetValuesEntry *entry2=(const MdSetValuesEntry *) b;
+    if (entry1->handle!=entry2->handle)
+	return (entry1->handle>entry2->handle) - (entry1->handle<entry2->handle);
+    return (entry1->index>entry2->index) - (entry1->index<entry2->index);
+}
+
+static void md_set_values_each_rule(MkdgPropertyContext *ctx, MkdgWidgetControl control, gpointer userData){
+    MkdgUi *dlgUi=(MkdgUi *) userData;
+    if (dlgUi && dlgUi->toolkitInterface->widget_control)
+	dlgUi->toolkitInterface->widget_control(dlgUi, ctx->spec->key, control);
+}
+
+/* Value to be set, NULL if it is not valid */
+static MkdgValue *md_set_values_resolve(MkdgPropertyContext *ctx, MkdgValue *value){
+    if (!value){
+	value=(MkdgValue *) mkdg_property_spec_get_default_value(ctx->spec);
+    }else if (ctx->validateFunc && (!ctx->validateFunc(ctx->spec, value))){
+	return NULL;
+    }
+    return (value->mType==ctx->spec->valueType) ? value : NULL;
+}
+
+guint mkdg_set_values(Mkdg *mDialog, const gchar **keys, MkdgValue **values, guint count, MkdgSetValuesFlags flags){
+    MdSetValuesEntry *entries=g_new(MdSetValuesEntry, MAX(count, 1));
+    MkdgValue **setValues=g_new(MkdgValue *, MAX(count, 1));
+    guint i, setCount=0, changedCount=0;
 
+    /* Pass 1: Resolve and validate */
+    for(i=0;i<count;i++){
+	entries[i].index=i;
+	entries[i].handle=mkdg_property_handle(mDialog, keys[i]);
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, entries[i].handle);
+	setValues[i]=(ctx) ? md_set_values_resolve(ctx, values[i]) : NULL;
+	if (!setValues[i]){
+	    MKDG_DEBUG_MSG(2, "[I2] set_values() %s is unknown or invalid", keys[i]);
+	    entries[i].handle=MKDG_PROPERTY_HANDLE_INVALID;
+	    continue;
+	}
+	setCount++;
+    }
+    if (setCount<count && (flags & MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING)){
+	g_free(setValues);
+	g_free(entries);
+	return 0;
+    }
+    qsort(entries, count, sizeof(MdSetValuesEntry), md_set_values_entry_compare);
+
+    /* Pass 2: Commit the last value of each key, changed entries are collected at front */
+    for(i=0;i<count;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, entries[i].handle);
+	if (!ctx || (i+1<count && entries[i+1].handle==entries[i].handle))
+	    continue;
+	MkdgValue *setValue=setValues[entries[i].index];
+	if ((ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE)
+		&& mkdg_value_codec_equal(mkdg_property_spec_get_codec(ctx->spec), ctx->value, setValue))
+	    continue;
+	mkdg_property_set_value_fast(ctx, setValue, -2);
+	entries[changedCount++].handle=entries[i].handle;
+    }
+
+    /* Pass 3: Update UI and evaluate control rules once for each changed property */
+    MkdgUi *dlgUi=mDialog->ui;
+    for(i=0;i<changedCount;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, entries[i].handle);
+	if (dlgUi && dlgUi->toolkitInterface->widget_set_value)
+	    dlgUi->toolkitInterface->widget_set_value(dlgUi, ctx->spec->key, ctx->value);
+	mkdg_property_foreach_control_rule(ctx, md_set_values_each_rule, dlgUi);
+	if (flags & MKDG_SET_VALUES_FLAG_APPLY)
+	    mkdg_apply_value_by_handle(mDialog, entries[i].handle);
+    }
+    MKDG_DEBUG_MSG(3, "[I3] set_values( , , , %u, ) %u set, %u changed", count, setCount, changedCount);
+    g_free(setValues);
+    g_free(entries);
+    return setCount;
+}
+/*=== End set values ===*/
@@ -40,6 +40,8 @@
 #include <glib-object.h>
 #include <glib/gstdio.h>
 #include "MakerDialogUtil.h"
+#include "MakerDialogNumber.h"
+#include "MakerDialogBlob.h"
 #include "MakerDialogTypes.h"
 
 typedef struct _Mkdg Mkdg;
@@ -53,6 +55,7 @@ typedef struct _Mkdg Mkdg;
 #include "MakerDialogConfigKeyFile.h"
 #include "MakerDialogModule.h"
 #include "MakerDialogSpecParser.h"
+#include "MakerDialogValueStore.h"
 
 /**
  * Inter-process communication module.
@@ -83,6 +86,8 @@ typedef enum{
 struct _Mkdg{
     gchar *title;				//!< Title of the dialog, which will be shown in title bar.
     MkdgPropertyTable *propertyTable;	//!< Hash table that stores property context.
+    GPtrArray *propertyArray;		//!< Property contexts indexed by id, see ::MkdgPropertyHandle.
+    MkdgPropertyIndex *propertyIndex;	//!< Key index built by mkdg_freeze(). \c NULL if not frozen.
     MkdgButtonSpec *buttonSpecs;		//!< Button specs.
     MkdgDimension maxSizeInPixel;	//!< The maximum size in pixel. Default is (-1, -1).
     MkdgDimension maxSizeInChar;		//!< The maximum size in characters. Default is (-1, -1).
@@ -96,6 +101,8 @@ struct _Mkdg{
     MkdgUi *ui;				//!< UI instance.
     MkdgConfig *config;			//!< Configure instance.
     MkdgIpc ipc;				//!< Inter-process communication instance.
+    GArray *dirtyBits;			//!< Bit i is set if property i may be unsaved or unapplied.
+    GArray *dirtyPageBits;		//!< Bit i is set if page i may have dirty properties.
     /// @endcond
     gpointer	userData;			//!< Custom user data.
 };
@@ -162,12 +169,49 @@ void mkdg_set_args(Mkdg *mDialog, gint argc, gchar **argv);
  * @endcode
  * Where @code propertySpec @endcode is the property spec.
  *
+ * The property context is assigned the next id, see ::MkdgPropertyHandle.
+ * If a property context of the same key exists, it is replaced
+ * and its id is reused.
+ *
+ * Properties cannot be added after mkdg_freeze().
+ *
  * @param mDialog A MakerDialog.
  * @param ctx The property context to be added.
+ * @return TRUE if succeed; FALSE if \a mDialog is frozen, then \a ctx is not taken.
  *
  * @see mkdg_property_table_insert().
  */
-void mkdg_add_property(Mkdg *mDialog, MkdgPropertyContext *ctx);
+gboolean mkdg_add_property(Mkdg *mDialog, MkdgPropertyContext *ctx);
+
+/**
+ * Freeze the properties of a MakerDialog.
+ *
+ * This function builds a perfect hash index over the property keys,
+ * which serves later lookups by key such as mkdg_get_property_context()
+ * and mkdg_property_handle(), see ::MkdgPropertyIndex.
+ * Call it once the spec is loaded, as lookups on a frozen MakerDialog
+ * are faster, especially when there are thousands of properties.
+ *
+ * After freezing, mkdg_add_property() is rejected.
+ * Freezing a frozen MakerDialog does nothing.
+ *
+ * @param mDialog A MakerDialog.
+ * @return TRUE if succeed; FALSE if the index cannot be built, then \a mDialog is not frozen.
+ * @see mkdg_is_frozen()
+ * @since 0.3
+ */
+gboolean mkdg_freeze(Mkdg *mDialog);
+
+/**
+ * Whether a MakerDialog is frozen.
+ *
+ * Whether a MakerDialog is frozen by mkdg_freeze().
+ *
+ * @param mDialog A MakerDialog.
+ * @return TRUE if frozen; FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_is_frozen(Mkdg *mDialog);
 
 /**
  * Destroy the MakerDialog.
@@ -189,9 +233,23 @@ void mkdg_destroy(Mkdg *mDialog);
  * @param mDialog A MakerDialog.
  * @param key A property key.
  * @return Value of the property; or NULL if no such property, or value have not been set.
+ * @see mkdg_get_value_by_handle()
  */
 MkdgValue *mkdg_get_value(Mkdg *mDialog, const gchar *key);
 
+/**
+ * Get the value of a property by handle.
+ *
+ * This function works as mkdg_get_value(), but takes a handle
+ * from mkdg_property_handle() instead of a key.
+ *
+ * @param mDialog A MakerDialog.
+ * @param handle A property handle.
+ * @return Value of the property; or NULL if no such property, or value have not been set.
+ * @since 0.3
+ */
+MkdgValue *mkdg_get_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle);
+
 /**
  * Get the property context.
  *
@@ -203,6 +261,47 @@ MkdgValue *mkdg_get_value(Mkdg *mDialog, const gchar *key);
  */
 MkdgPropertyContext *mkdg_get_property_context(Mkdg *mDialog, const gchar *key);
 
+/**
+ * Get the property context by handle.
+ *
+ * Get the property context by handle, which is an array access.
+ * The returned value is still useful for property context, so DO NOT free it.
+ *
+ * @param mDialog A MakerDialog.
+ * @param handle A property handle.
+ * @return Context of the property; or NULL if \a handle is invalid.
+ * @since 0.3
+ */
+MkdgPropertyContext *mkdg_get_property_context_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle);
+
+/**
+ * Get the handle of a property.
+ *
+ * Get the handle of a property, that is, the id of its property context.
+ * Callers that access a property repeatedly should resolve its key once
+ * with this function, then use the *_by_handle() functions.
+ *
+ * Handles stay valid until \a mDialog is destroyed.
+ *
+ * @param mDialog A MakerDialog.
+ * @param key A property key.
+ * @return Handle of the property; or ::MKDG_PROPERTY_HANDLE_INVALID if no such property.
+ * @since 0.3
+ */
+MkdgPropertyHandle mkdg_property_handle(Mkdg *mDialog, const gchar *key);
+
+/**
+ * Get the number of properties.
+ *
+ * Get the number of properties, so valid handles are from 0 to the
+ * returned value minus 1.
+ *
+ * @param mDialog A MakerDialog.
+ * @return Number of properties.
+ * @since 0.3
+ */
+guint mkdg_get_property_count(Mkdg *mDialog);
+
 /**
  * Apply a property value by calling the apply callback function.
  *
@@ -226,9 +325,23 @@ MkdgPropertyContext *mkdg_get_property_context(Mkdg *mDialog, const gchar *key);
  * @return TRUE if succeed, FALSE if the property value does not pass validation, or applyFunc() does not exist.
  * @see mkdg_set_value()
  * @see mkdg_ui_update_value()
+ * @see mkdg_apply_value_by_handle()
  */
 gboolean mkdg_apply_value(Mkdg *mDialog, const gchar *key);
 
+/**
+ * Apply a property value by handle.
+ *
+ * This function works as mkdg_apply_value(), but takes a handle
+ * from mkdg_property_handle() instead of a key.
+ *
+ * @param mDialog A MakerDialog.
+ * @param handle A property handle.
+ * @return TRUE if succeed, FALSE if the property value does not pass validation, or applyFunc() does not exist.
+ * @since 0.3
+ */
+gboolean mkdg_apply_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle);
+
 /**
  * Set the value to the property and corresponding UI component.
  *
@@ -249,10 +362,134 @@ gboolean mkdg_apply_value(Mkdg *mDialog, const gchar *key);
  * @see mkdg_ui_update_value()
  * @see mkdg_property_set_default()
  * @see mkdg_property_set_value_fast()
+ * @see mkdg_set_value_by_handle()
  *
  */
 gboolean mkdg_set_value(Mkdg *mDialog, const gchar *key, MkdgValue *value);
 
+/**
+ * Set the value to the property and corresponding UI component by handle.
+ *
+ * This function works as mkdg_set_value(), but takes a handle
+ * from mkdg_property_handle() instead of a key.
+ *
+ * @param mDialog A MakerDialog.
+ * @param handle A property handle.
+ * @param value Argument value to be set. \c NULL for using default.
+ * @return TRUE if succeed, FALSE if the property value does not pass validation.
+ * @since 0.3
+ */
+gboolean mkdg_set_value_by_handle(Mkdg *mDialog, MkdgPropertyHandle handle, MkdgValue *value);
+
+/**
+ * Flags for mkdg_set_values().
+ *
+ * Flags for mkdg_set_values().
+ * @since 0.3
+ */
+typedef enum{
+    MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING	=0x1, //!< Set nothing if any key is unknown or any value is invalid.
+    MKDG_SET_VALUES_FLAG_APPLY		=0x2, //!< Apply the changed values, see mkdg_apply_value_by_handle().
+} MkdgSetValuesFlag;
+
+/**
+ * Data structure that holds flags for mkdg_set_values().
+ * @since 0.3
+ */
+typedef guint MkdgSetValuesFlags;
+
+/**
+ * Set the values of many properties at once.
+ *
+ * This function works as calling mkdg_set_value() for each key,
+ * but in passes:
+ * -# resolves the keys and validates all values,
+ *    if validateFunc() exists.
+ *    If ::MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING is set and
+ *    any key is unknown or any value is invalid, then nothing is set.
+ * -# copies the values to the properties, skipping the values that are
+ *    equal to the current ones.
+ * -# updates the UI widgets of changed properties, if UI exists,
+ *    and evaluates their control rules once for each property.
+ * -# applies the changed properties if ::MKDG_SET_VALUES_FLAG_APPLY is set.
+ *
+ * If a key is listed more than once, the last value is kept.
+ *
+ * @param mDialog A MakerDialog.
+ * @param keys Property keys.
+ * @param values Values to be set. An element can be \c NULL for using default.
+ * @param count Number of keys and values.
+ * @param flags Flags that control the behavior.
+ * @return Number of keys which are known and whose values are valid, thus set;
+ * 0 if nothing is set because of ::MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING.
+ * @see mkdg_set_value()
+ * @since 0.3
+ */
+guint mkdg_set_values(Mkdg *mDialog, const gchar **keys, MkdgValue **values, guint count, MkdgSetValuesFlags flags);
+
+/**
+ * Mark a property as dirty.
+ *
+ * A property is dirty if its context has ::MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED
+ * or ::MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED.
+ * Dirty properties are recorded in a bitmap indexed by property id,
+ * with a summary bit for each page,
+ * so mkdg_get_dirty_handles(), mkdg_apply_dirty() and mkdg_config_save_dirty()
+ * do not visit the clean properties.
+ *
+ * Every value setter marks the property, so this function is only needed
+ * if the context flags are changed directly.
+ * @param mDialog A MakerDialog.
+ * @param handle A property handle.
+ * @see mkdg_get_dirty_handles()
+ * @since 0.3
+ */
+void mkdg_mark_dirty(Mkdg *mDialog, MkdgPropertyHandle handle);
+
+/**
+ * Get the handles of dirty properties.
+ *
+ * Get the handles of dirty properties whose contexts have any of \a flags.
+ * The bits of properties that are no longer unsaved nor unapplied are cleared
+ * on the way.
+ * @param mDialog A MakerDialog.
+ * @param flags Property context flags to be found,
+ * such as ::MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED.
+ * @param handles Returned handles in ascending order. It should hold
+ * as many handles as a previous call with the same \a flags and \c NULL returned,
+ * or mkdg_get_property_count() handles. Can be \c NULL for counting only.
+ * @return Number of found properties.
+ * @see mkdg_mark_dirty()
+ * @since 0.3
+ */
+guint mkdg_get_dirty_handles(Mkdg *mDialog, MkdgPropertyContextFlags flags, MkdgPropertyHandle *handles);
+
+/**
+ * Whether a page has dirty properties.
+ *
+ * Whether a page has unsaved or unapplied properties.
+ * Pages without any dirty property since the last scan
+ * are answered from the summary bit.
+ * @param mDialog A MakerDialog.
+ * @param pageName Name of the page. \c NULL for the unnamed page.
+ * @return \c TRUE if the page has dirty properties; \c FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_page_is_dirty(Mkdg *mDialog, const gchar *pageName);
+
+/**
+ * Apply the unapplied values.
+ *
+ * Apply the values of properties with ::MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED
+ * with mkdg_apply_value_by_handle().
+ * Only dirty properties are visited.
+ * @param mDialog A MakerDialog.
+ * @return Number of applied properties.
+ * @see mkdg_config_save_dirty()
+ * @since 0.3
+ */
+guint mkdg_apply_dirty(Mkdg *mDialog);
+
 
 #endif /* MKDG_H_ */
 
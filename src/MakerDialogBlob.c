@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <glib.h>
+#include "MakerDialogBlob.h"
+
+struct _MkdgBlob{
+    gint		refCount;
+    gint		hashValid;	/* Whether hash is computed */
+    guint32		hash;
+    gboolean		fileBacked;	/* Content is mapped from path */
+    gconstpointer	data;		/* Content if not fileBacked */
+    gsize		size;
+    gchar		*path;		/* File that content is mapped from, never changed until freed */
+    GMappedFile		*mappedFile;	/* Set once by the first load */
+    GDestroyNotify	destroyFunc;
+    gpointer		destroyData;
+};
+
+static MkdgBlob *md_blob_alloc(gsize extraSize){
+    MkdgBlob *blob=(MkdgBlob *) g_malloc0(sizeof(MkdgBlob)+extraSize);
+    blob->refCount=1;
+    return blob;
+}
+
+MkdgBlob *mkdg_blob_new(gconstpointer data, gsize size){
+    /* Content follows the header in the same block */
+    MkdgBlob *blob=md_blob_alloc(size);
+    if (size>0)
+	memcpy(blob+1, data, size);
+    blob->data=blob+1;
+    blob->size=size;
+    return blob;
+}
+
+MkdgBlob *mkdg_blob_new_static(gconstpointer data, gsize size, GDestroyNotify destroyFunc, gpointer destroyData){
+    MkdgBlob *blob=md_blob_alloc(0);
+    blob->data=data;
+    blob->size=size;
+    blob->destroyFunc=destroyFunc;
+    blob->destroyData=destroyData;
+    return blob;
+}
+
+MkdgBlob *mkdg_blob_new_from_file(const gchar *path){
+    MkdgBlob *blob=md_blob_alloc(0);
+    blob->fileBacked=TRUE;
+    blob->path=g_strdup(path);
+    return blob;
+}
+
+MkdgBlob *mkdg_blob_ref(MkdgBlob *blob){
+    if (blob)
+	g_atomic_int_inc(&blob->refCount);
+    return blob;
+}
+
+void mkdg_blob_free(MkdgBlob *blob){
+    if (!blob || !g_atomic_int_dec_and_test(&blob->refCount))
+	return;
+    if (blob->mappedFile)
+	g_mapped_file_free(blob->mappedFile);
+    if (blob->destroyFunc)
+	blob->destroyFunc(blob->destroyData);
+    g_free(blob->path);
+    g_free(blob);
+}
+
+/*
+ * Threads may map the file at the same time,
+ * only the first mapping is kept.
+ */
+gboolean mkdg_blob_load(MkdgBlob *blob, MkdgError **error){
+    if (!blob->fileBacked || g_atomic_pointer_get(&blob->mappedFile))
+	return TRUE;
+    GError *gErr=NULL;
+    GMappedFile *mappedFile=g_mapped_file_new(blob->path, FALSE, &gErr);
+    if (!mappedFile){
+	MkdgError *cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_CANT_READ,
+		"mkdg_blob_load(): %s: %s", blob->path, gErr->message);
+	g_error_free(gErr);
+	mkdg_error_handle(cfgErr, error);
+	return FALSE;
+    }
+    MKDG_DEBUG_MSG(4, "[I4] mkdg_blob_load(%s) mapped %" G_GSIZE_FORMAT " bytes",
+	    blob->path, g_mapped_file_get_length(mappedFile));
+    if (!g_atomic_pointer_compare_and_exchange((gpointer *) &blob->mappedFile, NULL, mappedFile)){
+	g_mapped_file_free(mappedFile);
+    }
+    return TRUE;
+}
+
+gboolean mkdg_blob_is_loaded(MkdgBlob *blob){
+    return (!blob->fileBacked || g_atomic_pointer_get(&blob->mappedFile)) ? TRUE : FALSE;
+}
+
+gconstpointer mkdg_blob_get_data(MkdgBlob *blob, gsize *size){
+    gconstpointer data=NULL;
+    gsize len=0;
+    if (!blob->fileBacked){
+	data=blob->data;
+	len=blob->size;
+    }else if (mkdg_blob_load(blob, NULL)){
+	GMappedFile *mappedFile=(GMappedFile *) g_atomic_pointer_get(&blob->mappedFile);
+	data=g_mapped_file_get_contents(mappedFile);
+	len=g_mapped_file_get_length(mappedFile);
+    }
+    if (size)
+	*size=len;
+    return (len>0) ? data : NULL;
+}
+
+const gchar *mkdg_blob_get_path(MkdgBlob *blob){
+    return blob->path;
+}
+
+gboolean mkdg_blob_save(MkdgBlob *blob, const gchar *path, MkdgError **error){
+    if (blob->path && strcmp(blob->path, path)==0){
+	MKDG_DEBUG_MSG(4, "[I4] mkdg_blob_save(-, %s) is the source file, no need to save.", path);
+	return TRUE;
+    }
+    if (!mkdg_blob_load(blob, error))
+	return FALSE;
+    gsize size;
+    gconstpointer data=mkdg_blob_get_data(blob, &size);
+    /* g_file_set_contents() renames a temporary file, so existing mappings are intact. */
+    GError *gErr=NULL;
+    if (!g_file_set_contents(path, (data) ? (const gchar *) data : "", size, &gErr)){
+	MkdgError *cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_CANT_WRITE,
+		"mkdg_blob_save(): %s: %s", path, gErr->message);
+	g_error_free(gErr);
+	mkdg_error_handle(cfgErr, error);
+	return FALSE;
+    }
+    MKDG_DEBUG_MSG(4, "[I4] mkdg_blob_save(-, %s) %" G_GSIZE_FORMAT " bytes written", path, size);
+    return TRUE;
+}
+
+gint mkdg_blob_compare(MkdgBlob *blob1, MkdgBlob *blob2){
+    if (blob1==blob2)
+	return 0;
+    const gchar *path1=(blob1) ? mkdg_blob_get_path(blob1) : NULL;
+    const gchar *path2=(blob2) ? mkdg_blob_get_path(blob2) : NULL;
+    if (path1 && path2 && strcmp(path1, path2)==0
+	    && !mkdg_blob_is_loaded(blob1) && !mkdg_blob_is_loaded(blob2)){
+	/* Both will map the same file; a mapped one may hold a replaced file */
+	return 0;
+    }
+    gsize size1=0, size2=0;
+    gconstpointer data1=(blob1) ? mkdg_blob_get_data(blob1, &size1) : NULL;
+    gconstpointer data2=(blob2) ? mkdg_blob_get_data(blob2, &size2) : NULL;
+    if (size1!=size2)
+	return (size1>size2) ? 1 : -1;
+    if (size1==0)
+	return 0;
+    gint ret=memcmp(data1, data2, size1);
+    if (ret)
+	return (ret>0) ? 1 : -1;
+    return 0;
+}
+
+/* Same as g_str_hash(), but over bytes that may contain '\0'. */
+guint mkdg_blob_hash(MkdgBlob *blob){
+    if (!blob)
+	return 0;
+    if (g_atomic_int_get(&blob->hashValid))
+	return blob->hash;
+    gsize size, i;
+    const guchar *data=(const guchar *) mkdg_blob_get_data(blob, &size);
+    guint32 hash=5381;
+    for(i=0;i<size;i++){
+	hash=(hash<<5)+hash+data[i];
+    }
+    /* Every thread computes the same hash, so the race is harmless. */
+    blob->hash=hash;
+    g_atomic_int_set(&blob->hashValid, TRUE);
+    return hash;
+}
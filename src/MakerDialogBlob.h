@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file MakerDialogBlob.h
+ * Binary payloads for Mkdg.
+ *
+ * This file lists the functions of MkdgBlob, the payload of #MKDG_TYPE_BLOB.
+ * A blob is either in memory, or a memory-mapped file such as a user dictionary,
+ * which is mapped only when its content is needed.
+ * @since 0.3
+ */
+#ifndef MKDG_BLOB_H_
+#define MKDG_BLOB_H_
+#include <glib.h>
+#include "MakerDialogUtil.h"
+
+/**
+ * Binary payload.
+ *
+ * A blob is reference-counted and immutable, so values share it on copy.
+ * Its content is one of:
+ *  - Copied into the blob, see mkdg_blob_new().
+ *  - Referenced without copying, such as an existing mapping, see mkdg_blob_new_static().
+ *  - A file that is memory-mapped on first access, see mkdg_blob_new_from_file().
+ *
+ * A file-backed blob keeps the path of its file, which never changes.
+ * The path is what a blob value outputs as string, so configuration back-ends
+ * store a reference to the file instead of the content.
+ * @since 0.3
+ */
+typedef struct _MkdgBlob MkdgBlob;
+
+/**
+ * New a blob by copying data.
+ *
+ * New a blob by copying \a size bytes of \a data.
+ * @param data		Data to be copied. Can be \c NULL if \a size is 0.
+ * @param size		Size of \a data in bytes.
+ * @return A newly allocated blob.
+ * @see mkdg_blob_free().
+ * @since 0.3
+ */
+MkdgBlob *mkdg_blob_new(gconstpointer data, gsize size);
+
+/**
+ * New a blob that references data without copying.
+ *
+ * New a blob that references \a data without copying,
+ * such as a region that the caller has already mapped.
+ * \a data must stay valid until \a destroyFunc is called.
+ * @param data		Data to be referenced.
+ * @param size		Size of \a data in bytes.
+ * @param destroyFunc	Function to be called with \a destroyData when the blob is freed. Can be \c NULL.
+ * @param destroyData	Argument of \a destroyFunc.
+ * @return A newly allocated blob.
+ * @see mkdg_blob_free().
+ * @since 0.3
+ */
+MkdgBlob *mkdg_blob_new_static(gconstpointer data, gsize size, GDestroyNotify destroyFunc, gpointer destroyData);
+
+/**
+ * New a blob backed by a file.
+ *
+ * New a blob whose content is the file \a path.
+ * The file is not accessed until the content is needed,
+ * then it is memory-mapped read-only, see mkdg_blob_load().
+ *
+ * The file is assumed not to be modified in place while mapped,
+ * and blobs of the same path are deemed as equal if neither is mapped.
+ * mkdg_blob_save() replaces files instead of modifying them.
+ * @param path		Path to the file.
+ * @return A newly allocated blob.
+ * @see mkdg_blob_free().
+ * @since 0.3
+ */
+MkdgBlob *mkdg_blob_new_from_file(const gchar *path);
+
+/**
+ * Add a reference to a blob.
+ *
+ * Add a reference to a blob.
+ * This function is thread-safe.
+ * @param blob		A blob. Can be \c NULL.
+ * @return \a blob.
+ * @see mkdg_blob_free().
+ * @since 0.3
+ */
+MkdgBlob *mkdg_blob_ref(MkdgBlob *blob);
+
+/**
+ * Release a reference to a blob.
+ *
+ * Release a reference to a blob.
+ * The blob is freed, and its file is unmapped, when the last reference is released.
+ * This function is thread-safe.
+ * @param blob		A blob to be freed. Can be \c NULL.
+ * @since 0.3
+ */
+void mkdg_blob_free(MkdgBlob *blob);
+
+/**
+ * Load the content of a blob.
+ *
+ * Map the file of a blob created by mkdg_blob_new_from_file(),
+ * if it is not mapped yet.
+ * Other blobs are always loaded.
+ * This function is thread-safe.
+ * @param blob		A blob.
+ * @param error		Returned error. Can be \c NULL.
+ * @return \c TRUE if the content is loaded; \c FALSE if the file cannot be mapped.
+ * @since 0.3
+ */
+gboolean mkdg_blob_load(MkdgBlob *blob, MkdgError **error);
+
+/**
+ * Whether the content of a blob is loaded.
+ *
+ * Whether the content of a blob is loaded, that is, whether
+ * mkdg_blob_get_data() can return without accessing the file.
+ * @param blob		A blob.
+ * @return \c TRUE if the content is loaded; \c FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_blob_is_loaded(MkdgBlob *blob);
+
+/**
+ * Get the content of a blob.
+ *
+ * Get the content of a blob, which is loaded if it is not yet.
+ * The content belongs to \a blob and must not be modified.
+ * @param blob		A blob.
+ * @param size		Returned size of content in bytes. Can be \c NULL.
+ * @return The content; or \c NULL if it is empty or cannot be loaded.
+ * @since 0.3
+ */
+gconstpointer mkdg_blob_get_data(MkdgBlob *blob, gsize *size);
+
+/**
+ * Get the path of a blob.
+ *
+ * Get the path of the file that a blob is backed by,
+ * which is given by mkdg_blob_new_from_file().
+ * Saving a blob does not change its path.
+ * @param blob		A blob.
+ * @return The path; or \c NULL if the content is only in memory.
+ * @since 0.3
+ */
+const gchar *mkdg_blob_get_path(MkdgBlob *blob);
+
+/**
+ * Save a blob to a file.
+ *
+ * Write the content of a blob to \a path,
+ * unless \a blob is backed by the file \a path,
+ * that is, \a path is what mkdg_blob_get_path() returns.
+ *
+ * The file is replaced rather than modified in place,
+ * so other blobs that map the old file are not affected.
+ * The path of \a blob is not changed.
+ * @param blob		A blob.
+ * @param path		Path to the file.
+ * @param error		Returned error. Can be \c NULL.
+ * @return \c TRUE if succeed; \c FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_blob_save(MkdgBlob *blob, const gchar *path, MkdgError **error);
+
+/**
+ * Compare the content of 2 blobs.
+ *
+ * Compare the content of 2 blobs.
+ * Blobs backed by the same file are equal without loading, if neither is loaded.
+ * Otherwise, the smaller one is less, and blobs of the same size are compared with memcmp().
+ * @param blob1		A blob. Can be \c NULL, which is empty.
+ * @param blob2		Another blob. Can be \c NULL, which is empty.
+ * @return -1, 0, 1 if \a blob1 is less than, equal to, or greater than \a blob2.
+ * @since 0.3
+ */
+gint mkdg_blob_compare(MkdgBlob *blob1, MkdgBlob *blob2);
+
+/**
+ * Hash the content of a blob.
+ *
+ * Hash the content of a blob, which is loaded if it is not yet.
+ * The hash is computed once and cached.
+ * @param blob		A blob. Can be \c NULL, which is empty.
+ * @return The hash.
+ * @since 0.3
+ */
+guint mkdg_blob_hash(MkdgBlob *blob);
+
+#endif /* MKDG_BLOB_H_ */
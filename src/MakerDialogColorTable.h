@@ -0,0 +1,213 @@
+/*
+ * Generated by gen-color-table.py, do not edit.
+ * 149 names, 139 values, at most 8 probes for a value.
+ */
+#ifndef MKDG_COLOR_TABLE_H_
+#define MKDG_COLOR_TABLE_H_
+
+#define MKDG_COLOR_NAME_SLOTS	256
+#define MKDG_COLOR_NAME_BUCKETS	64
+#define MKDG_COLOR_VALUE_SLOTS	256
+#define MKDG_COLOR_COUNT	149
+
+static const MkdgColorInfo mkdgColorList[]={
+    {"AliceBlue",            0xF0F8FF},
+    {"AntiqueWhite",         0xFAEBD7},
+    {"Aqua",                 0x00FFFF},
+    {"Aquamarine",           0x7FFFD4},
+    {"Azure",                0xF0FFFF},
+    {"Beige",                0xF5F5DC},
+    {"Bisque",               0xFFE4C4},
+    {"Black",                0x000000},
+    {"BlanchedAlmond",       0xFFEBCD},
+    {"Blue",                 0x0000FF},
+    {"BlueViolet",           0x8A2BE2},
+    {"Brown",                0xA52A2A},
+    {"BurlyWood",            0xDEB887},
+    {"CadetBlue",            0x5F9EA0},
+    {"Chartreuse",           0x7FFF00},
+    {"Chocolate",            0xD2691E},
+    {"Coral",                0xFF7F50},
+    {"CornflowerBlue",       0x6495ED},
+    {"Cornsilk",             0xFFF8DC},
+    {"Crimson",              0xDC143C},
+    {"Cyan",                 0x00FFFF},
+    {"DarkBlue",             0x00008B},
+    {"DarkCyan",             0x008B8B},
+    {"DarkGoldenrod",        0xB8860B},
+    {"DarkGray",             0xA9A9A9},
+    {"DarkGreen",            0x006400},
+    {"DarkGrey",             0xA9A9A9},
+    {"DarkKhaki",            0xBDB76B},
+    {"DarkMagenta",          0x8B008B},
+    {"DarkOliveGreen",       0x556B2F},
+    {"DarkOrange",           0xFF8C00},
+    {"DarkOrchid",           0x9932CC},
+    {"DarkRed",              0x8B0000},
+    {"DarkSalmon",           0xE9967A},
+    {"DarkSeaGreen",         0x8FBC8F},
+    {"DarkSlateBlue",        0x483D8B},
+    {"DarkSlateGray",        0x2F4F4F},
+    {"DarkSlateGrey",        0x2F4F4F},
+    {"DarkTurquoise",        0x00CED1},
+    {"DarkViolet",           0x9400D3},
+    {"DeepPink",             0xFF1493},
+    {"DeepSkyBlue",          0x00BFFF},
+    {"DimGray",              0x696969},
+    {"DimGrey",              0x696969},
+    {"DodgerBlue",           0x1E90FF},
+    {"FireBrick",            0xB22222},
+    {"FloralWhite",          0xFFFAF0},
+    {"ForestGreen",          0x228B22},
+    {"Fuchsia",              0xFF00FF},
+    {"Gainsboro",            0xDCDCDC},
+    {"GhostWhite",           0xF8F8FF},
+    {"Gold",                 0xFFD700},
+    {"Goldenrod",            0xDAA520},
+    {"Gray",                 0x808080},
+    {"Green",                0x008000},
+    {"GreenYellow",          0xADFF2F},
+    {"Grey",                 0x808080},
+    {"Honeydew",             0xF0FFF0},
+    {"HotPink",              0xFF69B4},
+    {"IndianRed",            0xCD5C5C},
+    {"Indigo",               0x4B0082},
+    {"Ivory",                0xFFFFF0},
+    {"Khaki",                0xF0E68C},
+    {"Lavender",             0xE6E6FA},
+    {"LavenderBlush",        0xFFF0F5},
+    {"LawnGreen",            0x7CFC00},
+    {"LemonChiffon",         0xFFFACD},
+    {"LightBlue",            0xADD8E6},
+    {"LightCoral",           0xF08080},
+    {"LightCyan",            0xE0FFFF},
+    {"LightGoldenrodYellow", 0xFAFAD2},
+    {"LightGray",            0xD3D3D3},
+    {"LightGreen",           0x90EE90},
+    {"LightGrey",            0xD3D3D3},
+    {"LightPink",            0xFFB6C1},
+    {"LightSalmon",          0xFFA07A},
+    {"LightSeaGreen",        0x20B2AA},
+    {"LightSkyBlue",         0x87CEFA},
+    {"LightSlateGray",       0x778899},
+    {"LightSlateGrey",       0x778899},
+    {"LightSteelBlue",       0xB0C4DE},
+    {"LightYellow",          0xFFFFE0},
+    {"Lime",                 0x00FF00},
+    {"LimeGreen",            0x32CD32},
+    {"Linen",                0xFAF0E6},
+    {"Magenta",              0xFF00FF},
+    {"Maroon",               0x800000},
+    {"MediumAquamarine",     0x66CDAA},
+    {"MediumBlue",           0x0000CD},
+    {"MediumOrchid",         0xBA55D3},
+    {"MediumPurple",         0x9370DB},
+    {"MediumSeaGreen",       0x3CB371},
+    {"MediumSlateBlue",      0x7B68EE},
+    {"MediumSpringGreen",    0x00FA9A},
+    {"MediumTurquoise",      0x48D1CC},
+    {"MediumVioletRed",      0xC71585},
+    {"MidnightBlue",         0x191970},
+    {"MintCream",            0xF5FFFA},
+    {"MistyRose",            0xFFE4E1},
+    {"Moccasin",             0xFFE4B5},
+    {"NavajoWhite",          0xFFDEAD},
+    {"Navy",                 0x000080},
+    {"OldLace",              0xFDF5E6},
+    {"Olive",                0x808000},
+    {"OliveDrab",            0x6B8E23},
+    {"Orange",               0xFFA500},
+    {"OrangeRed",            0xFF4500},
+    {"Orchid",               0xDA70D6},
+    {"PaleGoldenrod",        0xEEE8AA},
+    {"PaleGreen",            0x98FB98},
+    {"PaleTurquoise",        0xAFEEEE},
+    {"PaleVioletRed",        0xDB7093},
+    {"PapayaWhip",           0xFFEFD5},
+    {"PeachPuff",            0xFFDAB9},
+    {"Peru",                 0xCD853F},
+    {"Pink",                 0xFFC0CB},
+    {"Plum",                 0xDDA0DD},
+    {"PowderBlue",           0xB0E0E6},
+    {"Purple",               0x800080},
+    {"RebeccaPurple",        0x663399},
+    {"Red",                  0xFF0000},
+    {"RosyBrown",            0xBC8F8F},
+    {"RoyalBlue",            0x4169E1},
+    {"SaddleBrown",          0x8B4513},
+    {"Salmon",               0xFA8072},
+    {"SandyBrown",           0xF4A460},
+    {"SeaGreen",             0x2E8B57},
+    {"SeaShell",             0xFFF5EE},
+    {"Sienna",               0xA0522D},
+    {"Silver",               0xC0C0C0},
+    {"SkyBlue",              0x87CEEB},
+    {"SlateBlue",            0x6A5ACD},
+    {"SlateGray",            0x708090},
+    {"SlateGrey",            0x708090},
+    {"Snow",                 0xFFFAFA},
+    {"SpringGreen",          0x00FF7F},
+    {"SteelBlue",            0x4682B4},
+    {"Tan",                  0xD2B48C},
+    {"Teal",                 0x008080},
+    {"Thistle",              0xD8BFD8},
+    {"Tomato",               0xFF6347},
+    {"Turquoise",            0x40E0D0},
+    {"Violet",               0xEE82EE},
+    {"Wheat",                0xF5DEB3},
+    {"White",                0xFFFFFF},
+    {"WhiteSmoke",           0xF5F5F5},
+    {"Yellow",               0xFFFF00},
+    {"YellowGreen",          0x9ACD32},
+    {"Sliver",               0xC0C0C0},
+    {NULL,			0}
+};
+
+static const guint16 mkdgColorNameDisp[]={
+      0,   7,   2,   0,   5,   0,  11,   0,   5,   3,   0,   0,   2,   1,   2,   1,
+      1,   0,   1,   0,   2,   0,   0,   4,   1,   0,   0,   1,   0,   0,   0,   1,
+      0,   2,   1,   0,   0,   0,   6,   1,   1,   5,   2,   3,   0,   2,   0,   6,
+      0,   0,   0,   0,   3,   0,   4,   0,   2,   0,   0,   0,   0,   4,   7,   1,
+};
+
+/* Index to mkdgColorList, -1 for empty slot */
+static const gint16 mkdgColorNameSlots[]={
+     29, 138,  -1,   0,  -1,  -1,  15,  -1,  85,  -1, 109,  -1, 124,  21, 113,  -1,
+     65,  96, 135,  98,  -1,  67,  84,  -1,  -1,  41, 123,  -1, 120,  -1, 127,  -1,
+      9,  99,  -1,  -1,  -1,  -1,  -1,  78,  -1,  -1,  18,  97,  -1,  -1,  62,  -1,
+     -1, 101, 142,  79,  91,  -1, 116, 126, 140,  -1, 136,  -1,  -1,  -1,  -1,  70,
+     -1,  -1,  -1,  17,  80, 144,  -1,  -1,  -1,  52, 125,  89, 145, 121,  19,  43,
+     -1, 111,  -1,  42, 139,  27,  61,   7,  -1,  37,  48,  49, 117,  50,  -1,  -1,
+     26,  -1,  -1,  57,  24,  -1, 128,  92,  45, 107,  -1,  -1, 103,   6,  -1,  -1,
+     22,  54,  86,  -1,  -1,  -1, 131,  40,  13,  -1,  38, 112,  25,  14,  -1,  95,
+      1,  -1,  47,  63,  -1,  32,  82,  94, 147,  -1,  73,  23,  64,  83,  71, 119,
+     -1,  -1,  -1,  34,  -1,  36,  -1,  35, 146, 108,  53, 141,  -1,  -1, 100,  -1,
+    129,  -1,  -1,  -1,  -1, 106,  56,  -1,  -1,  20, 118,  30, 122,  31, 130,  -1,
+     68,   8,   2, 133,  12,  33,  -1,  -1, 110,  -1,  75,  -1,  -1,  93,  -1,  -1,
+     -1,  -1,  -1,  -1,  16,  44,  -1,  -1,  28,  -1,  -1,  60, 104,  -1,  -1,  11,
+     77,  -1,  -1,  51,  59,  58, 114,  -1, 137,  -1,  87,  76,  81,  88,  66,  -1,
+     90,   4,  69, 134, 148,  -1,  46, 143,  -1,  -1,  10, 105,  74, 102,  -1,  -1,
+      3,  -1,  39,   5,  -1,  -1,  -1,  72,  -1,  -1, 115,  -1,  55,  -1,  -1, 132,
+};
+
+/* Index to mkdgColorList, -1 for empty slot */
+static const gint16 mkdgColorValueSlots[]={
+      7,  60,  84,  -1,  -1,  72,  -1,  22, 124,  -1,  -1,  -1,  -1, 130,  -1,  -1,
+     44,  -1, 144,  32,  -1,  -1,  66,  83,  34,  92, 119, 101,  -1,  -1,  15,  -1,
+     -1,  -1,  -1,  -1,  -1,  -1,  91,  -1, 107,  52,  -1, 106,  -1,  -1,  16,  -1,
+     -1,  67, 143,  -1, 114,  -1,  -1,  58,  49, 111,  50,  97, 120,  89,  59, 100,
+     -1,  -1,  82,  -1, 104,  -1,  -1,  -1,  13,  36,  75,  47,  17,  23, 115, 116,
+     -1,  -1,  77,  -1,  -1,  -1,  69,  80,  95,  35,  93, 117, 137,  -1,  -1,  -1,
+     -1,  -1,  -1,  -1,  -1, 142,  40,  24, 127,  -1,  -1,  -1,  -1,   0,  71,  -1,
+     -1,  -1,  -1,  62,  -1,  -1,  -1,  -1,  -1, 108, 146,  -1,  99,  -1,  11,  90,
+     -1, 102,  -1, 141,  -1,   5,  96, 147,  -1, 129,  -1,  55, 140,  30,  65,  42,
+    139,  -1,  -1,  -1,  -1, 103, 109,  10,  94,   9,  78, 131,  -1,  -1,  -1,  -1,
+     27,  14,  -1,  29,   1,  31,   3,  64, 112,  33, 128,  25,  57,  -1,  63,  98,
+     -1,  53,  88, 136,  -1, 122,  -1,  -1,  46,  -1,  -1, 121,  54,  -1,  -1, 135,
+     -1, 126,   6,  39,  -1, 123,  -1,  -1,  -1,  -1,  -1, 113,  -1,  61,  51,  38,
+     48,  70,  -1,  -1,  -1,  -1,   8,  12,  86,  76, 110,   2, 125, 138,  -1,  -1,
+     -1,  -1,  -1,  -1,  -1,  -1, 134,  -1,  21,  -1,  81,  -1,  18,  -1,  68,  74,
+     -1,   4,  -1,  -1, 118,  -1,  -1,  -1, 105,  87, 132,  28, 145,  41,  19,  45,
+};
+
+#endif /* MKDG_COLOR_TABLE_H_ */
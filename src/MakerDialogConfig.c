@@ -39,6 +39,7 @@ MkdgConfig *mkdg_config_new_full(
 	MkdgConfigFlags flags, MkdgConfigFileInterface *configInterface){
     MkdgConfig *config=g_new(MkdgConfig,1);
     config->mDialog=mDialog;
+    config->flags=flags;
     config->pageSetTable=g_hash_table_new_full(g_str_hash, g_str_equal, NULL, NULL);
     config->setArray=g_ptr_array_sized_new(5);
     config->configInterface=configInterface;
@@ -77,6 +78,18 @@ void mkdg_config_add_config_set(MkdgConfig *config, MkdgConfigSet *configSet, Mk
     configSet->config=config;
 }
 
+/*
+ * Config set that stores pageName.
+ * Returns NULL if pages are assigned to sets, but not this page.
+ */
+static MkdgConfigSet *mkdg_config_find_set(MkdgConfig *config, const gchar *pageName){
+    if (g_hash_table_size(config->pageSetTable)){
+	return (MkdgConfigSet *) g_hash_table_lookup(config->pageSetTable,
+		(pageName) ? pageName : MKDG_PAGE_UNNAMED);
+    }
+    return (MkdgConfigSet *) g_ptr_array_index(config->setArray,0);
+}
+
 /*=== Start config file/set foreach callback and functions ===*/
 typedef gboolean (* MkdgConfigSetEachFileFunc)(
 	MkdgConfigFile *configFile, MkdgConfigBuffer *configBuf,
@@ -96,6 +109,7 @@ static gboolean mkdg_config_set_foreach_file(MkdgConfigSet *configSet,  MkdgConf
 	    mkdg_error_handle(cfgErr, error);
 	    if (configSet->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR)
 		return FALSE;
+	    cfgErr=NULL;
 	}
     }
     return TRUE;
@@ -193,10 +207,25 @@ static void mkdg_config_load_buffer(gpointer hashKey, gpointer value, gpointer u
     MKDG_DEBUG_MSG(5,"[I5] config_load_buffer (%s, , )", key);
     MkdgValue *mValue=(MkdgValue *) value;
     MkdgConfigSet *configSet=(MkdgConfigSet *) userData;
-    MkdgPropertyContext *ctx=mkdg_get_property_context(configSet->config->mDialog, key);
-    mkdg_set_value(configSet->config->mDialog, key, mValue);
+    /* Resolve the key once for both set and apply */
+    MkdgPropertyHandle handle=mkdg_property_handle(configSet->config->mDialog, key);
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(configSet->config->mDialog, handle);
+    if (!ctx)
+	return;
+    if ((ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE) && !(ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED)
+	    && mkdg_value_codec_equal(mkdg_property_spec_get_codec(ctx->spec), ctx->value, mValue)){
+	MKDG_DEBUG_MSG(5,"[I5] config_load_buffer (%s, , ) unchanged, no need to apply.", key);
+	return;
+    }
+    if (!mkdg_set_value_by_handle(configSet->config->mDialog, handle, mValue)){
+	/* Rejected value is not loaded, so the property keeps its flags */
+	MKDG_DEBUG_MSG(5,"[I5] config_load_buffer (%s, , ) rejected.", key);
+	return;
+    }
+    /* Value is from configuration */
+    ctx->flags &= ~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
     if (!(configSet->flags & MKDG_CONFIG_FLAG_NO_APPLY)){
-	mkdg_apply_value(configSet->config->mDialog,ctx->spec->key);
+	mkdg_apply_value_by_handle(configSet->config->mDialog, handle);
     }
 }
 
@@ -232,12 +261,7 @@ gboolean mkdg_config_load_page(MkdgConfig *config, const gchar *pageName, MkdgEr
 	mkdg_error_handle(cfgErr, error);
 	return FALSE;
     }
-    MkdgConfigSet *configSet=NULL;
-    if (g_hash_table_size(config->pageSetTable)){
-	configSet=(MkdgConfigSet *) g_hash_table_lookup(config->pageSetTable, pageName);
-    }else{
-	configSet=(MkdgConfigSet *) g_ptr_array_index(config->setArray,0);
-    }
+    MkdgConfigSet *configSet=mkdg_config_find_set(config, pageName);
     return mkdg_config_set_load(configSet, -1, (gpointer) pageName, error);
 }
 
@@ -292,13 +316,84 @@ gboolean mkdg_config_save_page(MkdgConfig *config, const gchar *pageName, MkdgEr
 	mkdg_error_handle(cfgErr, error);
 	return FALSE;
     }
-    MkdgConfigSet *configSet=NULL;
-    if (g_hash_table_size(config->pageSetTable)){
-	configSet=(MkdgConfigSet *) g_hash_table_lookup(config->pageSetTable, pageName);
+    MkdgConfigSet *configSet=mkdg_config_find_set(config, pageName);
+    return mkdg_config_set_save(configSet, -1, (gpointer) pageName, error);
+}
+
+typedef struct{
+    MkdgPropertyContext **ctxs;		/* Unsaved contexts */
+    guint count;
+    MkdgPropertyContext **setCtxs;	/* Unsaved contexts of current set */
+    gboolean clean;			/* Whether all sets are saved without error */
+} MkdgConfigDirtyData;
+
+static gboolean mkdg_config_set_save_dirty(MkdgConfigSet *configSet, gint untilIndex, gpointer userData, MkdgError **error){
+    MkdgConfigDirtyData *dirtyData=(MkdgConfigDirtyData *) userData;
+    guint i, setCount=0;
+    for(i=0;i<dirtyData->count;i++){
+	if (mkdg_config_find_set(configSet->config, dirtyData->ctxs[i]->spec->pageName)==configSet)
+	    dirtyData->setCtxs[setCount++]=dirtyData->ctxs[i];
+    }
+    MKDG_DEBUG_MSG(4,"[I4] config_set_save_dirty(%s, %d, , ) writeIndex=%d count=%u",(configSet->pageNames)? configSet->pageNames[0]  : "NULL",untilIndex, configSet->writeIndex, setCount);
+    if (setCount==0){
+	/* Nothing to save in this set */
+	return TRUE;
+    }
+    MkdgError *cfgErr=NULL;
+    gboolean ret;
+    if (!configSet->configInterface->config_file_save_properties){
+	/* Back-end can only write the whole file */
+	ret=mkdg_config_set_save(configSet, untilIndex, NULL, &cfgErr);
+    }else if (configSet->writeIndex<0 ){
+	cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_NO_CONFIG_SET, "config_set_save_dirty()");
+	ret=FALSE;
     }else{
-	configSet=(MkdgConfigSet *) g_ptr_array_index(config->setArray,0);
+	/* Nothing is preloaded, the unsaved values are written anyway */
+	MkdgConfigBuffer *configBuf=mkdg_config_buffer_new();
+	MkdgConfigFile *configFile=g_ptr_array_index(configSet->fileArray, configSet->writeIndex);
+	ret=configSet->configInterface->config_file_save_properties(configFile, configBuf,
+		dirtyData->setCtxs, setCount, &cfgErr);
+	mkdg_config_buffer_free(configBuf);
     }
-    return mkdg_config_set_save(configSet, -1, (gpointer) pageName, error);
+    if (!ret || cfgErr){
+	/* Flags are left alone, so the properties are saved next time */
+	dirtyData->clean=FALSE;
+	mkdg_error_handle(cfgErr, error);
+	return FALSE;
+    }
+    for(i=0;i<setCount;i++){
+	dirtyData->setCtxs[i]->flags &= ~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
+    }
+    return TRUE;
+}
+
+gboolean mkdg_config_save_dirty(MkdgConfig *config, MkdgError **error){
+    MkdgError *cfgErr=NULL;
+    if (config->setArray->len<=0){
+	cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_NO_CONFIG_SET, "config_save_dirty()");
+	mkdg_error_handle(cfgErr, error);
+	return FALSE;
+    }
+    MkdgConfigDirtyData dirtyData;
+    /* Count first, so the cost scales with the unsaved properties */
+    dirtyData.count=mkdg_get_dirty_handles(config->mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED, NULL);
+    MKDG_DEBUG_MSG(3,"[I3] config_save_dirty() %u unsaved", dirtyData.count);
+    if (dirtyData.count==0){
+	return TRUE;
+    }
+    MkdgPropertyHandle *handles=g_new(MkdgPropertyHandle, dirtyData.count);
+    mkdg_get_dirty_handles(config->mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED, handles);
+    dirtyData.ctxs=g_new(MkdgPropertyContext *, dirtyData.count*2);
+    dirtyData.setCtxs=dirtyData.ctxs+dirtyData.count;
+    dirtyData.clean=TRUE;
+    guint i;
+    for(i=0;i<dirtyData.count;i++){
+	dirtyData.ctxs[i]=mkdg_get_property_context_by_handle(config->mDialog, handles[i]);
+    }
+    g_free(handles);
+    gboolean ret=mkdg_foreach_config_set(config, mkdg_config_set_save_dirty, -1, &dirtyData, error);
+    g_free(dirtyData.ctxs);
+    return ret && dirtyData.clean;
 }
 
 static gboolean merge_str_lists(GPtrArray *ptrArray, gchar **strList){
@@ -372,12 +467,7 @@ gchar **mkdg_config_get_keys(MkdgConfig *config, const gchar *pageName, MkdgErro
 
 MkdgValue *mkdg_config_get_value(MkdgConfig *config, const gchar *pageName, const gchar *key,
 	MkdgType valueType, const gchar *parseOption, MkdgError **error){
-    MkdgConfigSet *configSet=NULL;
-    if (g_hash_table_size(config->pageSetTable)){
-	configSet=(MkdgConfigSet *) g_hash_table_lookup(config->pageSetTable, pageName);
-    }else{
-	configSet=(MkdgConfigSet *) g_ptr_array_index(config->setArray,0);
-    }
+    MkdgConfigSet *configSet=mkdg_config_find_set(config, pageName);
 
     gint i;
     MkdgValue *mValue=NULL, *mValueOld=NULL;
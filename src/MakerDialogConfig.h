@@ -198,6 +198,31 @@ gboolean mkdg_config_load_page(MkdgConfig *config, const gchar *pageName, MkdgEr
  */
 gboolean mkdg_config_save_page(MkdgConfig *config, const gchar *pageName, MkdgError **error);
 
+/**
+ * Save the unsaved configuration options of MakerDialog to file.
+ *
+ * This function saves the properties with ::MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED,
+ * which are found from the dirty bits of MakerDialog, see mkdg_mark_dirty().
+ * Nothing is written if no property is unsaved.
+ *
+ * Each configuration set gets only the unsaved properties of its pages,
+ * and sets without unsaved properties are skipped.
+ * Back-ends that implement config_file_save_properties(), such as GConf,
+ * only write the unsaved properties.
+ * Other back-ends, such as key file, rewrite the whole file as mkdg_config_save_all() does.
+ *
+ * ::MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED is cleared only for the properties
+ * whose configuration set is saved without error,
+ * so the others are saved again next time.
+ *
+ * Note that at least one configure set need to be added before this function.
+ * @param config	A MakerDialog config instance.
+ * @param error		Error return location, or \c NULL.
+ * @return TRUE if all unsaved properties are saved; FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_config_save_dirty(MkdgConfig *config, MkdgError **error);
+
 /**
  * Return all pages in configuration back-end.
  *
@@ -118,15 +118,37 @@ typedef enum{
  */
 typedef MkdgFlags MkdgConfigFileFlags;
 
+/**
+ * Number of values in each block of a configuration buffer.
+ */
+#define MKDG_CONFIG_BUFFER_BLOCK_SIZE	64
+
+/**
+ * Default size of string chunk in a configuration buffer.
+ */
+#define MKDG_CONFIG_BUFFER_CHUNK_SIZE	1024
+
 /**
  * Configuration buffer which stores the contents of pre-loaded properties.
  *
  * Configuration buffer stores the contents of pre-loaded properties.
  * This buffer can then be loaded to Mkdg, or save only the modified
  * parts.
+ *
+ * Keys are interned with g_intern_string(), so they are shared with
+ * interned property specs and other buffers.
+ * String values are kept in a string chunk,
+ * and values are carved from blocks of ::MKDG_CONFIG_BUFFER_BLOCK_SIZE values,
+ * so a buffer needs one allocation per block rather than one per value.
+ * Freeing the buffer drops the blocks and the chunk, but values that
+ * still own heap content are cleared one by one.
  */
 typedef struct{
     GHashTable *keyValueTable;			//!< Hash table whose key is configuration key, value is associated value for that key.
+    GStringChunk *strChunk;			//!< Storage of string values.
+    GPtrArray *valueBlocks;			//!< Blocks of values.
+    guint blockUsed;				//!< Number of used values in the last block.
+    GPtrArray *ownedValues;			//!< Values that still own heap content, such as string lists.
 } MkdgConfigBuffer;
 
 typedef struct _MkdgConfigSet		MkdgConfigSet;
@@ -38,12 +38,80 @@ void mkdg_config_file_free(MkdgConfigFile *configFile){
 
 MkdgConfigBuffer *mkdg_config_buffer_new(){
     MkdgConfigBuffer *configBuf=g_new(MkdgConfigBuffer, 1);
-    configBuf->keyValueTable=g_hash_table_new_full(g_str_hash, g_str_equal, g_free, mkdg_value_free);
+    /* Keys are interned, values are released along with strChunk and valueBlocks. */
+    configBuf->keyValueTable=g_hash_table_new(g_str_hash, g_str_equal);
+    configBuf->strChunk=g_string_chunk_new(MKDG_CONFIG_BUFFER_CHUNK_SIZE);
+    configBuf->valueBlocks=g_ptr_array_new();
+    configBuf->blockUsed=MKDG_CONFIG_BUFFER_BLOCK_SIZE;
+    configBuf->ownedValues=g_ptr_array_new();
     return configBuf;
 }
 
+static MkdgValue *mkdg_config_buffer_value_alloc(MkdgConfigBuffer *configBuf){
+    if (configBuf->blockUsed>=MKDG_CONFIG_BUFFER_BLOCK_SIZE){
+	g_ptr_array_add(configBuf->valueBlocks, g_new(MkdgValue, MKDG_CONFIG_BUFFER_BLOCK_SIZE));
+	configBuf->blockUsed=0;
+    }
+    MkdgValue *block=(MkdgValue *) g_ptr_array_index(configBuf->valueBlocks, configBuf->valueBlocks->len-1);
+    return &block[configBuf->blockUsed++];
+}
+
+/* Give back the value just taken by mkdg_config_buffer_value_alloc() */
+static void mkdg_config_buffer_value_unalloc(MkdgConfigBuffer *configBuf, MkdgValue *bufValue){
+    mkdg_value_clear(bufValue);
+    configBuf->blockUsed--;
+}
+
+static void mkdg_config_buffer_insert_private(MkdgConfigBuffer *configBuf, const gchar *key, MkdgValue *value){
+    if (value->flags & MKDG_VALUE_FLAG_NEED_FREE){
+	g_ptr_array_add(configBuf->ownedValues, value);
+    }
+    g_hash_table_insert(configBuf->keyValueTable, (gpointer) g_intern_string(key), value);
+}
+
 void mkdg_config_buffer_insert(MkdgConfigBuffer *configBuf, const gchar *key, MkdgValue *value){
-    g_hash_table_insert(configBuf->keyValueTable, g_strdup(key), value);
+    MkdgValue *bufValue=mkdg_config_buffer_value_alloc(configBuf);
+    /* Move the content, then release the empty shell. */
+    *bufValue=*value;
+    value->flags &= ~(MKDG_VALUE_FLAG_NEED_FREE | MKDG_VALUE_FLAG_INLINE);
+    mkdg_value_free(value);
+    mkdg_config_buffer_insert_private(configBuf, key, bufValue);
+}
+
+MkdgValue *mkdg_config_buffer_insert_new(MkdgConfigBuffer *configBuf, const gchar *key, MkdgType mType){
+    MkdgValue *bufValue=mkdg_config_buffer_value_alloc(configBuf);
+    if (!mkdg_value_init_static(bufValue, mType)){
+	configBuf->blockUsed--;
+	return NULL;
+    }
+    if (mkdg_type_is_pointer(mType)){
+	/* Caller may set content that need to be freed. */
+	g_ptr_array_add(configBuf->ownedValues, bufValue);
+    }
+    g_hash_table_insert(configBuf->keyValueTable, (gpointer) g_intern_string(key), bufValue);
+    return bufValue;
+}
+
+MkdgValue *mkdg_config_buffer_insert_string(MkdgConfigBuffer *configBuf, const gchar *key, MkdgType mType,
+	const gchar *str, const MkdgValueCodec *codec){
+    MkdgValue *bufValue=mkdg_config_buffer_value_alloc(configBuf);
+    if (!mkdg_value_init_static(bufValue, mType)){
+	configBuf->blockUsed--;
+	return NULL;
+    }
+    if (mType==MKDG_TYPE_STRING && str){
+	/* Static string value borrows str, so keep a copy in buffer. */
+	str=g_string_chunk_insert(configBuf->strChunk, str);
+    }
+    MkdgValue *parsed=(codec) ? mkdg_value_codec_from_string(codec, bufValue, str) :
+	mkdg_value_from_string(bufValue, str, NULL);
+    if (!parsed){
+	/* Such as unknown enumeration names, the key is not inserted. */
+	mkdg_config_buffer_value_unalloc(configBuf, bufValue);
+	return NULL;
+    }
+    mkdg_config_buffer_insert_private(configBuf, key, bufValue);
+    return bufValue;
 }
 
 MkdgValue *mkdg_config_buffer_lookup(MkdgConfigBuffer *configBuf, const gchar *key){
@@ -51,7 +119,17 @@ MkdgValue *mkdg_config_buffer_lookup(MkdgConfigBuffer *configBuf, const gchar *k
 }
 
 void mkdg_config_buffer_free(MkdgConfigBuffer *configBuf){
+    gint i;
+    for(i=0;i<configBuf->ownedValues->len;i++){
+	mkdg_value_clear((MkdgValue *) g_ptr_array_index(configBuf->ownedValues, i));
+    }
+    g_ptr_array_free(configBuf->ownedValues, TRUE);
+    for(i=0;i<configBuf->valueBlocks->len;i++){
+	g_free(g_ptr_array_index(configBuf->valueBlocks, i));
+    }
+    g_ptr_array_free(configBuf->valueBlocks, TRUE);
     g_hash_table_destroy(configBuf->keyValueTable);
+    g_string_chunk_free(configBuf->strChunk);
     g_free(configBuf);
 }
 
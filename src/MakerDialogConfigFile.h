@@ -257,6 +257,27 @@ struct _MkdgConfigFileInterface{
     MkdgValue * (* config_file_get_value)(MkdgConfigFile *configFile, const gchar *pageName, const gchar *key,
 	    MkdgType valueType, const gchar *parseOption, MkdgError **error);
 
+    /**
+     * Callback function to save some properties to a configuration file.
+     *
+     * This function connects to function that saves only the given properties,
+     * and leaves other properties in the configuration file intact.
+     * Called by mkdg_config_save_dirty().
+     *
+     * Back-ends that can only write a whole file leave it as \c NULL,
+     * then config_file_save() is called instead.
+     *
+     * @param configFile	The configuration file to be manipulated.
+     * @param configBuf		The configuration buffer, which is empty as nothing is preloaded.
+     * @param ctxs		Property contexts to be saved.
+     * @param count		Number of property contexts.
+     * @param error		Error return location, or \c NULL.
+     * @return \c TRUE if succeed; \c FALSE otherwise.
+     * @since 0.3
+     */
+    gboolean (* config_file_save_properties)(MkdgConfigFile *configFile, MkdgConfigBuffer *configBuf,
+	    MkdgPropertyContext **ctxs, guint count, MkdgError **error);
+
 };
 
 /**
@@ -277,12 +298,46 @@ MkdgConfigBuffer *mkdg_config_buffer_new();
  * Insert a value to a MakerDialog config buffer.
  *
  * Insert a value to a MakerDialog config buffer.
+ * The content of \a value is moved into the buffer and \a value itself is freed,
+ * so \a value should not be used afterwards.
  * @param configBuf 	A MakerDialog config buffer.
  * @param key		Property key to be inserted. This key will be duplicated in MakerDialog config buffer.
- * @param value		Value for the property.
+ * @param value		Value for the property, as returned by mkdg_value_new().
  */
 void mkdg_config_buffer_insert(MkdgConfigBuffer *configBuf, const gchar *key, MkdgValue *value);
 
+/**
+ * Insert a new value to a MakerDialog config buffer.
+ *
+ * Insert a new value with default content to a MakerDialog config buffer.
+ * The value is owned by the buffer,
+ * it is meant to be set with mkdg_value_set_int() and other setters of non-pointer types.
+ * Use mkdg_config_buffer_insert_string() for parsing a value from string.
+ * @param configBuf 	A MakerDialog config buffer.
+ * @param key		Property key to be inserted. This key will be duplicated in MakerDialog config buffer.
+ * @param mType		Type of the value.
+ * @return The value in buffer; \c NULL if \a mType is not supported.
+ * @since 0.3
+ */
+MkdgValue *mkdg_config_buffer_insert_new(MkdgConfigBuffer *configBuf, const gchar *key, MkdgType mType);
+
+/**
+ * Insert a value parsed from string to a MakerDialog config buffer.
+ *
+ * Insert a value parsed from string to a MakerDialog config buffer.
+ * The value is owned by the buffer, and \a str is not referred after return.
+ * @param configBuf 	A MakerDialog config buffer.
+ * @param key		Property key to be inserted. This key will be duplicated in MakerDialog config buffer.
+ * @param mType		Type of the value.
+ * @param str		String to be parsed.
+ * @param codec		Compiled parse option, see mkdg_value_codec_init(). \c NULL for default parsing.
+ * @return The value in buffer; \c NULL if \a mType is not supported or \a str cannot be parsed,
+ * in which case nothing is inserted.
+ * @since 0.3
+ */
+MkdgValue *mkdg_config_buffer_insert_string(MkdgConfigBuffer *configBuf, const gchar *key, MkdgType mType,
+	const gchar *str, const MkdgValueCodec *codec);
+
 /**
  * Lookup the associated value of a key in MakerDialog config buffer.
  *
@@ -226,6 +226,11 @@ static MkdgValue *mkdg_config_gconf_engine_get_value(GConfEngine *engine, const
 	case MKDG_TYPE_STRING:
 	case MKDG_TYPE_STRING_LIST:
 	case MKDG_TYPE_COLOR:
+	case MKDG_TYPE_ENUM:
+	case MKDG_TYPE_FLAGS:
+	case MKDG_TYPE_INT_ARRAY:
+	case MKDG_TYPE_DOUBLE_ARRAY:
+	case MKDG_TYPE_BLOB:
 	    strValue=(gchar *) gconf_engine_get_string(engine, path, &cfgErr_prep);
 	    if (strValue!=NULL){
 		MKDG_DEBUG_MSG(6, "[I6] config_gconf_engine_get_value() strValue=%s", strValue);
@@ -326,7 +331,40 @@ static gboolean gconf_preload_property(MkdgConfigFile *configFile, MkdgConfigBuf
     MKDG_DEBUG_MSG(3, "[I3] gconf_preload_property(%s,  , %s, )", configFile->path, ctx->spec->key);
     gchar *strValue=NULL;
 
-    MkdgValue *mValue=mkdg_value_new(ctx->spec->valueType, NULL);
+    MkdgValue *mValue=NULL;
+    switch(ctx->spec->valueType){
+	case MKDG_TYPE_STRING:
+	    strValue=(gchar *) gconf_value_get_string(cfgEntry->value);
+	    MKDG_DEBUG_MSG(6, "[I6] gconf_preload_property() strValue=%s", strValue);
+	    mValue=mkdg_config_buffer_insert_string(configBuf, ctx->spec->key, ctx->spec->valueType, strValue, NULL);
+	    break;
+	case MKDG_TYPE_STRING_LIST:
+	case MKDG_TYPE_COLOR:
+	    mValue=mkdg_config_buffer_insert_string(configBuf, ctx->spec->key, ctx->spec->valueType,
+		    gconf_value_get_string(cfgEntry->value), NULL);
+	    break;
+	case MKDG_TYPE_ENUM:
+	case MKDG_TYPE_FLAGS:
+	case MKDG_TYPE_INT_ARRAY:
+	case MKDG_TYPE_DOUBLE_ARRAY:
+	case MKDG_TYPE_BLOB:
+	    /* Stored as strings, such as names of the valid values */
+	    mValue=mkdg_config_buffer_insert_string(configBuf, ctx->spec->key, ctx->spec->valueType,
+		    gconf_value_get_string(cfgEntry->value), mkdg_property_spec_get_codec(ctx->spec));
+	    break;
+	default:
+	    mValue=mkdg_config_buffer_insert_new(configBuf, ctx->spec->key, ctx->spec->valueType);
+	    break;
+    }
+    if (!mValue){
+	cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_INVALID_VALUE, "config_gconf_preload_property() invalid value of key=%s", key);
+	mkdg_error_handle(cfgErr, error);
+	g_free(key);
+	if (configFile->configSet->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR ){
+	    return FALSE;
+	}
+	return TRUE;
+    }
     switch(ctx->spec->valueType){
 	case MKDG_TYPE_BOOLEAN:
 	    mkdg_value_set_boolean(mValue, gconf_value_get_bool(cfgEntry->value));
@@ -361,23 +399,15 @@ static gboolean gconf_preload_property(MkdgConfigFile *configFile, MkdgConfigBuf
 	case MKDG_TYPE_DOUBLE:
 	    mkdg_value_set_double(mValue, gconf_value_get_float(cfgEntry->value));
 	    break;
-	case MKDG_TYPE_STRING:
-	    strValue=(gchar *) gconf_value_get_string(cfgEntry->value);
-	    MKDG_DEBUG_MSG(6, "[I6] gconf_preload_property() strValue=%s", strValue);
-	    mkdg_value_from_string(mValue, strValue, NULL);
-	    break;
-	case MKDG_TYPE_STRING_LIST:
-	    mkdg_value_from_string(mValue, gconf_value_get_string(cfgEntry->value),NULL);
-	    break;
-	case MKDG_TYPE_COLOR:
-	    mkdg_value_from_string(mValue, gconf_value_get_string(cfgEntry->value), NULL);
-	    break;
 	default:
 	    break;
     }
-    MKDG_DEBUG_MSG(3,
-	    configFile->path, mkdg_value_to_string(mValue, ctx->spec->toStringFormat), ctx->spec->key );
-    mkdg_config_buffer_insert(configBuf, ctx->spec->key, mValue);
+    if (MKDG_DEBUG_RUN(3)){
+	gchar *str=mkdg_value_codec_to_string(mkdg_property_spec_get_codec(ctx->spec), mValue);
+	g_debug("[I3] gconf_preload_property(%s,  , %s, ) value=%s", configFile->path, ctx->spec->key, str);
+	g_free(str);
+    }
+    g_free(key);
     return TRUE;
 }
 
@@ -395,6 +425,7 @@ static gboolean gconf_preload_page(MkdgConfigFile *configFile, MkdgConfigBuffer
 	gconf_preload_property(configFile, configBuf, entryList, &cfgErr);
 	if (cfgErr!=NULL){
 	    mkdg_error_handle(cfgErr, error);
+	    cfgErr=NULL;
 	    if (configFile->configSet->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR ){
 		gconf_gslist_free(entryListHead, gconf_entry_free_wrapper);
 		return FALSE;
@@ -424,6 +455,7 @@ static gboolean mkdg_config_file_gconf_preload(MkdgConfigFile *configFile, MkdgC
 	gconf_preload_page(configFile, configBuf, pagePath, &cfgErr);
 	if (cfgErr){
 	    mkdg_error_handle(cfgErr, error);
+	    cfgErr=NULL;
 	    if (configFile->configSet->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR ){
 		gconf_gslist_free(dirListHead, g_free);
 		return FALSE;
@@ -434,6 +466,8 @@ static gboolean mkdg_config_file_gconf_preload(MkdgConfigFile *configFile, MkdgC
     return TRUE;
 }
 
+#define GCONF_VALUE_BUFFER_SIZE	256
+
 /*
  * This function just save the setting, without checking the duplication, and
  * so on.
@@ -445,7 +479,7 @@ static gboolean gconf_save_property(MkdgConfigFile *configFile, MkdgConfigBuffer
     MkdgValue *bufValue=mkdg_config_buffer_lookup(configBuf, ctx->spec->key);
     gboolean needChange=TRUE;
     if (bufValue!=NULL){
-	if (mkdg_value_compare(bufValue, ctx->value, NULL)==0){
+	if (mkdg_value_equal(bufValue, ctx->value)){
 	    /* Same value already in gconf */
 	    MKDG_DEBUG_MSG(4, "[I4] gconf_save_property() same value already in gconf, no need to change.");
 	    needChange=FALSE;
@@ -456,6 +490,8 @@ static gboolean gconf_save_property(MkdgConfigFile *configFile, MkdgConfigBuffer
 
     if (needChange){
 	gchar *keyPath=g_build_filename(configFile->path,pageName,ctx->spec->key, NULL);
+	gchar strBuf[GCONF_VALUE_BUFFER_SIZE];
+	gchar *strValue=NULL;
 
 	switch (ctx->spec->valueType){
 	    case MKDG_TYPE_BOOLEAN:
@@ -495,10 +531,28 @@ static gboolean gconf_save_property(MkdgConfigFile *configFile, MkdgConfigBuffer
 		gconf_change_set_set_string(changeSet, keyPath, mkdg_value_get_string(ctx->value));
 		break;
 	    case MKDG_TYPE_STRING_LIST:
-		gconf_change_set_set_string(changeSet, keyPath, mkdg_value_to_string(ctx->value, NULL));
-		break;
 	    case MKDG_TYPE_COLOR:
-		gconf_change_set_set_string(changeSet, keyPath, mkdg_value_to_string(ctx->value, NULL));
+		if (mkdg_value_format_into(ctx->value, NULL, strBuf, GCONF_VALUE_BUFFER_SIZE)<GCONF_VALUE_BUFFER_SIZE){
+		    gconf_change_set_set_string(changeSet, keyPath, strBuf);
+		}else{
+		    /* Too long for the stack buffer */
+		    strValue=mkdg_value_to_string(ctx->value, NULL);
+		    gconf_change_set_set_string(changeSet, keyPath, strValue);
+		    g_free(strValue);
+		}
+		break;
+	    case MKDG_TYPE_ENUM:
+	    case MKDG_TYPE_FLAGS:
+	    case MKDG_TYPE_INT_ARRAY:
+	    case MKDG_TYPE_DOUBLE_ARRAY:
+	    case MKDG_TYPE_BLOB:
+		if (mkdg_property_format_into(ctx, strBuf, GCONF_VALUE_BUFFER_SIZE)<GCONF_VALUE_BUFFER_SIZE){
+		    gconf_change_set_set_string(changeSet, keyPath, strBuf);
+		}else{
+		    strValue=mkdg_property_to_string(ctx);
+		    gconf_change_set_set_string(changeSet, keyPath, strValue);
+		    g_free(strValue);
+		}
 		break;
 //            case MKDG_TYPE_FILE:
 //            case MKDG_TYPE_KEY:
@@ -563,6 +617,32 @@ static gboolean mkdg_config_file_gconf_save(MkdgConfigFile *configFile, MkdgConf
     gconf_change_set_unref(changeSet);
     return ret;
 }
+
+static gboolean mkdg_config_file_gconf_save_properties(MkdgConfigFile *configFile, MkdgConfigBuffer *configBuf,
+	MkdgPropertyContext **ctxs, guint count, MkdgError **error){
+    MkdgError * cfgErr=NULL;
+    GConfChangeSet *changeSet=gconf_change_set_new();
+    guint i;
+    for(i=0;i<count;i++){
+	const gchar *pageName=(ctxs[i]->spec->pageName) ? ctxs[i]->spec->pageName : MKDG_PAGE_UNNAMED;
+	if (!gconf_save_property(configFile, configBuf, ctxs[i], pageName, changeSet, &cfgErr)){
+	    mkdg_error_handle(cfgErr,error);
+	    cfgErr=NULL;
+	    if (configFile->configSet->config->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR){
+		gconf_change_set_unref(changeSet);
+		return FALSE;
+	    }
+	}
+    }
+    gboolean ret=gconf_engine_commit_change_set (
+	    (GConfEngine *) configFile->configSet->userData, changeSet, TRUE, &cfgErr);
+    if (!ret){
+	mkdg_error_handle(cfgErr, error);
+	gconf_change_set_clear(changeSet);
+    }
+    gconf_change_set_unref(changeSet);
+    return ret;
+}
 /*=== End Config interface callbacks ===*/
 
 MkdgConfigFileInterface MKDG_CONFIG_FILE_INTERFACE_GCONF={
@@ -577,6 +657,7 @@ MkdgConfigFileInterface MKDG_CONFIG_FILE_INTERFACE_GCONF={
     mkdg_config_file_gconf_get_pages,
     mkdg_config_file_gconf_get_keys,
     mkdg_config_file_gconf_get_value,
+    mkdg_config_file_gconf_save_properties,
 };
 
 MkdgConfig *mkdg_config_use_gconf(Mkdg *mDialog){
@@ -713,6 +794,11 @@ static void xml_each_page_each_property_func(Mkdg *mDialog, MkdgPropertyContext
 	    break;
 	case MKDG_TYPE_STRING:
 	case MKDG_TYPE_COLOR:
+	case MKDG_TYPE_ENUM:
+	case MKDG_TYPE_FLAGS:
+	case MKDG_TYPE_INT_ARRAY:
+	case MKDG_TYPE_DOUBLE_ARRAY:
+	case MKDG_TYPE_BLOB:
 	    xml_tags_write(sData,"type",XML_TAG_TYPE_SHORT,NULL,"string");
 	    break;
 	default:
@@ -21,6 +21,8 @@
 #include <unistd.h>
 #include <glib/gstdio.h>
 #include "MakerDialog.h"
+#define KEY_FILE_VALUE_BUFFER_SIZE	256
+#define KEY_FILE_BLOB_SUFFIX		".blob"
 
 static MkdgError *convert_error_code(GError *error, const gchar *filename, const gchar *prefix){
     if (!error)
@@ -90,6 +92,8 @@ static MkdgValue *mkdg_config_file_key_file_get_value(MkdgConfigFile *configFile
     MkdgValue *mValue=mkdg_value_new(valueType,NULL);
     MkdgValue *ret=mkdg_value_from_string(mValue, str, parseOption);
     g_free(str);
+    if (!ret)
+	mkdg_value_free(mValue);
     return ret;
 }
 
@@ -179,14 +183,22 @@ static gboolean key_file_preload_property(MkdgConfigFile *configFile, MkdgConfig
 	/* It is expected behavior if NO_OVERRIDE is set. */
 	return TRUE;
     }
-    MkdgError *cfgErr=NULL;
-    MkdgValue *mValue= mkdg_config_file_key_file_get_value(configFile, ctx->spec->pageName, ctx->spec->key,
-	    ctx->spec->valueType, ctx->spec->parseOption, &cfgErr);
-    if (mValue==NULL){
+    MkdgError *cfgErr_prep=NULL;
+    gchar *str=g_key_file_get_string(configFile->fileObj, ctx->spec->pageName, ctx->spec->key, &cfgErr_prep);
+    if (cfgErr_prep!=NULL){
+	MkdgError *cfgErr=convert_error_code(cfgErr_prep, configFile->path, "key_file_preload_property()");
+	mkdg_error_handle(cfgErr,error);
+	return FALSE;
+    }
+    if (!mkdg_config_buffer_insert_string(configBuf, ctx->spec->key, ctx->spec->valueType, str,
+		mkdg_property_spec_get_codec(ctx->spec))){
+	MkdgError *cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_INVALID_VALUE,
+		"key_file_preload_property() %s: invalid value %s=%s", configFile->path, ctx->spec->key, str);
 	mkdg_error_handle(cfgErr,error);
+	g_free(str);
 	return FALSE;
     }
-    mkdg_config_buffer_insert(configBuf, ctx->spec->key, mValue);
+    g_free(str);
     return TRUE;
 }
 
@@ -202,6 +214,7 @@ static gboolean key_file_preload_page(MkdgConfigFile *configFile, MkdgConfigBuff
 	MkdgPropertyContext *ctx=mkdg_get_property_context(configFile->configSet->config->mDialog, keys[i]);
 	if (!key_file_preload_property(configFile, configBuf, ctx, &cfgErr)){
 	    mkdg_error_handle(cfgErr, error);
+	    cfgErr=NULL;
 	    if (configFile->configSet->config->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR){
 		g_strfreev(keys);
 		return FALSE;
@@ -228,6 +241,7 @@ static gboolean mkdg_config_file_key_file_preload(MkdgConfigFile *configFile, Mk
 	key_file_preload_page(configFile, configBuf, pages[i], &cfgErr);
 	if (cfgErr!=NULL){
 	    mkdg_error_handle(cfgErr, error);
+	    cfgErr=NULL;
 	    if (configFile->configSet->config->flags & MKDG_CONFIG_FLAG_STOP_ON_ERROR){
 		g_strfreev(pages);
 		return FALSE;
@@ -238,6 +252,27 @@ static gboolean mkdg_config_file_key_file_preload(MkdgConfigFile *configFile, Mk
     return TRUE;
 }
 
+/*
+ * Blobs only in memory are written to a sidecar file next to the key file,
+ * so the key file refers to the sidecar instead of inlining the data.
+ * The sidecar path is returned in sidecarPath, to be freed by caller.
+ * Blobs backed by a file are not written.
+ */
+static gboolean key_file_save_blob(MkdgConfigFile *configFile, MkdgPropertyContext *ctx,
+	gchar **sidecarPath, MkdgError **error){
+    MkdgBlob *blob=mkdg_value_get_blob(ctx->value);
+    *sidecarPath=NULL;
+    if (!blob || mkdg_blob_get_path(blob))
+	return TRUE;
+    *sidecarPath=g_strconcat(configFile->path, ".", ctx->spec->key, KEY_FILE_BLOB_SUFFIX, NULL);
+    if (!mkdg_blob_save(blob, *sidecarPath, error)){
+	g_free(*sidecarPath);
+	*sidecarPath=NULL;
+	return FALSE;
+    }
+    return TRUE;
+}
+
 /*
  * This function just save the setting, without checking the duplication, and
  * so on.
@@ -251,7 +286,7 @@ static gboolean key_file_save_property(MkdgConfigFile *configFile, MkdgConfigBuf
     MkdgValue *bufValue=mkdg_config_buffer_lookup(configBuf, ctx->spec->key);
     if (bufValue){
 	if ((configFile->configSet->flags & MKDG_CONFIG_FLAG_HIDE_DUPLICATE)
-		&& mkdg_value_compare(bufValue, ctx->value, ctx->spec->compareOption)==0){
+		&& mkdg_value_codec_equal(mkdg_property_spec_get_codec(ctx->spec), bufValue, ctx->value)){
 	    MKDG_DEBUG_MSG(4, "[I4] key_file_save_property() duplicated, no need to save.");
 	    needSave=FALSE;
 	}
@@ -266,11 +301,26 @@ static gboolean key_file_save_property(MkdgConfigFile *configFile, MkdgConfigBuf
 
     if (needSave){
 	gint ret=0;
-	if (ctx->spec->valueType==MKDG_TYPE_BOOLEAN){
+	gchar *sidecarPath=NULL;
+	if (ctx->spec->valueType==MKDG_TYPE_BLOB && !key_file_save_blob(configFile, ctx, &sidecarPath, error)){
+	    return FALSE;
+	}
+	if (sidecarPath){
+	    ret=fprintf((FILE *) configFile->userData,"%s=%s\n",ctx->spec->key, sidecarPath);
+	    g_free(sidecarPath);
+	}else if (ctx->spec->valueType==MKDG_TYPE_BOOLEAN){
 	    /* GKeyFile only accept "true" and  "false" */
 	    ret=fprintf((FILE *) configFile->userData,"%s=%s\n",ctx->spec->key, (mkdg_value_get_boolean(ctx->value))? "true" : "false");
 	}else{
-	    ret=fprintf((FILE *) configFile->userData,"%s=%s\n",ctx->spec->key, mkdg_property_to_string(ctx));
+	    gchar strBuf[KEY_FILE_VALUE_BUFFER_SIZE];
+	    if (mkdg_property_format_into(ctx, strBuf, KEY_FILE_VALUE_BUFFER_SIZE)<KEY_FILE_VALUE_BUFFER_SIZE){
+		ret=fprintf((FILE *) configFile->userData,"%s=%s\n",ctx->spec->key, strBuf);
+	    }else{
+		/* Too long for the stack buffer */
+		gchar *str=mkdg_property_to_string(ctx);
+		ret=fprintf((FILE *) configFile->userData,"%s=%s\n",ctx->spec->key, str);
+		g_free(str);
+	    }
 	}
 	if (ret<0){
 	    cfgErr=mkdg_error_new(MKDG_ERROR_CONFIG_CANT_WRITE, "key_file_save_property() failed on key %s",ctx->spec->key);
@@ -319,6 +369,7 @@ static gboolean mkdg_config_file_key_file_save(MkdgConfigFile *configFile, MkdgC
 
     gchar *parentDir=g_path_get_dirname(configFile->path);
     g_assert(g_mkdir_with_parents(parentDir, 0x755)==0);
+    g_free(parentDir);
     configFile->userData=(gpointer) g_fopen(configFile->path, "w");
     MkdgNodeIter iter=mkdg_page_iter_init(configFile->configSet->config->mDialog);
     while(mkdg_page_iter_has_next(iter)){
@@ -348,6 +399,7 @@ MkdgConfigFileInterface MKDG_CONFIG_FILE_INTERFACE_KEY_FILE={
     mkdg_config_file_key_file_get_pages,
     mkdg_config_file_key_file_get_keys,
     mkdg_config_file_key_file_get_value,
+    NULL,
 };
 
 MkdgConfig *mkdg_config_use_key_file(Mkdg *mDialog){
@@ -0,0 +1,593 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <glib.h>
+#include "MakerDialogNumber.h"
+
+gint mkdg_number_base_parse(const gchar *parseOption){
+    if (!parseOption || parseOption[0]=='\0')
+	return 0;
+    return atoi(parseOption);
+}
+
+/*=== Start digit functions ===*/
+static guint md_digit_value(guchar ch){
+    if ((guint) (ch-'0')<10)
+	return ch-'0';
+    ch|=0x20;
+    if ((guint) (ch-'a')<26)
+	return ch-'a'+10;
+    return 36;
+}
+
+/*
+ * SWAR (SIMD within a register) checks and converts 8 decimal digits at once.
+ * The 8 bytes are loaded in little-endian order.
+ */
+static guint64 md_swar_load(const gchar *p){
+    guint64 v;
+    memcpy(&v, p, sizeof(v));
+    return GUINT64_FROM_LE(v);
+}
+
+static gboolean md_swar_is_8digits(guint64 v){
+    return ((v & G_GUINT64_CONSTANT(0xF0F0F0F0F0F0F0F0))
+	    | (((v + G_GUINT64_CONSTANT(0x0606060606060606)) & G_GUINT64_CONSTANT(0xF0F0F0F0F0F0F0F0)) >> 4))
+	== G_GUINT64_CONSTANT(0x3333333333333333);
+}
+
+static guint64 md_swar_parse_8digits(guint64 v){
+    v-=G_GUINT64_CONSTANT(0x3030303030303030);
+    v=(v * 10) + (v >> 8);
+    v=(((v & G_GUINT64_CONSTANT(0x000000FF000000FF)) * (100 + (G_GUINT64_CONSTANT(1000000) << 32)))
+	    + (((v >> 16) & G_GUINT64_CONSTANT(0x000000FF000000FF)) * (1 + (G_GUINT64_CONSTANT(10000) << 32)))) >> 32;
+    return v;
+}
+
+/*
+ * Parse digits between *pp and end.
+ * *pp is moved to the first character that is not a digit.
+ */
+static MkdgNumberStatus md_parse_magnitude(const gchar **pp, const gchar *end, gint base, guint64 *mag){
+    const gchar *p=*pp;
+    guint64 val=0;
+    gboolean overflow=FALSE;
+    if (p>=end || md_digit_value((guchar) *p)>=(guint) base){
+	return MKDG_NUMBER_INVALID;
+    }
+    if (base==10){
+	/* 10^11 * 10^8 + 10^8 still fits in 64 bits. */
+	while(end-p>=8 && val<G_GUINT64_CONSTANT(100000000000)){
+	    guint64 chunk=md_swar_load(p);
+	    if (!md_swar_is_8digits(chunk))
+		break;
+	    val=val*100000000 + md_swar_parse_8digits(chunk);
+	    p+=8;
+	}
+    }
+    guint64 maxDiv=G_MAXUINT64/base;
+    guint maxRem=(guint) (G_MAXUINT64%base);
+    for(;p<end;p++){
+	guint d=md_digit_value((guchar) *p);
+	if (d>=(guint) base)
+	    break;
+	if (val>maxDiv || (val==maxDiv && d>maxRem)){
+	    overflow=TRUE;
+	}else{
+	    val=val*base+d;
+	}
+    }
+    *pp=p;
+    *mag=(overflow) ? G_MAXUINT64 : val;
+    return (overflow) ? MKDG_NUMBER_OVERFLOW : MKDG_NUMBER_OK;
+}
+/*=== End digit functions ===*/
+
+/*
+ * Strip leading and trailing spaces.
+ * Returns FALSE if nothing is left.
+ */
+static gboolean md_number_trim(const gchar *str, const gchar **start, const gchar **end){
+    if (!str)
+	return FALSE;
+    const gchar *p=str;
+    while(g_ascii_isspace(*p))
+	p++;
+    const gchar *e=p+strlen(p);
+    while(e>p && g_ascii_isspace(e[-1]))
+	e--;
+    *start=p;
+    *end=e;
+    return (p<e);
+}
+
+static MkdgNumberStatus md_parse_integer(const gchar *str, gint base, gboolean *negative, guint64 *mag){
+    const gchar *p, *end;
+    *negative=FALSE;
+    *mag=0;
+    if (!md_number_trim(str, &p, &end))
+	return MKDG_NUMBER_EMPTY;
+    if (*p=='-' || *p=='+'){
+	*negative=(*p=='-');
+	p++;
+    }
+    if (base==0){
+	if (end-p>2 && p[0]=='0' && (p[1]|0x20)=='x'){
+	    base=16;
+	    p+=2;
+	}else if (end-p>2 && p[0]=='0'){
+	    base=8;
+	    p++;
+	}else{
+	    base=10;
+	}
+    }else if (base==16){
+	if (end-p>2 && p[0]=='0' && (p[1]|0x20)=='x'){
+	    p+=2;
+	}
+    }
+    if (base<2 || base>36)
+	return MKDG_NUMBER_INVALID;
+    MkdgNumberStatus status=md_parse_magnitude(&p, end, base, mag);
+    if (status==MKDG_NUMBER_INVALID || p!=end){
+	*mag=0;
+	return MKDG_NUMBER_INVALID;
+    }
+    return status;
+}
+
+MkdgNumberStatus mkdg_number_parse_int64(const gchar *str, gint base, gint64 *result){
+    gboolean negative;
+    guint64 mag;
+    MkdgNumberStatus status=md_parse_integer(str, base, &negative, &mag);
+    if (negative){
+	if (mag>(guint64) G_MAXINT64+1){
+	    *result=G_MININT64;
+	    return MKDG_NUMBER_OVERFLOW;
+	}
+	/* Negate in unsigned, so G_MININT64 works. */
+	*result=(gint64) (0-mag);
+    }else{
+	if (mag>(guint64) G_MAXINT64){
+	    *result=G_MAXINT64;
+	    return MKDG_NUMBER_OVERFLOW;
+	}
+	*result=(gint64) mag;
+    }
+    return status;
+}
+
+MkdgNumberStatus mkdg_number_parse_uint64(const gchar *str, gint base, guint64 *result){
+    gboolean negative;
+    guint64 mag;
+    MkdgNumberStatus status=md_parse_integer(str, base, &negative, &mag);
+    if (negative && mag!=0){
+	*result=0;
+	return MKDG_NUMBER_OVERFLOW;
+    }
+    *result=mag;
+    return status;
+}
+
+/*=== Start floating point functions ===*/
+/* Powers of ten that are exactly representable in double. */
+static const gdouble md_pow10[]={
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+    1e21, 1e22
+};
+
+/*
+ * Clinger's fast path: a decimal with at most 15 significant digits and
+ * a small exponent is exactly computed with one multiplication or division.
+ * Returns FALSE if the string needs the full parser.
+ */
+static gboolean md_parse_double_fast(const gchar *p, const gchar *end, gdouble *result){
+    gboolean negative=FALSE;
+    guint64 mantissa=0;
+    gboolean hasDigits=FALSE;
+    gint digits=0, exponent=0;
+    if (*p=='-' || *p=='+'){
+	negative=(*p=='-');
+	p++;
+    }
+    for(;p<end && (guint) (*p-'0')<10;p++){
+	if (digits>=15)
+	    return FALSE;
+	mantissa=mantissa*10+(*p-'0');
+	if (mantissa)
+	    digits++;
+	hasDigits=TRUE;
+    }
+    if (p<end && *p=='.'){
+	p++;
+	for(;p<end && (guint) (*p-'0')<10;p++){
+	    if (digits>=15)
+		return FALSE;
+	    mantissa=mantissa*10+(*p-'0');
+	    if (mantissa)
+		digits++;
+	    exponent--;
+	    hasDigits=TRUE;
+	}
+    }
+    if (p<end && (*p|0x20)=='e'){
+	p++;
+	gboolean expNegative=FALSE;
+	gint e=0;
+	if (p<end && (*p=='-' || *p=='+')){
+	    expNegative=(*p=='-');
+	    p++;
+	}
+	if (p>=end)
+	    return FALSE;
+	for(;p<end && (guint) (*p-'0')<10;p++){
+	    if (e>1000)
+		return FALSE;
+	    e=e*10+(*p-'0');
+	}
+	exponent+=(expNegative) ? -e : e;
+    }
+    if (p!=end || !hasDigits)
+	return FALSE;
+    if (exponent<-22 || exponent>22)
+	return FALSE;
+    gdouble val=(gdouble) mantissa;
+    if (exponent<0){
+	val/=md_pow10[-exponent];
+    }else{
+	val*=md_pow10[exponent];
+    }
+    *result=(negative) ? -val : val;
+    return TRUE;
+}
+
+MkdgNumberStatus mkdg_number_parse_double(const gchar *str, gdouble *result){
+    const gchar *p, *end;
+    *result=0.0;
+    if (!md_number_trim(str, &p, &end))
+	return MKDG_NUMBER_EMPTY;
+    if (md_parse_double_fast(p, end, result))
+	return MKDG_NUMBER_OK;
+
+    gchar *endPtr=NULL;
+    errno=0;
+    gdouble val=g_ascii_strtod(p, &endPtr);
+    if (endPtr==p || endPtr!=end){
+	*result=0.0;
+	return MKDG_NUMBER_INVALID;
+    }
+    *result=val;
+    if (errno==ERANGE && (val==HUGE_VAL || val==-HUGE_VAL)){
+	return MKDG_NUMBER_OVERFLOW;
+    }
+    return MKDG_NUMBER_OK;
+}
+/*=== End floating point functions ===*/
+
+/*=== Start floating point format functions ===*/
+/*
+ * Shortest round-trip formatting with Grisu2 (Florian Loitsch,
+ * "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010).
+ * Output always parses back to the same value,
+ * and is the shortest such output for almost all values.
+ */
+typedef struct{
+    guint64 f;
+    gint e;
+} MdDiyFp;
+
+/* Normalized 10^k for k = -348, -340, ..., 340 */
+static const guint64 md_cached_powers_f[]={
+    G_GUINT64_CONSTANT(0xfa8fd5a0081c0288), G_GUINT64_CONSTANT(0xbaaee17fa23ebf76), G_GUINT64_CONSTANT(0x8b16fb203055ac76),
+    G_GUINT64_CONSTANT(0xcf42894a5dce35ea), G_GUINT64_CONSTANT(0x9a6bb0aa55653b2d), G_GUINT64_CONSTANT(0xe61acf033d1a45df),
+    G_GUINT64_CONSTANT(0xab70fe17c79ac6ca), G_GUINT64_CONSTANT(0xff77b1fcbebcdc4f), G_GUINT64_CONSTANT(0xbe5691ef416bd60c),
+    G_GUINT64_CONSTANT(0x8dd01fad907ffc3c), G_GUINT64_CONSTANT(0xd3515c2831559a83), G_GUINT64_CONSTANT(0x9d71ac8fada6c9b5),
+    G_GUINT64_CONSTANT(0xea9c227723ee8bcb), G_GUINT64_CONSTANT(0xaecc49914078536d), G_GUINT64_CONSTANT(0x823c12795db6ce57),
+    G_GUINT64_CONSTANT(0xc21094364dfb5637), G_GUINT64_CONSTANT(0x9096ea6f3848984f), G_GUINT64_CONSTANT(0xd77485cb25823ac7),
+    G_GUINT64_CONSTANT(0xa086cfcd97bf97f4), G_GUINT64_CONSTANT(0xef340a98172aace5), G_GUINT64_CONSTANT(0xb23867fb2a35b28e),
+    G_GUINT64_CONSTANT(0x84c8d4dfd2c63f3b), G_GUINT64_CONSTANT(0xc5dd44271ad3cdba), G_GUINT64_CONSTANT(0x936b9fcebb25c996),
+    G_GUINT64_CONSTANT(0xdbac6c247d62a584), G_GUINT64_CONSTANT(0xa3ab66580d5fdaf6), G_GUINT64_CONSTANT(0xf3e2f893dec3f126),
+    G_GUINT64_CONSTANT(0xb5b5ada8aaff80b8), G_GUINT64_CONSTANT(0x87625f056c7c4a8b), G_GUINT64_CONSTANT(0xc9bcff6034c13053),
+    G_GUINT64_CONSTANT(0x964e858c91ba2655), G_GUINT64_CONSTANT(0xdff9772470297ebd), G_GUINT64_CONSTANT(0xa6dfbd9fb8e5b88f),
+    G_GUINT64_CONSTANT(0xf8a95fcf88747d94), G_GUINT64_CONSTANT(0xb94470938fa89bcf), G_GUINT64_CONSTANT(0x8a08f0f8bf0f156b),
+    G_GUINT64_CONSTANT(0xcdb02555653131b6), G_GUINT64_CONSTANT(0x993fe2c6d07b7fac), G_GUINT64_CONSTANT(0xe45c10c42a2b3b06),
+    G_GUINT64_CONSTANT(0xaa242499697392d3), G_GUINT64_CONSTANT(0xfd87b5f28300ca0e), G_GUINT64_CONSTANT(0xbce5086492111aeb),
+    G_GUINT64_CONSTANT(0x8cbccc096f5088cc), G_GUINT64_CONSTANT(0xd1b71758e219652c), G_GUINT64_CONSTANT(0x9c40000000000000),
+    G_GUINT64_CONSTANT(0xe8d4a51000000000), G_GUINT64_CONSTANT(0xad78ebc5ac620000), G_GUINT64_CONSTANT(0x813f3978f8940984),
+    G_GUINT64_CONSTANT(0xc097ce7bc90715b3), G_GUINT64_CONSTANT(0x8f7e32ce7bea5c70), G_GUINT64_CONSTANT(0xd5d238a4abe98068),
+    G_GUINT64_CONSTANT(0x9f4f2726179a2245), G_GUINT64_CONSTANT(0xed63a231d4c4fb27), G_GUINT64_CONSTANT(0xb0de65388cc8ada8),
+    G_GUINT64_CONSTANT(0x83c7088e1aab65db), G_GUINT64_CONSTANT(0xc45d1df942711d9a), G_GUINT64_CONSTANT(0x924d692ca61be758),
+    G_GUINT64_CONSTANT(0xda01ee641a708dea), G_GUINT64_CONSTANT(0xa26da3999aef774a), G_GUINT64_CONSTANT(0xf209787bb47d6b85),
+    G_GUINT64_CONSTANT(0xb454e4a179dd1877), G_GUINT64_CONSTANT(0x865b86925b9bc5c2), G_GUINT64_CONSTANT(0xc83553c5c8965d3d),
+    G_GUINT64_CONSTANT(0x952ab45cfa97a0b3), G_GUINT64_CONSTANT(0xde469fbd99a05fe3), G_GUINT64_CONSTANT(0xa59bc234db398c25),
+    G_GUINT64_CONSTANT(0xf6c69a72a3989f5c), G_GUINT64_CONSTANT(0xb7dcbf5354e9bece), G_GUINT64_CONSTANT(0x88fcf317f22241e2),
+    G_GUINT64_CONSTANT(0xcc20ce9bd35c78a5), G_GUINT64_CONSTANT(0x98165af37b2153df), G_GUINT64_CONSTANT(0xe2a0b5dc971f303a),
+    G_GUINT64_CONSTANT(0xa8d9d1535ce3b396), G_GUINT64_CONSTANT(0xfb9b7cd9a4a7443c), G_GUINT64_CONSTANT(0xbb764c4ca7a44410),
+    G_GUINT64_CONSTANT(0x8bab8eefb6409c1a), G_GUINT64_CONSTANT(0xd01fef10a657842c), G_GUINT64_CONSTANT(0x9b10a4e5e9913129),
+    G_GUINT64_CONSTANT(0xe7109bfba19c0c9d), G_GUINT64_CONSTANT(0xac2820d9623bf429), G_GUINT64_CONSTANT(0x80444b5e7aa7cf85),
+    G_GUINT64_CONSTANT(0xbf21e44003acdd2d), G_GUINT64_CONSTANT(0x8e679c2f5e44ff8f), G_GUINT64_CONSTANT(0xd433179d9c8cb841),
+    G_GUINT64_CONSTANT(0x9e19db92b4e31ba9), G_GUINT64_CONSTANT(0xeb96bf6ebadf77d9), G_GUINT64_CONSTANT(0xaf87023b9bf0ee6b)
+};
+
+static const gint16 md_cached_powers_e[]={
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const guint64 md_pow10_u64[]={
+    G_GUINT64_CONSTANT(1), G_GUINT64_CONSTANT(10), G_GUINT64_CONSTANT(100), G_GUINT64_CONSTANT(1000),
+    G_GUINT64_CONSTANT(10000), G_GUINT64_CONSTANT(100000), G_GUINT64_CONSTANT(1000000),
+    G_GUINT64_CONSTANT(10000000), G_GUINT64_CONSTANT(100000000), G_GUINT64_CONSTANT(1000000000),
+    G_GUINT64_CONSTANT(10000000000), G_GUINT64_CONSTANT(100000000000), G_GUINT64_CONSTANT(1000000000000),
+    G_GUINT64_CONSTANT(10000000000000), G_GUINT64_CONSTANT(100000000000000),
+    G_GUINT64_CONSTANT(1000000000000000), G_GUINT64_CONSTANT(10000000000000000),
+    G_GUINT64_CONSTANT(100000000000000000), G_GUINT64_CONSTANT(1000000000000000000),
+    G_GUINT64_CONSTANT(10000000000000000000)
+};
+
+static MdDiyFp md_diyfp_normalize(MdDiyFp x){
+    while(!(x.f & G_GUINT64_CONSTANT(0xFFC0000000000000))){
+	x.f<<=10;
+	x.e-=10;
+    }
+    while(!(x.f & G_GUINT64_CONSTANT(0x8000000000000000))){
+	x.f<<=1;
+	x.e--;
+    }
+    return x;
+}
+
+/* Upper 64 bits of the 128-bit product, rounded. */
+static MdDiyFp md_diyfp_multiply(MdDiyFp x, MdDiyFp y){
+    const guint64 m32=G_GUINT64_CONSTANT(0xFFFFFFFF);
+    guint64 a=x.f >> 32, b=x.f & m32, c=y.f >> 32, d=y.f & m32;
+    guint64 ac=a*c, bc=b*c, ad=a*d, bd=b*d;
+    guint64 tmp=(bd >> 32) + (ad & m32) + (bc & m32);
+    tmp+=G_GUINT64_CONSTANT(1) << 31;
+    MdDiyFp r={ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+    return r;
+}
+
+/* Find c_k=10^-k such that the product exponent is in [-60, -32]. */
+static MdDiyFp md_cached_power(gint e, gint *k){
+    gdouble dk=(-61 - e) * 0.30102999566398114 + 347;
+    gint ik=(gint) dk;
+    if (dk-ik>0.0)
+	ik++;
+    guint index=(guint) ((ik >> 3) + 1);
+    *k=-(-348 + (gint) index * 8);
+    MdDiyFp r={md_cached_powers_f[index], md_cached_powers_e[index]};
+    return r;
+}
+
+static void md_grisu_round(gchar *buf, gint len, guint64 delta, guint64 rest, guint64 tenKappa, guint64 wpW){
+    while(rest<wpW && delta-rest>=tenKappa
+	    && (rest+tenKappa<wpW || wpW-rest>rest+tenKappa-wpW)){
+	buf[len-1]--;
+	rest+=tenKappa;
+    }
+}
+
+static gint md_count_digits32(guint32 n){
+    gint count=1;
+    while(n>=10){
+	n/=10;
+	count++;
+    }
+    return count;
+}
+
+static gint md_grisu_digit_gen(MdDiyFp w, MdDiyFp mp, guint64 delta, gchar *buf, gint *k){
+    MdDiyFp one={G_GUINT64_CONSTANT(1) << -mp.e, mp.e};
+    guint64 wpW=mp.f-w.f;
+    guint32 p1=(guint32) (mp.f >> -one.e);
+    guint64 p2=mp.f & (one.f-1);
+    gint kappa=md_count_digits32(p1);
+    gint len=0;
+    while(kappa>0){
+	guint32 pow10=(guint32) md_pow10_u64[kappa-1];
+	guint32 d=p1/pow10;
+	p1%=pow10;
+	if (d || len)
+	    buf[len++]='0'+ (gchar) d;
+	kappa--;
+	guint64 tmp=(((guint64) p1) << -one.e) + p2;
+	if (tmp<=delta){
+	    *k+=kappa;
+	    md_grisu_round(buf, len, delta, tmp, md_pow10_u64[kappa] << -one.e, wpW);
+	    return len;
+	}
+    }
+    for(;;){
+	p2*=10;
+	delta*=10;
+	gchar d=(gchar) (p2 >> -one.e);
+	if (d || len)
+	    buf[len++]='0'+d;
+	p2&=one.f-1;
+	kappa--;
+	if (p2<delta){
+	    *k+=kappa;
+	    md_grisu_round(buf, len, delta, p2, one.f, (-kappa<20) ? wpW * md_pow10_u64[-kappa] : 0);
+	    return len;
+	}
+    }
+}
+
+/*
+ * Generate shortest digits of f*2^e, value is digits*10^k.
+ * lowerCloser is TRUE if the lower neighbour is closer,
+ * i.e. f is the smallest significand of a normal exponent.
+ */
+static gint md_grisu2(guint64 f, gint e, gboolean lowerCloser, gchar *buf, gint *k){
+    MdDiyFp v={f, e};
+    MdDiyFp mPlus={(f << 1) + 1, e-1};
+    MdDiyFp mMinus;
+    if (lowerCloser){
+	mMinus.f=(f << 2) - 1;
+	mMinus.e=e-2;
+    }else{
+	mMinus.f=(f << 1) - 1;
+	mMinus.e=e-1;
+    }
+    mPlus=md_diyfp_normalize(mPlus);
+    mMinus.f<<=mMinus.e-mPlus.e;
+    mMinus.e=mPlus.e;
+    MdDiyFp cMk=md_cached_power(mPlus.e, k);
+    MdDiyFp w=md_diyfp_multiply(md_diyfp_normalize(v), cMk);
+    MdDiyFp wPlus=md_diyfp_multiply(mPlus, cMk);
+    MdDiyFp wMinus=md_diyfp_multiply(mMinus, cMk);
+    wMinus.f++;
+    wPlus.f--;
+    return md_grisu_digit_gen(w, wPlus, wPlus.f-wMinus.f, buf, k);
+}
+
+/*
+ * Lay out digits*10^k as %g does:
+ * fixed notation unless decimal exponent is < -4 or >= 17.
+ */
+static gsize md_number_format_digits(gboolean negative, const gchar *digits, gint len, gint k,
+	gchar *buf, gsize bufSize){
+    gchar out[MKDG_NUMBER_FORMAT_BUFFER_SIZE];
+    gchar *p=out;
+    gint kk=len+k;
+    gint i;
+    if (negative)
+	*p++='-';
+    if (kk-1>=-4 && kk-1<17){
+	if (kk<=0){
+	    *p++='0';
+	    *p++='.';
+	    for(i=kk;i<0;i++)
+		*p++='0';
+	    memcpy(p, digits, len);
+	    p+=len;
+	}else if (kk>=len){
+	    memcpy(p, digits, len);
+	    p+=len;
+	    for(i=len;i<kk;i++)
+		*p++='0';
+	}else{
+	    memcpy(p, digits, kk);
+	    p+=kk;
+	    *p++='.';
+	    memcpy(p, digits+kk, len-kk);
+	    p+=len-kk;
+	}
+    }else{
+	gint exp10=kk-1;
+	*p++=digits[0];
+	if (len>1){
+	    *p++='.';
+	    memcpy(p, digits+1, len-1);
+	    p+=len-1;
+	}
+	*p++='e';
+	if (exp10<0){
+	    *p++='-';
+	    exp10=-exp10;
+	}else{
+	    *p++='+';
+	}
+	if (exp10>=100)
+	    *p++='0'+ (gchar) (exp10/100);
+	*p++='0'+ (gchar) ((exp10/10)%10);
+	*p++='0'+ (gchar) (exp10%10);
+    }
+    gsize outLen=p-out;
+    if (bufSize>0){
+	gsize n=(outLen<bufSize) ? outLen : bufSize-1;
+	memcpy(buf, out, n);
+	buf[n]='\0';
+    }
+    return outLen;
+}
+
+static gsize md_number_format_special(const gchar *str, gchar *buf, gsize bufSize){
+    gsize len=strlen(str);
+    if (bufSize>0){
+	gsize n=(len<bufSize) ? len : bufSize-1;
+	memcpy(buf, str, n);
+	buf[n]='\0';
+    }
+    return len;
+}
+
+gsize mkdg_number_format_double(gdouble value, gchar *buf, gsize bufSize){
+    guint64 bits;
+    gchar digits[24];
+    gint k=0;
+    memcpy(&bits, &value, sizeof(bits));
+    gboolean negative=(bits >> 63)!=0;
+    guint biasedE=(guint) ((bits >> 52) & 0x7FF);
+    guint64 f=bits & G_GUINT64_CONSTANT(0x000FFFFFFFFFFFFF);
+    if (biasedE==0x7FF){
+	if (f)
+	    return md_number_format_special("nan", buf, bufSize);
+	return md_number_format_special((negative) ? "-inf" : "inf", buf, bufSize);
+    }
+    if (biasedE==0 && f==0){
+	return md_number_format_special((negative) ? "-0" : "0", buf, bufSize);
+    }
+    gint len;
+    if (biasedE){
+	len=md_grisu2(f | G_GUINT64_CONSTANT(0x0010000000000000), (gint) biasedE-1075, (f==0 && biasedE>1), digits, &k);
+    }else{
+	len=md_grisu2(f, -1074, FALSE, digits, &k);
+    }
+    return md_number_format_digits(negative, digits, len, k, buf, bufSize);
+}
+
+gsize mkdg_number_format_float(gfloat value, gchar *buf, gsize bufSize){
+    guint32 bits;
+    gchar digits[24];
+    gint k=0;
+    memcpy(&bits, &value, sizeof(bits));
+    gboolean negative=(bits >> 31)!=0;
+    guint biasedE=(bits >> 23) & 0xFF;
+    guint64 f=bits & 0x7FFFFF;
+    if (biasedE==0xFF){
+	if (f)
+	    return md_number_format_special("nan", buf, bufSize);
+	return md_number_format_special((negative) ? "-inf" : "inf", buf, bufSize);
+    }
+    if (biasedE==0 && f==0){
+	return md_number_format_special((negative) ? "-0" : "0", buf, bufSize);
+    }
+    gint len;
+    if (biasedE){
+	len=md_grisu2(f | 0x800000, (gint) biasedE-150, (f==0 && biasedE>1), digits, &k);
+    }else{
+	len=md_grisu2(f, -149, FALSE, digits, &k);
+    }
+    return md_number_format_digits(negative, digits, len, k, buf, bufSize);
+}
+/*=== End floating point format functions ===*/
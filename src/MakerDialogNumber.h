@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file MakerDialogNumber.h
+ * Number parsing functions for Mkdg.
+ *
+ * This file lists the strict, locale-independent number parsers
+ * used by numeric MakerDialog types.
+ * @since 0.3
+ */
+#ifndef MKDG_NUMBER_H_
+#define MKDG_NUMBER_H_
+#include <glib.h>
+
+/**
+ * Enumeration of number parsing status.
+ *
+ * Enumeration of number parsing status.
+ * @since 0.3
+ */
+typedef enum{
+    MKDG_NUMBER_OK=0,		//!< The whole string is a valid number.
+    MKDG_NUMBER_EMPTY,		//!< The string is \c NULL, empty or contains only spaces. Result is 0.
+    MKDG_NUMBER_INVALID,	//!< The string contains characters that are not part of the number.
+    MKDG_NUMBER_OVERFLOW,	//!< The number is out of range. Result is clamped to the nearest limit.
+} MKDG_NUMBER_STATUS;
+
+/**
+ * Data structure for number parsing status.
+ *
+ * Data structure for number parsing status.
+ * @since 0.3
+ */
+typedef gint MkdgNumberStatus;
+
+/**
+ * Determine the base from a parse option.
+ *
+ * Determine the base from the parse option of a numeric property.
+ * @param parseOption	Parse option such as "16". Can be \c NULL.
+ * @return Base specified in \a parseOption; or 0 to detect from prefix.
+ * @since 0.3
+ */
+gint mkdg_number_base_parse(const gchar *parseOption);
+
+/**
+ * Parse a signed 64-bit integer.
+ *
+ * This function parses a signed integer strictly:
+ * leading and trailing spaces are allowed, anything else must be part of the number.
+ *
+ * If \a base is 0, base is detected from prefix as in C:
+ * "0x" for hexadecimal; "0" for octal if followed by more than one digit;
+ * otherwise decimal.
+ * If \a base is 16, an optional "0x" prefix is accepted.
+ *
+ * @param str		String to be parsed. Can be \c NULL.
+ * @param base		Base between 2 and 36; or 0 for detecting from prefix.
+ * @param result	Returned value. Clamped on overflow.
+ * @return Parsing status.
+ * @since 0.3
+ */
+MkdgNumberStatus mkdg_number_parse_int64(const gchar *str, gint base, gint64 *result);
+
+/**
+ * Parse an unsigned 64-bit integer.
+ *
+ * This function works as mkdg_number_parse_int64(), but for unsigned integers.
+ * Negative numbers other than "-0" are reported as ::MKDG_NUMBER_OVERFLOW
+ * and clamped to 0.
+ *
+ * @param str		String to be parsed. Can be \c NULL.
+ * @param base		Base between 2 and 36; or 0 for detecting from prefix.
+ * @param result	Returned value. Clamped on overflow.
+ * @return Parsing status.
+ * @since 0.3
+ */
+MkdgNumberStatus mkdg_number_parse_uint64(const gchar *str, gint base, guint64 *result);
+
+/**
+ * Parse a double-precision floating point number.
+ *
+ * This function parses a floating point number strictly and independent of locale,
+ * that is, '.' is always the decimal point.
+ * Leading and trailing spaces are allowed.
+ *
+ * @param str		String to be parsed. Can be \c NULL.
+ * @param result	Returned value. \c ±HUGE_VAL on overflow.
+ * @return Parsing status.
+ * @since 0.3
+ */
+MkdgNumberStatus mkdg_number_parse_double(const gchar *str, gdouble *result);
+
+/**
+ * Buffer size that fits any output of mkdg_number_format_double().
+ *
+ * Buffer size that fits any output of mkdg_number_format_double()
+ * and mkdg_number_format_float(), including the terminating NUL.
+ * @since 0.3
+ */
+#define MKDG_NUMBER_FORMAT_BUFFER_SIZE 32
+
+/**
+ * Format a double into the shortest string that parses back to it.
+ *
+ * This function outputs a decimal string that
+ * mkdg_number_parse_double() converts back to exactly \a value.
+ * The string is the shortest such string for nearly all values;
+ * in rare cases it has one more digit.
+ * The layout is as "%g": exponent notation is used only for very large or small values.
+ * '.' is always the decimal point.
+ *
+ * Like snprintf(), at most \a bufSize bytes including the terminating NUL are written.
+ *
+ * @param value		Value to be formatted.
+ * @param buf		Buffer to write to. Can be \c NULL if \a bufSize is 0.
+ * @param bufSize	Size of \a buf.
+ * @return Length of the untruncated output, not including the terminating NUL.
+ * @see mkdg_number_format_float()
+ * @since 0.3
+ */
+gsize mkdg_number_format_double(gdouble value, gchar *buf, gsize bufSize);
+
+/**
+ * Format a float into the shortest string that parses back to it.
+ *
+ * This function works as mkdg_number_format_double(), but the digits are
+ * the shortest for single precision.
+ *
+ * @param value		Value to be formatted.
+ * @param buf		Buffer to write to. Can be \c NULL if \a bufSize is 0.
+ * @param bufSize	Size of \a buf.
+ * @return Length of the untruncated output, not including the terminating NUL.
+ * @see mkdg_number_format_double()
+ * @since 0.3
+ */
+gsize mkdg_number_format_float(gfloat value, gchar *buf, gsize bufSize);
+
+#endif /* MKDG_NUMBER_H_ */
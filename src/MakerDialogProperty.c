@@ -42,7 +42,7 @@ MkdgPropertySpec *mkdg_property_spec_new_full(const gchar *key,
 	MkdgPropertyFlags propertyFlags,
 	const gchar *pageName, const gchar *groupName, const gchar *label, const gchar *translationContext,
 	const gchar *tooltip, gchar **imagePaths, MkdgControlRule *rules, gpointer userData){
-    MkdgPropertySpec *spec=g_new(MkdgPropertySpec, 1);
+    MkdgPropertySpec *spec=g_new0(MkdgPropertySpec, 1);
     if (spec){
 	spec->key=key;
 	spec->valueType=valueType;
@@ -67,6 +67,7 @@ MkdgPropertySpec *mkdg_property_spec_new_full(const gchar *key,
 	spec->rules=rules;
 
 	spec->userData=userData;
+	mkdg_property_spec_compile(spec);
     }
     return spec;
 }
@@ -88,21 +89,49 @@ void mkdg_control_rule_free(MkdgControlRule *rule){
 static void mkdg_control_rules_free(MkdgControlRule *rules){
     if (!rules)
 	return;
-    while(rules->key!=NULL){
-	MkdgControlRule *rulesTmp=rules;
+    MkdgControlRule *rulesTmp=rules;
+    while(rulesTmp->key!=NULL){
 	mkdg_control_rule_free(rulesTmp);
-	rules++;
+	rulesTmp++;
     }
     g_free(rules);
 }
 
+/*
+ * Release the values parsed by mkdg_property_spec_compile().
+ */
+static void mkdg_property_spec_clear_parsed(MkdgPropertySpec *spec){
+    gint i;
+    mkdg_value_clear(&spec->parsedDefault);
+    if (spec->validValueIndex){
+	g_hash_table_destroy(spec->validValueIndex);
+	spec->validValueIndex=NULL;
+    }
+    for(i=0;i<spec->validValueCount;i++){
+	mkdg_value_clear(&spec->parsedValidValues[i]);
+    }
+    g_free(spec->parsedValidValues);
+    spec->parsedValidValues=NULL;
+    spec->validValueCount=0;
+}
+
 void mkdg_property_spec_free(MkdgPropertySpec *spec){
-    if (spec->flags & MKDG_PROPERTY_FLAG_CAN_FREE){
+    if (spec->codec.compiled){
+	mkdg_property_spec_clear_parsed(spec);
+    }
+    if ((spec->flags & MKDG_PROPERTY_FLAG_CAN_FREE) && (spec->flags & MKDG_PROPERTY_FLAG_INTERN_STRINGS)){
+	/* Interned strings are shared, only the vectors are owned. */
+	g_free((gchar **)spec->validValues);
+	g_free(spec->imagePaths);
+	mkdg_control_rules_free(spec->rules);
+	g_free(spec->userData);
+    }else if (spec->flags & MKDG_PROPERTY_FLAG_CAN_FREE){
 	g_free((gchar *)spec->key);
 	g_free((gchar *)spec->defaultValue);
 	g_strfreev((gchar **)spec->validValues);
 	g_free((gchar *) spec->parseOption);
 	g_free((gchar *) spec->toStringFormat);
+	g_free((gchar *) spec->compareOption);
 	g_free((gchar *) spec->pageName);
 	g_free((gchar *) spec->groupName);
 	g_free((gchar *) spec->label);
@@ -115,6 +144,166 @@ void mkdg_property_spec_free(MkdgPropertySpec *spec){
     g_free(spec);
 }
 
+static void mkdg_property_spec_compile_valid_values(MkdgPropertySpec *spec){
+    gint i;
+    if (!spec->validValues)
+	return;
+    spec->validValueCount=g_strv_length(spec->validValues);
+    spec->parsedValidValues=g_new(MkdgValue, spec->validValueCount);
+    spec->validValueIndex=g_hash_table_new(mkdg_value_hash, mkdg_value_equal);
+    for(i=0;i<spec->validValueCount;i++){
+	MkdgValue *mValue=&spec->parsedValidValues[i];
+	mkdg_value_init(mValue, spec->valueType);
+	mkdg_value_codec_from_string(&spec->codec, mValue, spec->validValues[i]);
+	/* First one wins on duplication */
+	if (!g_hash_table_lookup(spec->validValueIndex, mValue)){
+	    g_hash_table_insert(spec->validValueIndex, mValue, GINT_TO_POINTER(i+1));
+	}
+    }
+}
+
+/*
+ * Parse the default value.
+ * For fixed set, use the first valid value if the default is not valid.
+ * Valid values of flags name the bits, so the default is parsed as is.
+ */
+static void mkdg_property_spec_compile_default(MkdgPropertySpec *spec){
+    MkdgValue *mValue=&spec->parsedDefault;
+    if (spec->valueType==MKDG_TYPE_FLAGS){
+	mkdg_value_codec_from_string(&spec->codec, mValue, spec->defaultValue);
+    }else if (spec->defaultValue){
+	mkdg_value_codec_from_string(&spec->codec, mValue, spec->defaultValue);
+	if (spec->validValueCount>0 && (spec->flags & MKDG_PROPERTY_FLAG_FIXED_SET)
+		&& mkdg_property_spec_find_valid_value(spec, mValue)<0){
+	    mkdg_value_copy(&spec->parsedValidValues[0], mValue);
+	}
+    }else if (spec->validValueCount>0){
+	mkdg_value_copy(&spec->parsedValidValues[0], mValue);
+    }else{
+	mkdg_value_codec_from_string(&spec->codec, mValue, NULL);
+    }
+}
+
+void mkdg_property_spec_compile(MkdgPropertySpec *spec){
+    if (spec->codec.compiled){
+	/* Drop the values parsed with old settings */
+	mkdg_property_spec_clear_parsed(spec);
+    }
+    if (spec->valueType==MKDG_TYPE_STRING && spec->validValues
+	    && (spec->flags & MKDG_PROPERTY_FLAG_ENUM)){
+	spec->valueType=MKDG_TYPE_ENUM;
+    }
+    if (spec->valueType==MKDG_TYPE_ENUM){
+	/* Only indices of validValues can be stored. */
+	spec->flags |= MKDG_PROPERTY_FLAG_FIXED_SET;
+    }
+    mkdg_value_codec_init(&spec->codec, spec->valueType,
+	    spec->parseOption, spec->toStringFormat, spec->compareOption);
+    if (spec->toStringFormat && !spec->codec.toStringFormat){
+	g_warning("mkdg_property_spec_compile(%s): toStringFormat \"%s\" does not suit type %s, use default format instead.",
+		spec->key, spec->toStringFormat, mkdg_type_to_string(spec->valueType));
+    }
+    if (spec->valueType==MKDG_TYPE_ENUM || spec->valueType==MKDG_TYPE_FLAGS){
+	mkdg_value_codec_set_valid_values(&spec->codec, spec->validValues);
+    }
+    if (mkdg_value_init(&spec->parsedDefault, spec->valueType)){
+	mkdg_property_spec_compile_valid_values(spec);
+	mkdg_property_spec_compile_default(spec);
+    }else{
+	spec->parsedDefault.mType=MKDG_TYPE_NONE;
+	spec->parsedDefault.flags=0;
+    }
+}
+
+/*
+ * Replace *strPtr with its interned copy.
+ */
+static void md_spec_string_intern(const gchar **strPtr, gboolean canFree){
+    if (*strPtr==NULL)
+	return;
+    const gchar *iStr=g_intern_string(*strPtr);
+    if (canFree)
+	g_free((gchar *) *strPtr);
+    *strPtr=iStr;
+}
+
+void mkdg_property_spec_intern(MkdgPropertySpec *spec){
+    if (spec->flags & MKDG_PROPERTY_FLAG_INTERN_STRINGS)
+	return;
+    gboolean canFree=(spec->flags & MKDG_PROPERTY_FLAG_CAN_FREE) ? TRUE : FALSE;
+    md_spec_string_intern(&spec->key, canFree);
+    md_spec_string_intern(&spec->defaultValue, canFree);
+    md_spec_string_intern(&spec->parseOption, canFree);
+    md_spec_string_intern(&spec->toStringFormat, canFree);
+    md_spec_string_intern(&spec->compareOption, canFree);
+    md_spec_string_intern(&spec->pageName, canFree);
+    md_spec_string_intern(&spec->groupName, canFree);
+    md_spec_string_intern(&spec->label, canFree);
+    md_spec_string_intern(&spec->translationContext, canFree);
+    md_spec_string_intern(&spec->tooltip, canFree);
+    if (spec->validValues){
+	gint i;
+	for(i=0; spec->validValues[i]!=NULL; i++){
+	    md_spec_string_intern((const gchar **) &spec->validValues[i], canFree);
+	}
+    }
+    spec->flags |= MKDG_PROPERTY_FLAG_INTERN_STRINGS;
+    /* Codec refers to the options. */
+    mkdg_property_spec_compile(spec);
+}
+
+const MkdgValueCodec *mkdg_property_spec_get_codec(MkdgPropertySpec *spec){
+    if (G_UNLIKELY(!spec->codec.compiled))
+	mkdg_property_spec_compile(spec);
+    return &spec->codec;
+}
+
+const MkdgValue *mkdg_property_spec_get_default_value(MkdgPropertySpec *spec){
+    if (G_UNLIKELY(!spec->codec.compiled))
+	mkdg_property_spec_compile(spec);
+    return &spec->parsedDefault;
+}
+
+const MkdgValue *mkdg_property_spec_get_valid_value(MkdgPropertySpec *spec, gint index){
+    if (G_UNLIKELY(!spec->codec.compiled))
+	mkdg_property_spec_compile(spec);
+    if (index<0 || index>=spec->validValueCount)
+	return NULL;
+    return &spec->parsedValidValues[index];
+}
+
+gint mkdg_property_spec_find_valid_value(MkdgPropertySpec *spec, MkdgValue *mValue){
+    const MkdgValueCodec *codec=mkdg_property_spec_get_codec(spec);
+    if (!spec->validValueIndex)
+	return -1;
+    if (mValue->mType==MKDG_TYPE_ENUM){
+	/* Value is the index already */
+	gint index=mkdg_value_get_enum(mValue);
+	return (index>=0 && index<spec->validValueCount) ? index : -1;
+    }
+    if (!(codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE)){
+	return GPOINTER_TO_INT(g_hash_table_lookup(spec->validValueIndex, mValue))-1;
+    }
+    gint i;
+    for(i=0;i<spec->validValueCount;i++){
+	if (mkdg_value_codec_equal(codec, &spec->parsedValidValues[i], mValue))
+	    return i;
+    }
+    return -1;
+}
+
+gboolean mkdg_property_spec_in_range(MkdgPropertySpec *spec, MkdgValue *mValue){
+    if (!(spec->min < spec->max))
+	return TRUE;
+    if (mValue->mType==MKDG_TYPE_INT_ARRAY || mValue->mType==MKDG_TYPE_DOUBLE_ARRAY){
+	return mkdg_number_array_in_range(mkdg_value_get_number_array(mValue), spec->min, spec->max);
+    }
+    if (!mkdg_type_is_number(mValue->mType))
+	return TRUE;
+    gdouble d=mkdg_value_to_double(mValue);
+    return (d>=spec->min && d<=spec->max) ? TRUE : FALSE;
+}
+
 MkdgPropertyContext *mkdg_property_context_new(
 	MkdgPropertySpec *spec,gpointer userData){
     return mkdg_property_context_new_full(spec, userData, NULL, NULL);
@@ -130,16 +319,24 @@ MkdgPropertyContext *mkdg_property_context_new_full(
 	ctx->spec=spec;
 	ctx->userData=userData;
 	ctx->valueIndex=-1;
+	if (G_UNLIKELY(!spec->codec.compiled)){
+	    /* Value type may be changed by compiling */
+	    mkdg_property_spec_compile(spec);
+	}
 	ctx->value=mkdg_value_new(ctx->spec->valueType, NULL);
 	ctx->validateFunc=validateFunc;
 	ctx->applyFunc=applyFunc;
+	ctx->id=MKDG_PROPERTY_HANDLE_INVALID;
 	ctx->mDialog=NULL;
+	ctx->ruleTargets=NULL;
+	ctx->pageId=-1;
     }
     return ctx;
 }
 
 void mkdg_property_context_free(MkdgPropertyContext *ctx){
     mkdg_value_free(ctx->value);
+    g_free(ctx->ruleTargets);
     if (ctx->spec->flags & MKDG_PROPERTY_FLAG_CAN_FREE){
 	mkdg_property_spec_free(ctx->spec);
     }
@@ -151,12 +348,16 @@ static void  _mkdg_property_context_free_wrap(gpointer obj){
 }
 
 const gchar *mkdg_property_get_default_string(MkdgPropertySpec *spec){
+    if (spec->valueType==MKDG_TYPE_FLAGS){
+	/* Valid values are names of bits */
+	return spec->defaultValue;
+    }
     if (spec->defaultValue){
 	if (spec->validValues){
 	    if (spec->flags & MKDG_PROPERTY_FLAG_FIXED_SET){
-		gint index=-1;
 		/* Make sure default value is in valid values */
-		index=mkdg_find_string(spec->defaultValue, spec->validValues,-1);
+		gint index=mkdg_property_spec_find_valid_value(spec,
+			(MkdgValue *) mkdg_property_spec_get_default_value(spec));
 		if (index<0){
 		    /* Force to set on 1-st validValue */
 		    index=0;
@@ -181,77 +382,87 @@ const gchar *mkdg_property_get_default_string(MkdgPropertySpec *spec){
 }
 
 gboolean mkdg_property_is_default(MkdgPropertyContext *ctx){
-    MkdgValue *mValue=mkdg_property_get_default(ctx->spec);
-    gboolean result=(mkdg_value_compare(ctx->value, mValue, NULL)==0)? TRUE: FALSE;
-    mkdg_value_free(mValue);
-    return result;
+    MkdgValue *defValue=(MkdgValue *) mkdg_property_spec_get_default_value(ctx->spec);
+    if (defValue->mType!=ctx->spec->valueType)
+	return FALSE;
+    return mkdg_value_codec_equal(&ctx->spec->codec, ctx->value, defValue);
 }
 
 MkdgValue *mkdg_property_get_default(MkdgPropertySpec *spec){
+    MkdgValue *defValue=(MkdgValue *) mkdg_property_spec_get_default_value(spec);
     MkdgValue *mValue=mkdg_value_new(spec->valueType, NULL);
-    return mkdg_value_from_string(mValue, mkdg_property_get_default_string(spec), spec->parseOption);
+    if (mValue)
+	mkdg_value_copy(defValue, mValue);
+    return mValue;
 }
 
 gboolean mkdg_property_set_default(MkdgPropertyContext *ctx){
-    MkdgValue *mValue=mkdg_property_get_default(ctx->spec);
-    gboolean result=FALSE;
-    if (mValue){
-	mkdg_property_set_value_fast(ctx, mValue, -2);
-	result=TRUE;
-    }
-    mkdg_value_free(mValue);
-    return result;
+    MkdgValue *defValue=(MkdgValue *) mkdg_property_spec_get_default_value(ctx->spec);
+    if (defValue->mType!=ctx->spec->valueType)
+	return FALSE;
+    mkdg_property_set_value_fast(ctx, defValue, -2);
+    return TRUE;
 }
 
 static void mkdg_property_context_update_index(MkdgPropertyContext *ctx){
-    gint i;
-    MkdgValue *mValue=mkdg_value_new(ctx->spec->valueType, NULL);
-    for (i=0;ctx->spec->validValues[i]!=NULL;i++){
-	mkdg_value_from_string(mValue, ctx->spec->validValues[i], ctx->spec->parseOption);
-	if (mkdg_value_compare(ctx->value, mValue, NULL)==0){
-	    mkdg_value_free(mValue);
-	    ctx->valueIndex=i;
-	    return;
-	}
-    }
-    ctx->valueIndex=-1;
+    ctx->valueIndex=mkdg_property_spec_find_valid_value(ctx->spec, ctx->value);
 }
 
 void mkdg_property_set_value_fast(MkdgPropertyContext *ctx, MkdgValue *value, gint valueIndexCtl){
     mkdg_value_copy(value,ctx->value);
-    ctx->flags |= MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE | MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED;
+    ctx->flags |= MKDG_PROPERTY_CONTEXT_FLAG_HAS_VALUE | MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED
+	| MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED;
+    if (ctx->mDialog)
+	mkdg_mark_dirty(ctx->mDialog, ctx->id);
     if (ctx->spec->validValues && valueIndexCtl!=-3){
 	if (valueIndexCtl==-2){
 	    mkdg_property_context_update_index(ctx);
 	}else{
 	    ctx->valueIndex=valueIndexCtl;
 	}
+	if ((ctx->spec->flags & MKDG_PROPERTY_FLAG_INTERN_STRINGS) && ctx->value->mType==MKDG_TYPE_STRING
+		&& ctx->valueIndex>=0 && ctx->valueIndex<ctx->spec->validValueCount
+		&& strcmp(mkdg_value_get_string(ctx->value), ctx->spec->validValues[ctx->valueIndex])==0){
+	    /* Only share the already interned valid value; other strings would never be freed. */
+	    mkdg_value_intern(ctx->value);
+	}
     }
 }
 
 gboolean mkdg_property_from_string(MkdgPropertyContext *ctx, const gchar *str){
-    MkdgValue *mValue=mkdg_value_new(ctx->spec->valueType, NULL);
-    if ( mkdg_value_from_string(mValue, str, ctx->spec->parseOption)){
-	mkdg_property_set_value_fast(ctx, mValue, -2);
-	mkdg_value_free(mValue);
+    MkdgValue mValue;
+    if (!mkdg_value_init_static(&mValue, ctx->spec->valueType))
+	return FALSE;
+    if ( mkdg_value_codec_from_string(mkdg_property_spec_get_codec(ctx->spec), &mValue, str)
+	    && (mkdg_type_is_number(mValue.mType) || mkdg_property_spec_in_range(ctx->spec, &mValue))){
+	/* Arrays are parsed as a whole, so check the range of all elements here. */
+	mkdg_property_set_value_fast(ctx, &mValue, -2);
+	mkdg_value_clear(&mValue);
 	return TRUE;
     }
-    mkdg_value_free(mValue);
+    mkdg_value_clear(&mValue);
     return FALSE;
 }
 
 gchar *mkdg_property_to_string(MkdgPropertyContext *ctx){
-    gchar *str=mkdg_value_to_string(ctx->value, ctx->spec->toStringFormat);
+    gchar *str=mkdg_value_codec_to_string(mkdg_property_spec_get_codec(ctx->spec), ctx->value);
     return str;
 }
 
+gsize mkdg_property_format_into(MkdgPropertyContext *ctx, gchar *buf, gsize bufSize){
+    return mkdg_value_codec_format_into(mkdg_property_spec_get_codec(ctx->spec), ctx->value, buf, bufSize);
+}
+
 static gboolean mkdg_eval_control_rule(MkdgPropertyContext *ctx, MkdgControlRule *rule){
-    MkdgValue *mTestValue=mkdg_value_new(ctx->spec->valueType, NULL);
-    mkdg_value_from_string(mTestValue, rule->testValue, ctx->spec->parseOption);
+    MkdgValue mTestValue;
+    if (!mkdg_value_init_static(&mTestValue, ctx->spec->valueType))
+	return FALSE;
+    const MkdgValueCodec *codec=mkdg_property_spec_get_codec(ctx->spec);
+    mkdg_value_codec_from_string(codec, &mTestValue, rule->testValue);
 
     gint ret=0;
     gboolean result=FALSE;
-    ret=mkdg_value_compare(ctx->value, mTestValue, NULL);
+    ret=mkdg_value_codec_compare(codec, ctx->value, &mTestValue);
     switch(rule->relation){
 	case MKDG_RELATION_EQUAL:
 	    result=(ret==0)? TRUE: FALSE;
@@ -274,17 +485,33 @@ static gboolean mkdg_eval_control_rule(MkdgPropertyContext *ctx, MkdgControlRule
 	default:
 	    break;
     }
-    if (mTestValue)
-	mkdg_value_free(mTestValue);
+    mkdg_value_clear(&mTestValue);
     return result;
 }
 
+/* Target is resolved by key if ruleTargets is not prepared by mkdg_add_property(). */
+static MkdgPropertyContext *mkdg_control_rule_get_target(MkdgPropertyContext *ctx, MkdgControlRule *rule){
+    if (!ctx->ruleTargets)
+	return mkdg_get_property_context(ctx->mDialog, rule->key);
+    MkdgPropertyHandle *target=&ctx->ruleTargets[rule - ctx->spec->rules];
+    if (*target==MKDG_PROPERTY_HANDLE_INVALID){
+	/* Target may be added later, so only found one is kept */
+	*target=mkdg_property_handle(ctx->mDialog, rule->key);
+    }
+    return mkdg_get_property_context_by_handle(ctx->mDialog, *target);
+}
+
 void mkdg_property_foreach_control_rule(MkdgPropertyContext *ctx, MkdgPropertyEachControlRule func, gpointer userData){
     if (ctx->spec->rules){
 	MkdgControlRule *rule=ctx->spec->rules;
 	while (rule->key!=NULL){
+	    MkdgPropertyContext *refCtx=mkdg_control_rule_get_target(ctx, rule);
+	    if (!refCtx){
+		MKDG_DEBUG_MSG(2, "[I2] foreach_control_rule(%s, , ) unknown target %s", ctx->spec->key, rule->key);
+		rule++;
+		continue;
+	    }
 	    gboolean ret=mkdg_eval_control_rule(ctx, rule);
-	    MkdgPropertyContext *refCtx=mkdg_get_property_context(ctx->mDialog, rule->key);
 	    MkdgWidgetControl control=MKDG_WIDGET_CONTROL_NOTHING;
 	    if (ret && rule->match){
 		func(refCtx, rule->match, userData);
@@ -313,7 +540,8 @@ MkdgPropertyTable* mkdg_property_table_new(){
 }
 
 void mkdg_property_table_insert(MkdgPropertyTable *hTable, const MkdgPropertyContext *ctx){
-    g_hash_table_insert(hTable, (gpointer) ctx->spec->key, (gpointer) ctx);
+    /* Replace the key as well, as it belongs to the old context */
+    g_hash_table_replace(hTable, (gpointer) ctx->spec->key, (gpointer) ctx);
 }
 
 MkdgPropertyContext *mkdg_property_table_lookup(MkdgPropertyTable *hTable, const gchar *key){
@@ -329,8 +557,221 @@ void mkdg_property_table_destroy (MkdgPropertyTable *hTable){
     g_hash_table_destroy(hTable);
 }
 
+/*=== Start property index ===*/
+/*
+ * Hash and displace, as the color name table from gen-color-table.py,
+ * but built at run time with as many slots as keys.
+ *
+ * A key with hash h falls into bucket (h>>32) & bucketMask,
+ * and is placed at slot mix(h, d) % slotCount,
+ * where d is the displacement of its bucket.
+ * Displacements are searched for larger buckets first,
+ * while most slots are still free.
+ */
+#define MD_INDEX_KEYS_PER_BUCKET	4
+#define MD_INDEX_SEED_TRIES		8
+#define MD_INDEX_DISP_TRIES_PER_SLOT	64
+#define MD_KEY_HASH_K1			G_GINT64_CONSTANT(0x9E3779B97F4A7C15U)
+#define MD_KEY_HASH_K2			G_GINT64_CONSTANT(0xBF58476D1CE4E5B9U)
+#define MD_KEY_HASH_K3			G_GINT64_CONSTANT(0x94D049BB133111EBU)
+
+typedef struct{
+    guint32		hash;	/* Low 32 bits of key hash */
+    guint32		keyLen;
+    const gchar		*key;
+    MkdgPropertyHandle	id;
+} MdIndexEntry;
+
+struct _MkdgPropertyIndex{
+    guint64		seed;
+    guint32		slotCount;
+    guint32		bucketMask;
+    guint32		*disps;
+    MdIndexEntry	*entries;
+};
+
+/* Multiply-mix 8 bytes at a time, as wyhash does, with a splitmix64 finalizer. */
+static guint64 md_key_hash(const gchar *key, gsize len, guint64 seed){
+    guint64 h=seed ^ (len * MD_KEY_HASH_K1);
+    guint64 w;
+    for(;len>=8;key+=8, len-=8){
+	memcpy(&w, key, 8);
+	h^=w * MD_KEY_HASH_K2;
+	h=((h<<31) | (h>>33)) * MD_KEY_HASH_K3;
+    }
+    w=0;
+    memcpy(&w, key, len);
+    h^=w * MD_KEY_HASH_K2;
+    h^=h>>30;
+    h*=MD_KEY_HASH_K2;
+    h^=h>>27;
+    h*=MD_KEY_HASH_K3;
+    h^=h>>31;
+    return h;
+}
+
+static guint32 md_index_bucket(const MkdgPropertyIndex *index, guint64 h){
+    return (guint32) (h>>32) & index->bucketMask;
+}
+
+static guint32 md_index_slot(const MkdgPropertyIndex *index, guint64 h, guint32 disp){
+    guint64 x=h + disp * MD_KEY_HASH_K1;
+    x^=x>>32;
+    x*=MD_KEY_HASH_K2;
+    x^=x>>29;
+    return (guint32) (x % index->slotCount);
+}
+
+/* Returns 0 if placed; 1 if keys of the bucket always collide; -1 if displacement is not found. */
+static gint md_index_place_bucket(MkdgPropertyIndex *index, guint64 *hashes,
+	guint *members, guint size, guint8 *used, guint32 *slots){
+    guint i,j;
+    for(i=0;i<size;i++){
+	for(j=0;j<i;j++){
+	    if (hashes[members[i]]==hashes[members[j]])
+		return 1;
+	}
+    }
+    guint32 disp, dispMax=MAX(index->slotCount, 16) * MD_INDEX_DISP_TRIES_PER_SLOT;
+    for(disp=0;disp<dispMax;disp++){
+	for(i=0;i<size;i++){
+	    slots[i]=md_index_slot(index, hashes[members[i]], disp);
+	    if (used[slots[i]])
+		break;
+	    for(j=0;j<i;j++){
+		if (slots[j]==slots[i])
+		    break;
+	    }
+	    if (j<i)
+		break;
+	}
+	if (i==size){
+	    for(i=0;i<size;i++){
+		used[slots[i]]=1;
+	    }
+	    index->disps[md_index_bucket(index, hashes[members[0]])]=disp;
+	    return 0;
+	}
+    }
+    return -1;
+}
+
+/* Returns 0 if built; 1 if some keys are duplicated; -1 if another seed should be tried. */
+static gint md_index_build(MkdgPropertyIndex *index, MkdgPropertyContext **ctxs, guint count){
+    guint bucketCount=index->bucketMask+1;
+    guint64 *hashes=g_new(guint64, count);
+    guint *bucketStart=g_new0(guint, bucketCount+1);
+    guint *members=g_new(guint, count);
+    guint8 *used=g_new0(guint8, count);
+    guint32 *slots=NULL;
+    guint i, size, maxSize=0;
+    gint ret=0;
+
+    /* Group keys by bucket */
+    for(i=0;i<count;i++){
+	hashes[i]=md_key_hash(ctxs[i]->spec->key, strlen(ctxs[i]->spec->key), index->seed);
+	bucketStart[md_index_bucket(index, hashes[i])+1]++;
+    }
+    for(i=0;i<bucketCount;i++){
+	maxSize=MAX(maxSize, bucketStart[i+1]);
+	bucketStart[i+1]+=bucketStart[i];
+    }
+    guint *fill=g_memdup(bucketStart, sizeof(guint)*bucketCount);
+    for(i=0;i<count;i++){
+	members[fill[md_index_bucket(index, hashes[i])]++]=i;
+    }
+    g_free(fill);
+
+    slots=g_new(guint32, maxSize);
+    memset(index->disps, 0, sizeof(guint32)*bucketCount);
+    for(size=maxSize;size>0 && ret==0;size--){
+	for(i=0;i<bucketCount && ret==0;i++){
+	    if (bucketStart[i+1]-bucketStart[i]!=size)
+		continue;
+	    ret=md_index_place_bucket(index, hashes, members+bucketStart[i], size, used, slots);
+	    if (ret>0){
+		/* Same hash, either the same key or a rare collision */
+		guint *m=members+bucketStart[i];
+		guint j,k;
+		ret=-1;
+		for(j=0;j<size;j++){
+		    for(k=0;k<j;k++){
+			if (strcmp(ctxs[m[j]]->spec->key, ctxs[m[k]]->spec->key)==0)
+			    ret=1;
+		    }
+		}
+	    }
+	}
+    }
+
+    if (ret==0){
+	for(i=0;i<count;i++){
+	    guint32 b=md_index_bucket(index, hashes[i]);
+	    MdIndexEntry *entry=&index->entries[md_index_slot(index, hashes[i], index->disps[b])];
+	    entry->hash=(guint32) hashes[i];
+	    entry->key=ctxs[i]->spec->key;
+	    entry->keyLen=strlen(entry->key);
+	    entry->id=i;
+	}
+    }
+    g_free(slots);
+    g_free(used);
+    g_free(members);
+    g_free(bucketStart);
+    g_free(hashes);
+    return ret;
+}
+
+MkdgPropertyIndex *mkdg_property_index_new(MkdgPropertyContext **ctxs, guint count){
+    MkdgPropertyIndex *index=g_new0(MkdgPropertyIndex, 1);
+    guint bucketCount=1;
+    while(bucketCount*MD_INDEX_KEYS_PER_BUCKET<count){
+	bucketCount<<=1;
+    }
+    index->slotCount=count;
+    index->bucketMask=bucketCount-1;
+    index->disps=g_new0(guint32, bucketCount);
+    index->entries=g_new0(MdIndexEntry, MAX(count, 1));
+    if (count==0)
+	return index;
+    gint i, ret=-1;
+    for(i=0;i<MD_INDEX_SEED_TRIES && ret<0;i++){
+	index->seed=MD_KEY_HASH_K1 * (i+1);
+	ret=md_index_build(index, ctxs, count);
+    }
+    MKDG_DEBUG_MSG(3, "[I3] property_index_new( , %u) %s after %d seeds", count,
+	    (ret==0) ? "built" : "failed", i);
+    if (ret!=0){
+	mkdg_property_index_free(index);
+	return NULL;
+    }
+    return index;
+}
+
+MkdgPropertyHandle mkdg_property_index_lookup(const MkdgPropertyIndex *index, const gchar *key){
+    if (index->slotCount==0)
+	return MKDG_PROPERTY_HANDLE_INVALID;
+    gsize len=strlen(key);
+    guint64 h=md_key_hash(key, len, index->seed);
+    const MdIndexEntry *entry=&index->entries[md_index_slot(index, h, index->disps[md_index_bucket(index, h)])];
+    if (entry->hash==(guint32) h && entry->keyLen==len && memcmp(entry->key, key, len)==0)
+	return entry->id;
+    return MKDG_PROPERTY_HANDLE_INVALID;
+}
+
+void mkdg_property_index_free(MkdgPropertyIndex *index){
+    g_free(index->entries);
+    g_free(index->disps);
+    g_free(index);
+}
+/*=== End property index ===*/
+
 void mkdg_foreach_property(Mkdg* mDialog, GHFunc func, gpointer userData){
-    g_hash_table_foreach(mDialog->propertyTable, func, userData);
+    guint i;
+    for(i=0;i<mDialog->propertyArray->len;i++){
+	MkdgPropertyContext *ctx=(MkdgPropertyContext *) g_ptr_array_index(mDialog->propertyArray, i);
+	func((gpointer) ctx->spec->key, ctx, userData);
+    }
 }
 
 /*=== Start enumeration and flags ===*/
@@ -357,6 +798,7 @@ MkdgRelation mkdg_relation_parse(const gchar *str){
 static MkdgIdPair mkdgSpecFlagData[]={
     {"FIXED_SET",		MKDG_PROPERTY_FLAG_FIXED_SET},
     {"PREFER_RADIO_BUTTONS",	MKDG_PROPERTY_FLAG_PREFER_RADIO_BUTTONS},
+    {"ENUM",			MKDG_PROPERTY_FLAG_ENUM},
     {NULL,			0},
 };
 
@@ -72,6 +72,25 @@ typedef enum {
     MKDG_PROPERTY_FLAG_CAN_FREE    		=0x100,
     MKDG_PROPERTY_FLAG_FIXED_SET 		=0x200, //!< The property choose only among predefined valid values.
     MKDG_PROPERTY_FLAG_PREFER_RADIO_BUTTONS 	=0x400, //!< Use radio buttons if possible. Need to set ::MKDG_PROPERTY_FLAG_FIXED_SET as well.
+    /**
+     * String fields of the property spec, and string values of the property that equal one of its valid values, are interned.
+     *
+     * This flag is set by mkdg_property_spec_intern().
+     * Interned strings are shared and are not freed by mkdg_property_spec_free().
+     * @since 0.3
+     */
+    MKDG_PROPERTY_FLAG_INTERN_STRINGS 	=0x800,
+    /**
+     * Store the value of a fixed-set string property as #MKDG_TYPE_ENUM.
+     *
+     * A #MKDG_TYPE_STRING property that has \a validValues is converted to
+     * #MKDG_TYPE_ENUM when the spec is compiled, so its value is an index of \a validValues,
+     * and comparing it does not compare strings.
+     * The string representation, thus the stored configuration, does not change.
+     * ::MKDG_PROPERTY_FLAG_FIXED_SET is implied.
+     * @since 0.3
+     */
+    MKDG_PROPERTY_FLAG_ENUM 		=0x1000,
 } MKDG_PROPERTY_FLAG;
 
 /**
@@ -139,7 +158,7 @@ typedef struct _MkdgPropertySpec{
     MkdgType valueType;			//!< Data type of the property value.
     MkdgPropertyFlags flags; 	//!< Flags for a configuration property.
     const gchar *defaultValue;		//!< Default value represent in string. Can be \c NULL.
-    gchar **validValues;		//!< Valid values represent in strings. Can be \c NULL.
+    gchar **validValues;		//!< Valid values represent in strings, or names of bits for #MKDG_TYPE_FLAGS. Can be \c NULL.
     /**
      * Option for parsing \a defaultValue and \a validValues.
      * For example "8" can be passed as base for integer property. \c NULL for using default (intuitive) parse.
@@ -163,6 +182,40 @@ typedef struct _MkdgPropertySpec{
     MkdgControlRule *rules;	//!< Rules that involved with other
 
     gpointer userData;			//!< For storing custom data structure. Can be \c NULL.
+
+    /**
+     * Compiled \a parseOption, \a toStringFormat and \a compareOption.
+     * Access it with mkdg_property_spec_get_codec().
+     * @since 0.3
+     */
+    MkdgValueCodec codec;
+
+    /**
+     * Default value parsed from mkdg_property_get_default_string() along with \a codec.
+     * Access it with mkdg_property_spec_get_default_value().
+     * @since 0.3
+     */
+    MkdgValue parsedDefault;
+
+    /**
+     * \a validValues parsed along with \a codec.
+     * Access it with mkdg_property_spec_get_valid_value().
+     * @since 0.3
+     */
+    MkdgValue *parsedValidValues;
+
+    /**
+     * Number of \a validValues; or 0 if \a validValues is \c NULL.
+     * @since 0.3
+     */
+    gint validValueCount;
+
+    /**
+     * Hash index from parsed valid values to their index in \a validValues.
+     * Look up with mkdg_property_spec_find_valid_value().
+     * @since 0.3
+     */
+    GHashTable *validValueIndex;
 } MkdgPropertySpec;
 
 /**
@@ -216,6 +269,28 @@ typedef enum{
  */
 typedef guint MkdgPropertyContextFlags;
 
+/**
+ * Handle of a property in a Mkdg.
+ *
+ * A handle is the dense id of a property context in a Mkdg,
+ * which is assigned by mkdg_add_property() from 0 in the order of addition.
+ *
+ * Resolve a key to a handle once with mkdg_property_handle(),
+ * then access the property with the *_by_handle() functions,
+ * which index an array instead of hashing the key.
+ * @since 0.3
+ */
+typedef gint MkdgPropertyHandle;
+
+/**
+ * Handle of no property.
+ *
+ * Handle of no property, such as the handle of an unknown key,
+ * or the id of a property context that is not added to a Mkdg.
+ * @since 0.3
+ */
+#define MKDG_PROPERTY_HANDLE_INVALID -1
+
 /**
  * A MkdgPropertyContext is a property context which associates property specification,
  * a value, and a referencing object.
@@ -232,8 +307,11 @@ struct _MkdgPropertyContext{
     MkdgValidateCallbackFunc 	validateFunc;	//!< Function to be called for value validation.
     MkdgApplyCallbackFunc 	applyFunc;	//!< Function to be called for applying value.
     MkdgPropertyContextFlags	flags;	//!< Property context flags.
+    MkdgPropertyHandle		id;	//!< Id in "parent" Mkdg. ::MKDG_PROPERTY_HANDLE_INVALID if not added.
     /// @cond
     Mkdg				*mDialog; //!< "Parent" Mkdg.
+    MkdgPropertyHandle		*ruleTargets; //!< Handles of control rule targets, resolved on first evaluation.
+    gint			pageId; //!< Position of page in "parent" Mkdg, for dirty page bits.
     /// @endcond
 };
 
@@ -246,6 +324,20 @@ struct _MkdgPropertyContext{
  */
 typedef GHashTable MkdgPropertyTable;
 
+/**
+ * A read-only index from property keys to handles.
+ *
+ * It is a minimal perfect hash table over a fixed set of keys:
+ * each key is hashed once and compared once, without chaining.
+ * Entries store the key length and part of the hash,
+ * so most mismatches are rejected without comparing strings.
+ *
+ * It is built by mkdg_freeze(), after which keys can no longer be added.
+ * @see mkdg_property_index_new()
+ * @since 0.3
+ */
+typedef struct _MkdgPropertyIndex MkdgPropertyIndex;
+
 /*=== Start Function Definition  ===*/
 /**
  * New a MkdgPropertySpec.
@@ -311,6 +403,126 @@ MkdgPropertySpec *mkdg_property_spec_new_full(const gchar *key,
  */
 void mkdg_property_spec_free(MkdgPropertySpec *spec);
 
+/**
+ * Compile the options of a MkdgPropertySpec.
+ *
+ * This function compiles \a parseOption, \a toStringFormat and \a compareOption
+ * of \a spec into its codec, see mkdg_value_codec_init().
+ * The default value and \a validValues are parsed and cached as well,
+ * see mkdg_property_spec_get_default_value() and mkdg_property_spec_find_valid_value().
+ *
+ * Specs are compiled by mkdg_property_spec_new_full(), and static specs
+ * are compiled on first use.
+ * Call this function again after changing \a valueType, \a flags,
+ * \a defaultValue, \a validValues or the options.
+ *
+ * A string spec with ::MKDG_PROPERTY_FLAG_ENUM and \a validValues
+ * is converted to #MKDG_TYPE_ENUM here.
+ * Enumeration specs always have ::MKDG_PROPERTY_FLAG_FIXED_SET.
+ * A \a toStringFormat that does not suit \a valueType is reported with a warning here.
+ *
+ * @param spec Property specification.
+ * @since 0.3
+ */
+void mkdg_property_spec_compile(MkdgPropertySpec *spec);
+
+/**
+ * Intern the strings of a MkdgPropertySpec.
+ *
+ * This function replaces the string fields of \a spec, including each of
+ * \a validValues, by their canonical copies from g_intern_string(),
+ * and sets ::MKDG_PROPERTY_FLAG_INTERN_STRINGS.
+ * If \a spec is freeable, the old copies are freed.
+ * Later on, string values of property contexts with this spec that equal one of
+ * \a validValues share the interned valid value.
+ * Other values are not interned, as interned strings are never freed.
+ *
+ * Specs loaded by many MakerDialog instances then share the same strings,
+ * and so do config buffer keys, which are always interned.
+ *
+ * Do not modify the string fields directly after calling this function,
+ * as the interned strings must not be freed.
+ * @param spec Property specification.
+ * @see mkdg_value_intern()
+ * @since 0.3
+ */
+void mkdg_property_spec_intern(MkdgPropertySpec *spec);
+
+/**
+ * Get the compiled codec of a MkdgPropertySpec.
+ *
+ * Get the compiled codec of a MkdgPropertySpec.
+ * The spec is compiled if it is not yet.
+ *
+ * @param spec Property specification.
+ * @return Codec of \a spec.
+ * @since 0.3
+ */
+const MkdgValueCodec *mkdg_property_spec_get_codec(MkdgPropertySpec *spec);
+
+/**
+ * Get the cached default value of a MkdgPropertySpec.
+ *
+ * Get the default value of a MkdgPropertySpec, which is parsed from
+ * mkdg_property_get_default_string() when the spec is compiled.
+ * The spec is compiled if it is not yet.
+ *
+ * The returned value belongs to \a spec and must not be modified.
+ * Copy it with mkdg_value_copy(), which shares strings instead of duplicating them.
+ * @param spec Property specification.
+ * @return The default value of \a spec.
+ * @see mkdg_property_spec_compile()
+ * @since 0.3
+ */
+const MkdgValue *mkdg_property_spec_get_default_value(MkdgPropertySpec *spec);
+
+/**
+ * Get a parsed valid value of a MkdgPropertySpec.
+ *
+ * Get the value parsed from \a validValues[\a index] when the spec is compiled.
+ * The spec is compiled if it is not yet.
+ *
+ * The returned value belongs to \a spec and must not be modified.
+ * @param spec Property specification.
+ * @param index Index of \a validValues.
+ * @return The parsed valid value; or \c NULL if \a index is out of range.
+ * @see mkdg_property_spec_find_valid_value()
+ * @since 0.3
+ */
+const MkdgValue *mkdg_property_spec_get_valid_value(MkdgPropertySpec *spec, gint index);
+
+/**
+ * Find a value in the valid values of a MkdgPropertySpec.
+ *
+ * Find a value in the parsed \a validValues of a MkdgPropertySpec,
+ * with the compare option of \a spec.
+ * The hash index built by mkdg_property_spec_compile() is used,
+ * unless the compare option is case-insensitive.
+ * The spec is compiled if it is not yet.
+ * @param spec Property specification.
+ * @param mValue Value to be found.
+ * @return Index of the first equal value in \a validValues; or -1 if not found.
+ * @see mkdg_property_spec_get_valid_value()
+ * @since 0.3
+ */
+gint mkdg_property_spec_find_valid_value(MkdgPropertySpec *spec, MkdgValue *mValue);
+
+/**
+ * Whether a value is in the range of a MkdgPropertySpec.
+ *
+ * Whether a number is between \a min and \a max of \a spec, inclusively.
+ * For #MKDG_TYPE_INT_ARRAY and #MKDG_TYPE_DOUBLE_ARRAY, all elements
+ * are checked with mkdg_number_array_in_range().
+ *
+ * The range is not checked if \a min is not less than \a max,
+ * or \a mValue is not a number or number array.
+ * @param spec Property specification.
+ * @param mValue Value to be checked.
+ * @return \c TRUE if \a mValue is in range or the range is not checked; \c FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_property_spec_in_range(MkdgPropertySpec *spec, MkdgValue *mValue);
+
 /**
  * New a MkdgPropertyContext.
  *
@@ -375,6 +587,7 @@ gboolean mkdg_property_is_default(MkdgPropertyContext *ctx);
  * Specifically, this function returns:
  * # \a defaultValue, if:
  *   # \a defaultValue is in \a validValues  or ::MKDG_PROPERTY_FLAG_FIXED_SET is not set.
+ *     Values are compared after parsing, see mkdg_property_spec_find_valid_value().
  *   # or \a validValues does not exist.
  * # First value in \a validValues, if:
  *   # \a defaultValue is not in \a validValues and ::MKDG_PROPERTY_FLAG_FIXED_SET is set.
@@ -433,6 +646,8 @@ gboolean mkdg_property_set_default(MkdgPropertyContext *ctx);
  * Set value to property without validation and UI widget update.
  *
  * This function merely copies \a value to property context and updates property context flags.
+ * The property is marked as unsaved and unapplied,
+ * and as dirty in "parent" Mkdg, see mkdg_mark_dirty().
  * Parameter \a valueIndexCtl control the behaviors that how \a valueIndex should be updated:
  *  - if valueIndexCtl ==-3 or  \a validValues does not exists, the \a valueIndex will not be updated.
  *  - if valueIndexCtl ==-2, then \a valueIndex is updated by finding the value in \a validValues.
@@ -455,6 +670,8 @@ void mkdg_property_set_value_fast(MkdgPropertyContext *ctx, MkdgValue *value, gi
  * Set a property value from a string.
  *
  * Set a property value from a string.
+ * Number arrays out of the range of the spec are rejected,
+ * see mkdg_property_spec_in_range().
  * @param ctx 		A Mkdg property context.
  * @param str		The string to be parsed.
  * @return TRUE if succeed; FALSE if the string cannot be parsed.
@@ -484,6 +701,21 @@ gboolean mkdg_property_from_string(MkdgPropertyContext *ctx, const gchar *str);
  */
 gchar *mkdg_property_to_string(MkdgPropertyContext *ctx);
 
+/**
+ * Output a property value to a caller-provided buffer.
+ *
+ * Output a property value to a caller-provided buffer, without allocation.
+ * The output is truncated if it does not fit in \a bufSize.
+ * @param ctx 		A Mkdg property context.
+ * @param buf		Buffer to write to.
+ * @param bufSize	Size of \a buf, including the terminating '\\0'.
+ * @return Length of the full output, excluding the terminating '\\0'.
+ * @see mkdg_property_to_string()
+ * @see mkdg_value_format_into()
+ * @since 0.3
+ */
+gsize mkdg_property_format_into(MkdgPropertyContext *ctx, gchar *buf, gsize bufSize);
+
 /**
  * Prototype of callback function for each control rule in a property.
  *
@@ -553,14 +785,51 @@ MkdgValue *mkdg_property_table_lookup_value(MkdgPropertyTable *hTable, const gch
  */
 void mkdg_property_table_destroy (MkdgPropertyTable *hTable);
 
+/**
+ * New a property index.
+ *
+ * New a property index of \a ctxs, which maps the key of \a ctxs[i]
+ * to handle \a i.
+ * Keys are referenced, not copied, so \a ctxs must outlive the index.
+ *
+ * @param ctxs	Property contexts.
+ * @param count	Number of property contexts.
+ * @return A newly allocated MkdgPropertyIndex; or \c NULL if keys are duplicated.
+ * @see mkdg_freeze()
+ * @since 0.3
+ */
+MkdgPropertyIndex *mkdg_property_index_new(MkdgPropertyContext **ctxs, guint count);
+
+/**
+ * Lookup the property handle by key.
+ *
+ * Lookup the property handle by key.
+ *
+ * @param index	A MkdgPropertyIndex.
+ * @param key	Key of property context.
+ * @return Corresponding handle; or ::MKDG_PROPERTY_HANDLE_INVALID if no such key.
+ * @since 0.3
+ */
+MkdgPropertyHandle mkdg_property_index_lookup(const MkdgPropertyIndex *index, const gchar *key);
+
+/**
+ * Free a property index.
+ *
+ * Free a property index. Property contexts are not affected.
+ *
+ * @param index	A MkdgPropertyIndex.
+ * @since 0.3
+ */
+void mkdg_property_index_free(MkdgPropertyIndex *index);
+
 /**
  * Call callback for each property.
  *
  * Calls the given function for each property.
  * The function is passed the key and value of each pair, and the given user_data parameter.
- * The hash table may not be modified while iterating over it (you can't add/remove items).
+ * Properties may not be added while iterating.
  *
- * This function does not guarantee the order of keys and pages.
+ * Properties are visited in the order of their ids, that is, the order of addition.
  * Use mkdg_foreach_page_foreach_property() for ordered pages and keys.
  *
  * @param mDialog 	A Mkdg.
@@ -325,21 +325,26 @@ END_WIDGET_CONTROL_RULE:
 
 static void mkdg_set_flags(MkdgPropertySpec *spec, const gchar *attr, MkdgValue *mValue){
     spec->flags=mkdg_property_flags_parse(mkdg_value_get_string(mValue));
+    mkdg_property_spec_compile(spec);
 }
 
 static void mkdg_set_string(MkdgPropertySpec *spec, const gchar *attr, MkdgValue *mValue){
     if (g_ascii_strcasecmp(attr, "defaultValue")==0){
 	g_free((gchar *) spec->defaultValue);
 	spec->defaultValue=g_strdup(mkdg_value_get_string(mValue));
+	mkdg_property_spec_compile(spec);
     }else if (g_ascii_strcasecmp(attr, "parseOption")==0){
 	g_free((gchar *) spec->parseOption);
 	spec->parseOption=g_strdup(mkdg_value_get_string(mValue));
+	mkdg_property_spec_compile(spec);
     }else if (g_ascii_strcasecmp(attr, "toStringFormat")==0){
 	g_free((gchar *) spec->toStringFormat);
 	spec->toStringFormat=g_strdup(mkdg_value_get_string(mValue));
+	mkdg_property_spec_compile(spec);
     }else if (g_ascii_strcasecmp(attr, "compareOption")==0){
 	g_free((gchar *) spec->compareOption);
 	spec->compareOption=g_strdup(mkdg_value_get_string(mValue));
+	mkdg_property_spec_compile(spec);
     }else if (g_ascii_strcasecmp(attr, "pageName")==0){
 	g_free((gchar *) spec->pageName);
 	spec->pageName=g_strdup(mkdg_value_get_string(mValue));
@@ -377,6 +382,7 @@ static void mkdg_set_string_list(MkdgPropertySpec *spec, const gchar *attr, Mkdg
 	    g_strfreev(spec->validValues);
 	}
 	spec->validValues=strList;
+	mkdg_property_spec_compile(spec);
 	return;
     }else if (g_ascii_strcasecmp(attr, "imagePaths")==0){
 	if (spec->imagePaths){
@@ -481,6 +487,8 @@ static void mkdg_new_from_key_file_section_keys(Mkdg *mDialog, GKeyFile *keyFile
 	    setSpecData->func(spec, keyList[j], mValue);
 	    mkdg_value_free(mValue);
 	}
+	/* Instances that load the same spec file share the strings. */
+	mkdg_property_spec_intern(spec);
 	mkdg_add_property(mDialog, mkdg_property_context_new(spec, NULL));
 	g_strfreev(keyList);
     }
@@ -18,71 +18,253 @@
  *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
+#include <math.h>
 #include <glib/gprintf.h>
 #include "MakerDialogTypes.h"
 #include "MakerDialogUtil.h"
+#include "MakerDialogNumber.h"
 
 typedef struct _{
     const gchar *name;
     guint32	value;
 } MkdgColorInfo;
 
-MkdgColorInfo mkdgColorList[]={
-    {"Aqua",		0x00FFFF},
-    {"Aquamarine",	0x7FFFD4},
-    {"Azure",		0xF0FFFF},
-    {"Black",		0x000000},
-    {"Blue",		0x0000FF},
-    {"Brown",		0xA52A2A},
-    {"Chocolate",	0x7B3F00},
-    {"Crimson",		0xDC143C},
-    {"Coral",		0xFF7F50},
-    {"Cyan",		0x00FFFF},
-    {"Fuchsia",		0xFF00FF},
-    {"Gold",		0xFFD700},
-    {"Gray",		0x808080},
-    {"Green",		0x008000},
-    {"Ivory",		0xFFFFF0},
-    {"Lime",		0x00FF00},
-    {"Magenta",		0xFF00FF},
-    {"Maroon",		0x800000},
-    {"Navy",		0x000080},
-    {"Olive",		0x808000},
-    {"Orange",		0xFFA500},
-    {"Orchid",		0xDA70D6},
-    {"Pink",		0xFFC0CB},
-    {"Purple",		0x800080},
-    {"Red",		0xFF0000},
-    {"Sliver",		0xC0C0C0},
-    {"Teal",		0x008080},
-    {"Violet",		0xEE82EE},
-    {"Wheat",		0xF5DE83},
-    {"White",		0xFFFFFF},
-    {"Yellow",		0xFFFF00},
-    {NULL,		0}
-};
+#include "MakerDialogColorTable.h"
+
+/* Longer than any color name */
+#define MKDG_COLOR_NAME_LEN_MAX	32
 
+/* See gen-color-table.py for the hash functions */
 static gint find_color_index_by_name(const gchar *name){
-    gint i;
-    for(i=0;mkdgColorList[i].name!=NULL;i++){
-	if (g_ascii_strncasecmp(mkdgColorList[i].name,name,30)==0){
-	    return i;
-	}
+    guint64 h=G_GINT64_CONSTANT(0xCBF29CE484222325U);
+    const gchar *p;
+    for(p=name;*p!='\0';p++){
+	if (p-name>=MKDG_COLOR_NAME_LEN_MAX)
+	    return -1;
+	h^=(guchar) g_ascii_tolower(*p);
+	h*=G_GINT64_CONSTANT(0x100000001B3U);
+    }
+    guint32 d=mkdgColorNameDisp[(h>>32) % MKDG_COLOR_NAME_BUCKETS];
+    guint32 slot=((guint32) h + d * ((guint32) (h>>40) | 1)) % MKDG_COLOR_NAME_SLOTS;
+    gint index=mkdgColorNameSlots[slot];
+    if (index>=0 && g_ascii_strcasecmp(mkdgColorList[index].name, name)==0){
+	return index;
     }
     return -1;
 }
 
 static gint find_color_index_by_value(guint32 value){
-    gint i;
-    for(i=0;mkdgColorList[i].name!=NULL;i++){
-	if (mkdgColorList[i].value==value){
-	    return i;
+    guint32 slot=(value * 0x9E3779B1U) >> 24;
+    gint index;
+    while((index=mkdgColorValueSlots[slot])>=0){
+	if (mkdgColorList[index].value==value){
+	    return index;
 	}
+	slot=(slot+1) % MKDG_COLOR_VALUE_SLOTS;
     }
     return -1;
 }
 
+/*=== Start format functions ===*/
+/*
+ * Format functions write to buf like snprintf():
+ * return the full length, and truncate the output if it does not fit.
+ */
+static gsize md_format_copy(const gchar *str, gsize len, gchar *buf, gsize bufSize){
+    if (bufSize>0){
+	gsize n=(len<bufSize) ? len : bufSize-1;
+	memcpy(buf, str, n);
+	buf[n]='\0';
+    }
+    return len;
+}
+
+static gsize md_format_printf(gchar *buf, gsize bufSize, const gchar *format, ...){
+    va_list ap;
+    va_start(ap, format);
+    gint ret=g_vsnprintf(buf, bufSize, format, ap);
+    va_end(ap);
+    if (ret<0){
+	if (bufSize>0)
+	    buf[0]='\0';
+	return 0;
+    }
+    return (gsize) ret;
+}
+
+static gsize md_format_uint64_private(guint64 value, gboolean negative, gchar *buf, gsize bufSize){
+    gchar digits[24];
+    gchar *p=digits+sizeof(digits);
+    do{
+	*--p='0'+ (gchar) (value % 10);
+	value/=10;
+    }while(value);
+    if (negative)
+	*--p='-';
+    return md_format_copy(p, digits+sizeof(digits)-p, buf, bufSize);
+}
+
+static gsize md_format_uint64(guint64 value, gchar *buf, gsize bufSize){
+    return md_format_uint64_private(value, FALSE, buf, bufSize);
+}
+
+static gsize md_format_int64(gint64 value, gchar *buf, gsize bufSize){
+    if (value<0){
+	/* Negate in unsigned, so G_MININT64 works. */
+	return md_format_uint64_private(-(guint64) value, TRUE, buf, bufSize);
+    }
+    return md_format_uint64_private((guint64) value, FALSE, buf, bufSize);
+}
+/*
+ * Format with a validated toStringFormat of codec.
+ * The value is converted to the argument kind that the format expects.
+ */
+static gsize md_format_codec_int64(const MkdgValueCodec *codec, gint64 value, gchar *buf, gsize bufSize){
+    switch(codec->formatArg){
+	case MKDG_FORMAT_ARG_INT:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (gint) value);
+	case MKDG_FORMAT_ARG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (glong) value);
+	case MKDG_FORMAT_ARG_LONG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (long long) value);
+	case MKDG_FORMAT_ARG_DOUBLE:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (gdouble) value);
+	case MKDG_FORMAT_ARG_LONG_DOUBLE:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (long double) value);
+	default:
+	    break;
+    }
+    return md_format_int64(value, buf, bufSize);
+}
+
+static gsize md_format_codec_uint64(const MkdgValueCodec *codec, guint64 value, gchar *buf, gsize bufSize){
+    switch(codec->formatArg){
+	case MKDG_FORMAT_ARG_INT:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (guint) value);
+	case MKDG_FORMAT_ARG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (gulong) value);
+	case MKDG_FORMAT_ARG_LONG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (unsigned long long) value);
+	case MKDG_FORMAT_ARG_DOUBLE:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (gdouble) value);
+	case MKDG_FORMAT_ARG_LONG_DOUBLE:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (long double) value);
+	default:
+	    break;
+    }
+    return md_format_uint64(value, buf, bufSize);
+}
+
+static gsize md_format_codec_double(const MkdgValueCodec *codec, gdouble value, gchar *buf, gsize bufSize){
+    switch(codec->formatArg){
+	case MKDG_FORMAT_ARG_INT:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (gint) value);
+	case MKDG_FORMAT_ARG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (glong) value);
+	case MKDG_FORMAT_ARG_LONG_LONG:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (long long) value);
+	case MKDG_FORMAT_ARG_LONG_DOUBLE:
+	    return md_format_printf(buf, bufSize, codec->toStringFormat, (long double) value);
+	default:
+	    break;
+    }
+    return md_format_printf(buf, bufSize, codec->toStringFormat, value);
+}
+
+static gsize md_format_codec_string(const MkdgValueCodec *codec, const gchar *str, gsize len, gchar *buf, gsize bufSize){
+    if (codec->formatArg!=MKDG_FORMAT_ARG_STRING)
+	return md_format_copy(str, len, buf, bufSize);
+    return md_format_printf(buf, bufSize, codec->toStringFormat, str);
+}
+
+/*
+ * Find the argument kind of a printf() format that has exactly one conversion.
+ * '*' and '$' take extra arguments, thus are not allowed.
+ * Returns MKDG_FORMAT_ARG_NONE if format does not suit mType.
+ */
+static gint md_format_arg_parse(const gchar *format, MkdgType mType){
+    gint arg=MKDG_FORMAT_ARG_NONE;
+    const gchar *p=format;
+    while((p=strchr(p, '%'))!=NULL){
+	p++;
+	if (*p=='%'){
+	    p++;
+	    continue;
+	}
+	if (arg!=MKDG_FORMAT_ARG_NONE)
+	    return MKDG_FORMAT_ARG_NONE;
+	p+=strspn(p, "-+ #0'");
+	p+=strspn(p, "0123456789");
+	if (*p=='.'){
+	    p++;
+	    p+=strspn(p, "0123456789");
+	}
+	gint lengthMod=0;	/* 1 for long, 2 for long long, 3 for long double */
+	switch(*p){
+	    case 'h':
+		p+=(p[1]=='h') ? 2 : 1;
+		break;
+	    case 'l':
+		lengthMod=(p[1]=='l') ? 2 : 1;
+		p+=lengthMod;
+		break;
+	    case 'q':
+	    case 'j':
+		lengthMod=2;
+		p++;
+		break;
+	    case 'z':
+	    case 't':
+		lengthMod=1;
+		p++;
+		break;
+	    case 'L':
+		lengthMod=3;
+		p++;
+		break;
+	    default:
+		break;
+	}
+	if (*p=='\0'){
+	    return MKDG_FORMAT_ARG_NONE;
+	}else if (strchr("diouxXc", *p)){
+	    arg=(lengthMod==0) ? MKDG_FORMAT_ARG_INT :
+		(lengthMod==1) ? MKDG_FORMAT_ARG_LONG : MKDG_FORMAT_ARG_LONG_LONG;
+	}else if (strchr("eEfFgGaA", *p)){
+	    arg=(lengthMod==3) ? MKDG_FORMAT_ARG_LONG_DOUBLE : MKDG_FORMAT_ARG_DOUBLE;
+	}else if (*p=='s' && lengthMod==0){
+	    arg=MKDG_FORMAT_ARG_STRING;
+	}else{
+	    return MKDG_FORMAT_ARG_NONE;
+	}
+	p++;
+    }
+    switch(mType){
+	case MKDG_TYPE_STRING:
+	case MKDG_TYPE_COLOR:
+	case MKDG_TYPE_ENUM:
+	    return (arg==MKDG_FORMAT_ARG_STRING) ? arg : MKDG_FORMAT_ARG_NONE;
+	case MKDG_TYPE_BOOLEAN:
+	case MKDG_TYPE_STRING_LIST:
+	case MKDG_TYPE_FLAGS:
+	case MKDG_TYPE_BLOB:
+	case MKDG_TYPE_POINTER:
+	    return MKDG_FORMAT_ARG_NONE;
+	case MKDG_TYPE_INT_ARRAY:
+	case MKDG_TYPE_DOUBLE_ARRAY:
+	    /* Format of each element */
+	    return (arg==MKDG_FORMAT_ARG_STRING) ? MKDG_FORMAT_ARG_NONE : arg;
+	default:
+	    break;
+    }
+    if (mkdg_type_is_number(mType))
+	return (arg==MKDG_FORMAT_ARG_STRING) ? MKDG_FORMAT_ARG_NONE : arg;
+    return MKDG_FORMAT_ARG_NONE;
+}
+/*=== End format functions ===*/
+
 /*=== Start Type Interface functions ===*/
 typedef struct{
     MkdgType type;
@@ -100,7 +282,7 @@ static void md_pointer_set(MkdgValue *mValue, gpointer setValue){
     mkdg_value_set_pointer(mValue,setValue);
 }
 
-static gint md_pointer_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
+static gint md_pointer_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
     if (mValue2->mType!=MKDG_TYPE_POINTER){
 	return -3;
     }
@@ -111,6 +293,10 @@ static gint md_pointer_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gch
     }
     return -1;
 }
+
+static guint md_pointer_hash(MkdgValue *mValue){
+    return g_direct_hash(mkdg_value_get_pointer(mValue));
+}
 /*=== End pointer type ===*/
 /*=== Start boolean type ===*/
 static void md_boolean_extract(MkdgValue *mValue, gpointer ptr){
@@ -122,16 +308,16 @@ static void md_boolean_set(MkdgValue *mValue, gpointer setValue){
     mkdg_value_set_boolean(mValue, (setValue) ? *(gboolean *) setValue: FALSE);
 }
 
-static MkdgValue *md_boolean_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
+static MkdgValue *md_boolean_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
     mValue->data[0].v_boolean=mkdg_atob(str);
     return mValue;
 }
 
-static gchar *md_boolean_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    return g_strdup(mValue->data[0].v_boolean ? "TRUE" : "FALSE");
+static gsize md_boolean_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    return (mValue->data[0].v_boolean) ? md_format_copy("TRUE", 4, buf, bufSize) : md_format_copy("FALSE", 5, buf, bufSize);
 }
 
-static gint md_boolean_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
+static gint md_boolean_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
     if (mValue2->mType!=MKDG_TYPE_BOOLEAN){
 	return -3;
     }
@@ -146,38 +332,231 @@ static gint md_boolean_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gch
     return -1;
 }
 
+static guint md_boolean_hash(MkdgValue *mValue){
+    return (mValue->data[0].v_boolean) ? 1 : 0;
+}
 /*=== End boolean type ===*/
 /*=== Start number type ===*/
-static gint md_number_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
+/*
+ * Number compare kernels.
+ *
+ * A number is loaded in its natural representation: signed or unsigned 64-bit integer,
+ * or double. The kernel for the pair of representations is then picked from
+ * mdNumberCompareKernels, so integers are compared exactly, and no switch is needed.
+ */
+typedef enum{
+    MD_NUMBER_CLASS_SIGNED,
+    MD_NUMBER_CLASS_UNSIGNED,
+    MD_NUMBER_CLASS_FLOAT,
+    MD_NUMBER_CLASS_COUNT
+} MD_NUMBER_CLASS;
+
+typedef union{
+    gint64	v_int64;
+    guint64	v_uint64;
+    gdouble	v_double;
+} MdNumber;
+
+typedef void (* MdNumberLoadFunc)(MkdgValue *mValue, MdNumber *num);
+typedef gint (* MdNumberCompareFunc)(const MdNumber *num1, const MdNumber *num2);
+
+typedef struct{
+    MD_NUMBER_CLASS numClass;
+    MdNumberLoadFunc load;
+} MdNumberTypeInfo;
+
+#define MD_NUMBER_LOAD_FUNC(name, member, getter) \
+    static void md_number_load_##name(MkdgValue *mValue, MdNumber *num){ \
+	num->member=getter(mValue); \
+    }
+
+MD_NUMBER_LOAD_FUNC(int,	v_int64,	mkdg_value_get_int)
+MD_NUMBER_LOAD_FUNC(uint,	v_uint64,	mkdg_value_get_uint)
+MD_NUMBER_LOAD_FUNC(int32,	v_int64,	mkdg_value_get_int32)
+MD_NUMBER_LOAD_FUNC(uint32,	v_uint64,	mkdg_value_get_uint32)
+MD_NUMBER_LOAD_FUNC(int64,	v_int64,	mkdg_value_get_int64)
+MD_NUMBER_LOAD_FUNC(uint64,	v_uint64,	mkdg_value_get_uint64)
+MD_NUMBER_LOAD_FUNC(long,	v_int64,	mkdg_value_get_long)
+MD_NUMBER_LOAD_FUNC(ulong,	v_uint64,	mkdg_value_get_ulong)
+MD_NUMBER_LOAD_FUNC(float,	v_double,	mkdg_value_get_float)
+MD_NUMBER_LOAD_FUNC(double,	v_double,	mkdg_value_get_double)
+MD_NUMBER_LOAD_FUNC(color,	v_uint64,	mkdg_value_get_color)
+
+/* Indexed by MkdgType, NULL load for non-number types */
+static const MdNumberTypeInfo mdNumberTypeInfos[]={
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* POINTER */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* BOOLEAN */
+    {MD_NUMBER_CLASS_SIGNED,	md_number_load_int},
+    {MD_NUMBER_CLASS_UNSIGNED,	md_number_load_uint},
+    {MD_NUMBER_CLASS_SIGNED,	md_number_load_int32},
+    {MD_NUMBER_CLASS_UNSIGNED,	md_number_load_uint32},
+    {MD_NUMBER_CLASS_SIGNED,	md_number_load_int64},
+    {MD_NUMBER_CLASS_UNSIGNED,	md_number_load_uint64},
+    {MD_NUMBER_CLASS_SIGNED,	md_number_load_long},
+    {MD_NUMBER_CLASS_UNSIGNED,	md_number_load_ulong},
+    {MD_NUMBER_CLASS_FLOAT,	md_number_load_float},
+    {MD_NUMBER_CLASS_FLOAT,	md_number_load_double},
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* STRING */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* STRING_LIST */
+    {MD_NUMBER_CLASS_UNSIGNED,	md_number_load_color},
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* ENUM */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* FLAGS */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* INT_ARRAY */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* DOUBLE_ARRAY */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* BLOB */
+    {MD_NUMBER_CLASS_COUNT,	NULL},			/* NONE */
+};
+
+#define MD_NUMBER_CMP(v1, v2) (((v1)>(v2)) - ((v1)<(v2)))
+
+/* 2^63 and 2^64 are exact in double */
+#define MD_DOUBLE_2_POW_63	9223372036854775808.0
+#define MD_DOUBLE_2_POW_64	18446744073709551616.0
+
+static gint md_number_compare_signed_signed(const MdNumber *num1, const MdNumber *num2){
+    return MD_NUMBER_CMP(num1->v_int64, num2->v_int64);
+}
+
+static gint md_number_compare_unsigned_unsigned(const MdNumber *num1, const MdNumber *num2){
+    return MD_NUMBER_CMP(num1->v_uint64, num2->v_uint64);
+}
+
+static gint md_number_compare_signed_unsigned(const MdNumber *num1, const MdNumber *num2){
+    if (num1->v_int64<0)
+	return -1;
+    return MD_NUMBER_CMP((guint64) num1->v_int64, num2->v_uint64);
+}
+
+static gint md_number_compare_unsigned_signed(const MdNumber *num1, const MdNumber *num2){
+    return -md_number_compare_signed_unsigned(num2, num1);
+}
+
+/* NaN is neither equal nor greater, as the comparison of doubles */
+static gint md_number_compare_float_float(const MdNumber *num1, const MdNumber *num2){
+    if (num1->v_double==num2->v_double)
+	return 0;
+    return (num1->v_double>num2->v_double) ? 1 : -1;
+}
+
+/*
+ * Compare an integer with the integral part of a double first,
+ * then the fraction part decides.
+ * The integral part is exact in both gint64 and double when |d| < 2^63.
+ */
+static gint md_number_compare_signed_float(const MdNumber *num1, const MdNumber *num2){
+    gdouble d=num2->v_double;
+    if (isnan(d) || d>=MD_DOUBLE_2_POW_63)
+	return -1;
+    if (d< -MD_DOUBLE_2_POW_63)
+	return 1;
+    gint64 t=(gint64) d;
+    if (num1->v_int64!=t)
+	return MD_NUMBER_CMP(num1->v_int64, t);
+    return MD_NUMBER_CMP((gdouble) t, d);
+}
+
+static gint md_number_compare_unsigned_float(const MdNumber *num1, const MdNumber *num2){
+    gdouble d=num2->v_double;
+    if (isnan(d) || d>=MD_DOUBLE_2_POW_64)
+	return -1;
+    if (d<0.0)
+	return 1;
+    guint64 t=(guint64) d;
+    if (num1->v_uint64!=t)
+	return MD_NUMBER_CMP(num1->v_uint64, t);
+    return MD_NUMBER_CMP((gdouble) t, d);
+}
+
+static gint md_number_compare_float_signed(const MdNumber *num1, const MdNumber *num2){
+    if (isnan(num1->v_double))
+	return -1;
+    return -md_number_compare_signed_float(num2, num1);
+}
+
+static gint md_number_compare_float_unsigned(const MdNumber *num1, const MdNumber *num2){
+    if (isnan(num1->v_double))
+	return -1;
+    return -md_number_compare_unsigned_float(num2, num1);
+}
+
+static const MdNumberCompareFunc mdNumberCompareKernels[MD_NUMBER_CLASS_COUNT][MD_NUMBER_CLASS_COUNT]={
+    {md_number_compare_signed_signed,	md_number_compare_signed_unsigned,	md_number_compare_signed_float},
+    {md_number_compare_unsigned_signed,	md_number_compare_unsigned_unsigned,	md_number_compare_unsigned_float},
+    {md_number_compare_float_signed,	md_number_compare_float_unsigned,	md_number_compare_float_float},
+};
+
+static gint md_number_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
     if (!mkdg_type_is_number(mValue2->mType)){
 	return -3;
     }
-    gdouble val1=mkdg_value_to_double(mValue1);
-    gdouble val2=mkdg_value_to_double(mValue2);
-    if (val1==val2){
-	return 0;
+    const MdNumberTypeInfo *info1=&mdNumberTypeInfos[mValue1->mType];
+    const MdNumberTypeInfo *info2=&mdNumberTypeInfos[mValue2->mType];
+    MdNumber num1, num2;
+    info1->load(mValue1, &num1);
+    info2->load(mValue2, &num2);
+    return mdNumberCompareKernels[info1->numClass][info2->numClass](&num1, &num2);
+}
+
+static guint md_number_hash_bits(guint64 bits){
+    return (guint) (bits ^ (bits>>32));
+}
+
+/*
+ * Numbers that compare equal hash the same regardless of their types:
+ * integral doubles are hashed as integers, and signed integers
+ * hashed by their bits, which are the same as the unsigned one of same value.
+ */
+static guint md_number_hash(MkdgValue *mValue){
+    const MdNumberTypeInfo *info=&mdNumberTypeInfos[mValue->mType];
+    MdNumber num;
+    info->load(mValue, &num);
+    if (info->numClass!=MD_NUMBER_CLASS_FLOAT)
+	return md_number_hash_bits(num.v_uint64);
+    gdouble d=num.v_double;
+    if (d>= -MD_DOUBLE_2_POW_63 && d<MD_DOUBLE_2_POW_63 && d==(gdouble) (gint64) d){
+	/* Also turns -0.0 to 0 */
+	return md_number_hash_bits((guint64) (gint64) d);
     }
-    if (val1>val2){
-	return 1;
+    if (d>=0.0 && d<MD_DOUBLE_2_POW_64 && d==(gdouble) (guint64) d){
+	return md_number_hash_bits((guint64) d);
     }
-    return -1;
+    guint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return md_number_hash_bits(bits);
 }
 
-static gint determine_base(const gchar *str, const gchar *parseOption, gchar **startPtr){
-    gint base=10;
-    *startPtr=(gchar *) str;
-    if (parseOption){
-	base=atoi (parseOption);
-    }else{
-	if (strlen(str)>2 && str[0]=='0' && str[1]=='x'){
-	    base=16;
-	    *startPtr= (gchar *) str+2;
-	}else if (strlen(str)>2 && str[0]=='0' && str[1]!='.'){
-	    base=8;
-	    *startPtr= (gchar *) str+1;
-	}
+/*
+ * Clamp a parsed value to the range of a smaller type.
+ */
+static MkdgNumberStatus md_number_clamp_int64(MkdgNumberStatus status, gint64 *val, gint64 min, gint64 max){
+    if (*val<min){
+	*val=min;
+	return MKDG_NUMBER_OVERFLOW;
+    }
+    if (*val>max){
+	*val=max;
+	return MKDG_NUMBER_OVERFLOW;
     }
-    return base;
+    return status;
+}
+
+static MkdgNumberStatus md_number_clamp_uint64(MkdgNumberStatus status, guint64 *val, guint64 max){
+    if (*val>max){
+	*val=max;
+	return MKDG_NUMBER_OVERFLOW;
+    }
+    return status;
+}
+
+/*
+ * Empty string is 0, invalid or overflowed string returns NULL.
+ */
+static MkdgValue *md_number_result(MkdgValue *mValue, MkdgNumberStatus status, const gchar *str){
+    if (status==MKDG_NUMBER_OK || status==MKDG_NUMBER_EMPTY)
+	return mValue;
+    MKDG_DEBUG_MSG(2,"[I2] md_number_result(-, %d, %s) %s", status, str,
+	    (status==MKDG_NUMBER_OVERFLOW) ? "out of range" : "invalid number");
+    return NULL;
 }
 
 static void md_int_extract(MkdgValue *mValue, gpointer ptr){
@@ -189,24 +568,18 @@ static void md_int_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_int=(setValue) ? *(gint *) setValue: 0;
 }
 
-static MkdgValue *md_int_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_int(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	gint val=(gint) strtol(startPtr, NULL, base);
-	mkdg_value_set_int(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_int_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_int64(str, codec->base, &val);
+    status=md_number_clamp_int64(status, &val, G_MININT, G_MAXINT);
+    mkdg_value_set_int(mValue, (gint) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_int_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%d";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_int(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_int_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_int64(mkdg_value_get_int(mValue), buf, bufSize);
+    return md_format_codec_int64(codec, mkdg_value_get_int(mValue), buf, bufSize);
 }
 
 static void md_uint_extract(MkdgValue *mValue, gpointer ptr){
@@ -218,24 +591,18 @@ static void md_uint_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_uint=(setValue) ? *(guint *) setValue: 0;
 }
 
-static MkdgValue *md_uint_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_uint(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	guint val=(guint) strtol(startPtr, NULL, base);
-	mkdg_value_set_uint(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_uint_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    guint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_uint64(str, codec->base, &val);
+    status=md_number_clamp_uint64(status, &val, G_MAXUINT);
+    mkdg_value_set_uint(mValue, (guint) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_uint_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%u";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_uint(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_uint_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_uint64(mkdg_value_get_uint(mValue), buf, bufSize);
+    return md_format_codec_uint64(codec, mkdg_value_get_uint(mValue), buf, bufSize);
 }
 
 static void md_int32_extract(MkdgValue *mValue, gpointer ptr){
@@ -247,24 +614,18 @@ static void md_int32_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_int32=(setValue) ? *(gint32 *) setValue: 0;
 }
 
-static MkdgValue *md_int32_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_int32(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	gint32 val=(gint32) strtol(startPtr, NULL, base);
-	mkdg_value_set_int32(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_int32_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_int64(str, codec->base, &val);
+    status=md_number_clamp_int64(status, &val, G_MININT32, G_MAXINT32);
+    mkdg_value_set_int32(mValue, (gint32) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_int32_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%d";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_int32(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_int32_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_int64(mkdg_value_get_int32(mValue), buf, bufSize);
+    return md_format_codec_int64(codec, mkdg_value_get_int32(mValue), buf, bufSize);
 }
 
 static void md_uint32_extract(MkdgValue *mValue, gpointer ptr){
@@ -276,24 +637,18 @@ static void md_uint32_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_uint32=(setValue) ? *(guint32 *) setValue: 0;
 }
 
-static MkdgValue *md_uint32_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_uint32(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	guint32 val=(guint32) strtol(startPtr, NULL, base);
-	mkdg_value_set_uint32(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_uint32_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    guint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_uint64(str, codec->base, &val);
+    status=md_number_clamp_uint64(status, &val, G_MAXUINT32);
+    mkdg_value_set_uint32(mValue, (guint32) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_uint32_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%u";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_uint32(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_uint32_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_uint64(mkdg_value_get_uint32(mValue), buf, bufSize);
+    return md_format_codec_uint64(codec, mkdg_value_get_uint32(mValue), buf, bufSize);
 }
 
 static void md_int64_extract(MkdgValue *mValue, gpointer ptr){
@@ -305,24 +660,17 @@ static void md_int64_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_int64=(setValue) ? *(gint64 *) setValue: 0;
 }
 
-static MkdgValue *md_int64_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_int64(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	gint64 val=(gint64) strtol(startPtr, NULL, base);
-	mkdg_value_set_int64(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_int64_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_int64(str, codec->base, &val);
+    mkdg_value_set_int64(mValue, val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_int64_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%d";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_int64(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_int64_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_int64(mkdg_value_get_int64(mValue), buf, bufSize);
+    return md_format_codec_int64(codec, mkdg_value_get_int64(mValue), buf, bufSize);
 }
 
 static void md_uint64_extract(MkdgValue *mValue, gpointer ptr){
@@ -334,24 +682,17 @@ static void md_uint64_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_uint64=(setValue) ? *(guint64 *) setValue: 0;
 }
 
-static MkdgValue *md_uint64_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_uint64(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	guint64 val=(guint64) strtol(startPtr, NULL, base);
-	mkdg_value_set_uint64(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_uint64_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    guint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_uint64(str, codec->base, &val);
+    mkdg_value_set_uint64(mValue, val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_uint64_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%u";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_uint64(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_uint64_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_uint64(mkdg_value_get_uint64(mValue), buf, bufSize);
+    return md_format_codec_uint64(codec, mkdg_value_get_uint64(mValue), buf, bufSize);
 }
 
 static void md_long_extract(MkdgValue *mValue, gpointer ptr){
@@ -363,24 +704,18 @@ static void md_long_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_long=(setValue) ? *(glong *) setValue: 0;
 }
 
-static MkdgValue *md_long_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_long(mValue,0l);
-    }else{
-	gint base=determine_base(str,  parseOption, &startPtr);
-	glong val= strtol(startPtr, NULL, base);
-	mkdg_value_set_long(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_long_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_int64(str, codec->base, &val);
+    status=md_number_clamp_int64(status, &val, G_MINLONG, G_MAXLONG);
+    mkdg_value_set_long(mValue, (glong) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_long_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%ld";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_long(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_long_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_int64(mkdg_value_get_long(mValue), buf, bufSize);
+    return md_format_codec_int64(codec, mkdg_value_get_long(mValue), buf, bufSize);
 }
 
 static void md_ulong_extract(MkdgValue *mValue, gpointer ptr){
@@ -392,24 +727,18 @@ static void md_ulong_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_ulong=(setValue) ? *(gulong *) setValue: 0;
 }
 
-static MkdgValue *md_ulong_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *startPtr=NULL;
-    if (G_UNLIKELY(mkdg_string_is_empty(str))){
-	mkdg_value_set_ulong(mValue,0);
-    }else{
-	gint base=determine_base(str, parseOption, &startPtr);
-	gulong val= (gulong) strtoll(startPtr, NULL, base);
-	mkdg_value_set_ulong(mValue,val);
-    }
-    return mValue;
+static MkdgValue *md_ulong_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    guint64 val;
+    MkdgNumberStatus status=mkdg_number_parse_uint64(str, codec->base, &val);
+    status=md_number_clamp_uint64(status, &val, G_MAXULONG);
+    mkdg_value_set_ulong(mValue, (gulong) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_ulong_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%lu";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_ulong(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_ulong_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return md_format_uint64(mkdg_value_get_ulong(mValue), buf, bufSize);
+    return md_format_codec_uint64(codec, mkdg_value_get_ulong(mValue), buf, bufSize);
 }
 
 static void md_float_extract(MkdgValue *mValue, gpointer ptr){
@@ -421,18 +750,22 @@ static void md_float_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_float=(setValue) ? *(gfloat *) setValue: 0.0f;
 }
 
-static MkdgValue *md_float_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gfloat val= (G_UNLIKELY(mkdg_string_is_empty(str))) ? 0.0f: (gfloat) strtod(str, NULL);
-    mkdg_value_set_float(mValue,val);
-    return mValue;
+static MkdgValue *md_float_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gdouble val;
+    MkdgNumberStatus status=mkdg_number_parse_double(str, &val);
+    /* Check after rounding, the shortest form of G_MAXFLOAT is slightly above it */
+    if (status==MKDG_NUMBER_OK && !isinf(val) && isinf((gfloat) val)){
+	val=(val>0) ? G_MAXFLOAT : -G_MAXFLOAT;
+	status=MKDG_NUMBER_OVERFLOW;
+    }
+    mkdg_value_set_float(mValue, (gfloat) val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_float_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%g";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_float(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_float_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return mkdg_number_format_float(mkdg_value_get_float(mValue), buf, bufSize);
+    return md_format_codec_double(codec, mkdg_value_get_float(mValue), buf, bufSize);
 }
 
 static void md_double_extract(MkdgValue *mValue, gpointer ptr){
@@ -444,18 +777,17 @@ static void md_double_set(MkdgValue *mValue, gpointer setValue){
     mValue->data[0].v_double=(setValue) ? *(gdouble *) setValue: 0.0;
 }
 
-static MkdgValue *md_double_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gdouble val= (G_UNLIKELY(mkdg_string_is_empty(str))) ? 0.0 : (gdouble) strtod(str, NULL);
-    mkdg_value_set_double(mValue,val);
-    return mValue;
+static MkdgValue *md_double_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    gdouble val;
+    MkdgNumberStatus status=mkdg_number_parse_double(str, &val);
+    mkdg_value_set_double(mValue, val);
+    return md_number_result(mValue, status, str);
 }
 
-static gchar *md_double_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%g";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_double(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_double_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (!codec->toStringFormat)
+	return mkdg_number_format_double(mkdg_value_get_double(mValue), buf, bufSize);
+    return md_format_codec_double(codec, mkdg_value_get_double(mValue), buf, bufSize);
 }
 /*=== End number type ===*/
 /*=== Start string type ===*/
@@ -464,50 +796,85 @@ static void md_string_extract(MkdgValue *mValue, gpointer ptr){
     *ptr2=g_strdup(mkdg_value_get_string(mValue));
 }
 
+/*
+ * Owned long strings are kept in reference-counted blocks,
+ * so copying a value only adds a reference.
+ */
+typedef struct{
+    gint refCount;
+    guint hash;		/* 0 if not computed yet */
+    gchar str[1];
+} MdSharedString;
+
+#define md_shared_string_get_block(string) \
+    ((MdSharedString *) ((gchar *) (string)-G_STRUCT_OFFSET(MdSharedString, str)))
+
+static gchar *md_shared_string_new(const gchar *str, gsize len){
+    MdSharedString *block=(MdSharedString *) g_malloc(G_STRUCT_OFFSET(MdSharedString, str)+len+1);
+    block->refCount=1;
+    block->hash=0;
+    memcpy(block->str, str, len);
+    block->str[len]='\0';
+    return block->str;
+}
+
+static void md_shared_string_unref(gchar *str){
+    MdSharedString *block=md_shared_string_get_block(str);
+    if (g_atomic_int_dec_and_test(&block->refCount))
+	g_free(block);
+}
+
+/*
+ * Store a copy of str, short strings go to the holder itself.
+ */
+static void md_string_store_copy(MkdgValue *mValue, const gchar *str){
+    gsize len=strlen(str);
+    if (len<=MKDG_VALUE_INLINE_STRING_MAX){
+	memmove(mValue->data[0].v_inline, str, len+1);
+	mValue->flags |= MKDG_VALUE_FLAG_INLINE;
+    }else{
+	mkdg_value_set_string(mValue, md_shared_string_new(str, len));
+	mValue->flags |= MKDG_VALUE_FLAG_SHARED;
+    }
+}
+
 static void md_string_set(MkdgValue *mValue, gpointer setValue){
     if (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE ){
-	mValue->data[0].v_string= g_strdup( (setValue) ? (gchar *) setValue : "");
+	md_string_store_copy(mValue, (setValue) ? (gchar *) setValue : "");
     }else{
-	mValue->data[0].v_string= (setValue) ? setValue : "";
+	mkdg_value_set_string(mValue, (setValue) ? (gchar *) setValue : "");
     }
 }
 
-static MkdgValue *md_string_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
-    gchar *strValue= g_strdup((G_UNLIKELY(mkdg_string_is_empty(str))) ? "" : str);
-    mkdg_value_set_string(mValue, strValue);
+static MkdgValue *md_string_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    const gchar *s=(G_UNLIKELY(mkdg_string_is_empty(str))) ? "" : str;
+    if (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE ){
+	md_string_store_copy(mValue, s);
+    }else{
+	/* Static value borrows str. */
+	mkdg_value_set_string(mValue, (gchar *) s);
+    }
     return mValue;
 }
 
-static gchar *md_string_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    if (!toStringFormat)
-	toStringFormat="%s";
-    g_string_printf(strBuf, toStringFormat ,mkdg_value_get_string(mValue));
-    return g_string_free(strBuf, FALSE);
+static gsize md_string_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    const gchar *str=mkdg_value_get_string(mValue);
+    return md_format_codec_string(codec, str, strlen(str), buf, bufSize);
 }
 
-#define STRING_COMPARE_CASE_INSENSITIVE_FLAG	0x1
-#define STRING_COMPARE_CASE_INSENSITIVE_OPTSTR  "icase"
-static gint md_string_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
+static gint md_string_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
     if (mValue2->mType!=MKDG_TYPE_STRING){
 	return -3;
     }
     gint ret;
-    guint flags=0;
-    if (compareOption){
-	gchar **options=g_strsplit_set(compareOption,";",-1);
-	gint i;
-	for(i=0; options[i]!=NULL; i++){
-	    if (strcmp(options[i], STRING_COMPARE_CASE_INSENSITIVE_OPTSTR)==0){
-		flags |= STRING_COMPARE_CASE_INSENSITIVE_FLAG;
-	    }
-	}
-	g_strfreev(options);
-    }
     gchar *str1=mkdg_value_get_string(mValue1);
     gchar *str2=mkdg_value_get_string(mValue2);
     MKDG_DEBUG_MSG(7, "[I7] md_string_compare() str1=%s str2=%s",str1, str2);
-    if (flags & STRING_COMPARE_CASE_INSENSITIVE_FLAG){
+    if (str1==str2){
+	/* Interned strings, or the same holder. */
+	return 0;
+    }
+    if (codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE){
 	ret=g_ascii_strcasecmp(str1, str2);
     }else{
 	ret=strcmp(str1, str2);
@@ -519,13 +886,116 @@ static gint md_string_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gcha
     return ret;
 }
 
+/*
+ * Hash of shared string is cached in its block.
+ * The content is immutable, so racing threads store the same hash.
+ */
+static guint md_string_hash(MkdgValue *mValue){
+    if (mValue->flags & MKDG_VALUE_FLAG_SHARED){
+	MdSharedString *block=md_shared_string_get_block(mValue->data[0].v_string);
+	guint hash=(guint) g_atomic_int_get((gint *) &block->hash);
+	if (hash==0){
+	    hash=g_str_hash(block->str);
+	    g_atomic_int_set((gint *) &block->hash, (gint) hash);
+	}
+	return hash;
+    }
+    return g_str_hash(mkdg_value_get_string(mValue));
+}
+
 static void md_string_free(MkdgValue *mValue){
-    if (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE){
+    if (mValue->flags & MKDG_VALUE_FLAG_INLINE){
+	mValue->flags &= ~MKDG_VALUE_FLAG_INLINE;
+    }else if (mValue->flags & MKDG_VALUE_FLAG_INTERNED){
+	/* Interned strings are never freed. */
+	mValue->flags &= ~MKDG_VALUE_FLAG_INTERNED;
+    }else if (mValue->flags & MKDG_VALUE_FLAG_SHARED){
+	md_shared_string_unref(mValue->data[0].v_string);
+	mValue->flags &= ~MKDG_VALUE_FLAG_SHARED;
+    }else if (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE){
 	g_free(mValue->data[0].v_string);
     }
 }
 /*=== End string type ===*/
 /*=== Start string list type ===*/
+/*
+ * Layout of packed string list:
+ * MkdgStringList header with strv[count+1], guint32 hashes[count], then string bytes.
+ */
+#define md_string_list_hashes_offset(count) \
+    (G_STRUCT_OFFSET(MkdgStringList, strv)+sizeof(gchar *)*((count)+1))
+
+#define md_string_list_bytes_offset(count) \
+    (md_string_list_hashes_offset(count)+sizeof(guint32)*(count))
+
+#define md_string_list_get_hashes(sList) \
+    ((guint32 *) ((gchar *) (sList)+md_string_list_hashes_offset((sList)->count)))
+
+MkdgStringList *mkdg_string_list_new(gchar **strList){
+    guint count=0, i;
+    gsize bytes=0;
+    for(count=0;strList[count]!=NULL;count++){
+	bytes+=strlen(strList[count])+1;
+    }
+    gsize size=md_string_list_bytes_offset(count)+bytes;
+    MkdgStringList *sList=(MkdgStringList *) g_malloc(size);
+    sList->size=size;
+    sList->count=count;
+    sList->refCount=1;
+    guint32 *hashes=md_string_list_get_hashes(sList);
+    gchar *dest=(gchar *) sList+md_string_list_bytes_offset(count);
+    sList->hash=count;
+    for(i=0;i<count;i++){
+	gsize len=strlen(strList[i]);
+	memcpy(dest, strList[i], len+1);
+	sList->strv[i]=dest;
+	hashes[i]=g_str_hash(dest);
+	sList->hash=sList->hash*31+hashes[i];
+	dest+=len+1;
+    }
+    sList->strv[count]=NULL;
+    return sList;
+}
+
+MkdgStringList *mkdg_string_list_copy(const MkdgStringList *sList){
+    if (!sList)
+	return NULL;
+    MkdgStringList *result=(MkdgStringList *) g_memdup(sList, sList->size);
+    result->refCount=1;
+    /* Rebase the string vector to the new block */
+    guint i;
+    for(i=0;i<sList->count;i++){
+	result->strv[i]=(gchar *) result + (sList->strv[i] - (gchar *) sList);
+    }
+    return result;
+}
+
+MkdgStringList *mkdg_string_list_ref(MkdgStringList *sList){
+    if (sList)
+	g_atomic_int_inc(&sList->refCount);
+    return sList;
+}
+
+void mkdg_string_list_free(MkdgStringList *sList){
+    if (sList && g_atomic_int_dec_and_test(&sList->refCount))
+	g_free(sList);
+}
+
+guint32 mkdg_string_list_get_hash(const MkdgStringList *sList, guint index){
+    return md_string_list_get_hashes(sList)[index];
+}
+
+gint mkdg_string_list_find(const MkdgStringList *sList, const gchar *str){
+    guint32 hash=g_str_hash(str);
+    const guint32 *hashes=md_string_list_get_hashes(sList);
+    guint i;
+    for(i=0;i<sList->count;i++){
+	if (hashes[i]==hash && strcmp(sList->strv[i], str)==0)
+	    return i;
+    }
+    return -1;
+}
+
 static gchar *emptyStrList[]={"", NULL};
 
 static void md_string_list_extract(MkdgValue *mValue, gpointer ptr){
@@ -534,87 +1004,86 @@ static void md_string_list_extract(MkdgValue *mValue, gpointer ptr){
 }
 
 static void md_string_list_set(MkdgValue *mValue, gpointer setValue){
-    if (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE ){
-	mValue->data[0].v_string_list= g_strdupv( (setValue) ? (gchar **) setValue : emptyStrList);
-    }else{
-	mValue->data[0].v_string_list= (setValue) ? (gchar **) setValue : emptyStrList;
+    if (!setValue && !(mValue->flags & MKDG_VALUE_FLAG_NEED_FREE)){
+	/* Static scratch value, such as a copy destination, holds nothing. */
+	mkdg_value_set_string_list(mValue, NULL);
+	return;
     }
+    /* Packed list is always newly allocated. */
+    mkdg_value_set_string_list(mValue, mkdg_string_list_new((setValue) ? (gchar **) setValue : emptyStrList));
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
 }
 
-static MkdgValue *md_string_list_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
+static MkdgValue *md_string_list_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
     if (!str){
 	mkdg_value_set_string_list(mValue, NULL);
 	return mValue;
     }
-    const gchar *delimiters=(mkdg_string_is_empty(parseOption))? ";": parseOption;
-    gchar **sList=mkdg_string_split_set(str,delimiters, '\\', TRUE, -1);
-    mkdg_value_set_string_list(mValue, sList);
-    gint i;
-    for(i=0;sList[i]!=NULL;i++);
-    // Count number of string length.
-    mValue->data[1].v_int=i;
+    const gchar *delimiters=(mkdg_string_is_empty(codec->parseOption))? ";": codec->parseOption;
+    gchar **sList=mkdg_string_split_set_packed(str,delimiters, '\\', TRUE, -1);
+    mkdg_value_set_string_list(mValue, mkdg_string_list_new(sList));
+    g_free(sList);
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
     return mValue;
 }
 
-static gchar *md_string_list_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    return mkdg_string_list_combine(mkdg_value_get_string_list(mValue), ";",'\\', TRUE);
+static gsize md_string_list_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    const gchar *delimiters=(mkdg_string_is_empty(codec->parseOption))? ";": codec->parseOption;
+    gchar **strList=mkdg_value_get_string_list(mValue);
+    return mkdg_string_list_combine_into((strList) ? strList : emptyStrList+1, delimiters,'\\', TRUE, buf, bufSize);
 }
 
-static gint md_string_list_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
+static gint md_string_list_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
     if (mValue2->mType!=MKDG_TYPE_STRING_LIST){
 	return -3;
     }
     gint ret;
-    guint flags=0;
-    if (compareOption){
-	gchar **options=g_strsplit_set(compareOption,";",-1);
-	gint i;
-	for(i=0; options[i]!=NULL; i++){
-	    if (strcmp(options[i], STRING_COMPARE_CASE_INSENSITIVE_OPTSTR)==0){
-		flags |= STRING_COMPARE_CASE_INSENSITIVE_FLAG;
-	    }
-	}
-	g_strfreev(options);
-    }
-    gchar **strList1=mkdg_value_get_string_list(mValue1);
-    gchar **strList2=mkdg_value_get_string_list(mValue2);
-    if (strList1==NULL){
-	if (strList2==NULL)
+    MkdgStringList *sList1=mkdg_value_get_packed_string_list(mValue1);
+    MkdgStringList *sList2=mkdg_value_get_packed_string_list(mValue2);
+    if (sList1==NULL){
+	if (sList2==NULL)
 	    return 0;
 	return -1;
     }
-    if (strList2==NULL){
+    if (sList2==NULL){
 	return 1;
     }
-
-    gint i=0;
-    if (mValue1->data[1].v_int < mValue2->data[1].v_int){
-	return -1;
-    }else if (mValue1->data[1].v_int > mValue2->data[1].v_int){
-	return 1;
-    }else{
-	for(i=0;strList2[i]!=NULL;i++){
-	    if (strList1[i]==NULL)
-		return -1;
-	    if (flags & STRING_COMPARE_CASE_INSENSITIVE_FLAG){
-		ret=g_ascii_strcasecmp(strList1[i], strList2[i]);
-	    }else{
-		ret=strcmp(strList1[i], strList2[i]);
-	    }
-	    if (ret>0)
-		return 1;
-	    else if (ret<0)
-		return -1;
+    if (sList1==sList2){
+	/* Shared by copy */
+	return 0;
+    }
+    if (sList1->count!=sList2->count){
+	return (sList1->count > sList2->count) ? 1 : -1;
+    }
+    if (codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE){
+	guint i;
+	for(i=0;i<sList1->count;i++){
+	    ret=g_ascii_strcasecmp(sList1->strv[i], sList2->strv[i]);
+	    if (ret)
+		return (ret>0) ? 1 : -1;
 	}
+	return 0;
     }
-    if (strList1[i]!=NULL)
-	return 1;
+    /*
+     * With the same count, comparing the string bytes (including '\0' terminators)
+     * gives the same order as comparing strings one by one.
+     */
+    gsize offset=md_string_list_bytes_offset(sList1->count);
+    gsize size=MIN(sList1->size, sList2->size);
+    ret=memcmp((gchar *) sList1+offset, (gchar *) sList2+offset, size-offset);
+    if (ret)
+	return (ret>0) ? 1 : -1;
     return 0;
 }
 
+static guint md_string_list_hash(MkdgValue *mValue){
+    MkdgStringList *sList=mkdg_value_get_packed_string_list(mValue);
+    return (sList) ? sList->hash : 0;
+}
+
 static void md_string_list_free(MkdgValue *mValue){
     if (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE){
-	g_strfreev(mValue->data[0].v_string_list);
+	mkdg_string_list_free(mkdg_value_get_packed_string_list(mValue));
     }
 }
 /*=== End string list type ===*/
@@ -628,13 +1097,15 @@ static void md_color_set(MkdgValue *mValue, gpointer setValue){
     mkdg_value_set_color(mValue, (setValue) ? *(guint32 *) setValue: 0);
 }
 
-static MkdgValue *md_color_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
+static MkdgValue *md_color_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
     if (G_UNLIKELY(mkdg_string_is_empty(str))){
 	/* Default is black */
 	mkdg_value_set_color(mValue, 0);
     }else{
 	if (str[0]=='#'){
-	    mkdg_value_set_color(mValue, (MkdgColor) strtol(str+sizeof(gchar), NULL, 16));
+	    guint64 color=0;
+	    mkdg_number_parse_uint64(str+sizeof(gchar), 16, &color);
+	    mkdg_value_set_color(mValue, (MkdgColor) color);
 	}else{
 	    gint index=find_color_index_by_name(str);
 	    if (index>=0){
@@ -648,96 +1119,599 @@ static MkdgValue *md_color_from_string(MkdgValue *mValue, const gchar *str, cons
     return mValue;
 }
 
-static gchar *md_color_to_string(MkdgValue *mValue, const gchar *toStringFormat){
-    GString *strBuf=g_string_new(NULL);
-    gchar buf[12];
-    if (!toStringFormat)
-	toStringFormat="%s";
+static gsize md_color_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    static const gchar hexDigits[]="0123456789ABCDEF";
+    gchar hexBuf[10];
+    const gchar *str;
+    gsize len;
     MkdgColor color=mkdg_value_get_color(mValue);
     gint index=find_color_index_by_value(color);
-    MKDG_DEBUG_MSG(5,"[I5] md_color_to_string(): color=%X index=%d",color,index);
+    MKDG_DEBUG_MSG(5,"[I5] md_color_format_into(): color=%X index=%d",color,index);
     if (index>=0){
-	g_string_printf(strBuf, toStringFormat, mkdgColorList[index].name);
+	str=mkdgColorList[index].name;
+	len=strlen(str);
     }else{
-	g_snprintf(buf,12,"#%X", color);
-	g_string_printf(strBuf, toStringFormat, buf);
+	/* Same as "#%X" */
+	gchar *p=hexBuf+sizeof(hexBuf);
+	*--p='\0';
+	do{
+	    *--p=hexDigits[color & 0xF];
+	    color>>=4;
+	}while(color);
+	*--p='#';
+	str=p;
+	len=hexBuf+sizeof(hexBuf)-1-p;
     }
-    return g_string_free(strBuf, FALSE);
+    return md_format_codec_string(codec, str, len, buf, bufSize);
+}
+/*=== End color type ===*/
+/*=== Start enum type ===*/
+static void md_enum_extract(MkdgValue *mValue, gpointer ptr){
+    gint *ptr2=(gint *) ptr;
+    *ptr2=mkdg_value_get_enum(mValue);
 }
 
-static gint md_color_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
-    if (G_VALUE_TYPE(mValue2)!=MKDG_TYPE_COLOR){
+static void md_enum_set(MkdgValue *mValue, gpointer setValue){
+    mkdg_value_set_enum(mValue, (setValue) ? *(gint *) setValue: 0);
+}
+
+/*
+ * Names are looked up in codec->validValues, which are usually only a few.
+ * Without names, the index is parsed as a decimal number.
+ */
+static MkdgValue *md_enum_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    mkdg_value_set_enum(mValue, 0);
+    if (G_UNLIKELY(mkdg_string_is_empty(str))){
+	return mValue;
+    }
+    if (!codec->validValues){
+	gint64 val;
+	MkdgNumberStatus status=mkdg_number_parse_int64(str, 10, &val);
+	status=md_number_clamp_int64(status, &val, 0, G_MAXINT);
+	mkdg_value_set_enum(mValue, (gint) val);
+	return md_number_result(mValue, status, str);
+    }
+    gint i;
+    for(i=0;i<codec->validValueCount;i++){
+	if (((codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE) ?
+		    g_ascii_strcasecmp(codec->validValues[i], str) : strcmp(codec->validValues[i], str))==0){
+	    mkdg_value_set_enum(mValue, i);
+	    return mValue;
+	}
+    }
+    MKDG_DEBUG_MSG(2,"[I2] md_enum_from_string(-, %s) not a valid value", str);
+    return NULL;
+}
+
+static gsize md_enum_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    gint index=mkdg_value_get_enum(mValue);
+    if (codec->validValues && index>=0 && index<codec->validValueCount){
+	const gchar *str=codec->validValues[index];
+	return md_format_codec_string(codec, str, strlen(str), buf, bufSize);
+    }
+    return md_format_int64(index, buf, bufSize);
+}
+
+static gint md_enum_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
+    if (mValue2->mType!=MKDG_TYPE_ENUM){
+	return -3;
+    }
+    return MD_NUMBER_CMP(mkdg_value_get_enum(mValue1), mkdg_value_get_enum(mValue2));
+}
+
+static guint md_enum_hash(MkdgValue *mValue){
+    return (guint) mkdg_value_get_enum(mValue);
+}
+/*=== End enum type ===*/
+/*=== Start flags type ===*/
+#define MD_FLAGS_DELIMITERS " \t|;"
+#define MD_FLAGS_NUMBER_LEN_MAX 32
+
+static void md_flags_extract(MkdgValue *mValue, gpointer ptr){
+    guint64 *ptr2=(guint64 *) ptr;
+    *ptr2=mkdg_value_get_flags(mValue);
+}
+
+static void md_flags_set(MkdgValue *mValue, gpointer setValue){
+    mkdg_value_set_flags(mValue, (setValue) ? *(guint64 *) setValue: 0);
+}
+
+static gint md_flags_bit_count(const MkdgValueCodec *codec){
+    return MIN(codec->validValueCount, MKDG_FLAGS_BIT_MAX);
+}
+
+/*
+ * Find the bit of a token, which is not NUL-terminated.
+ * Returns -1 if not found.
+ */
+static gint md_flags_find_bit(const MkdgValueCodec *codec, const gchar *token, gsize len){
+    gint i, count=md_flags_bit_count(codec);
+    for(i=0;i<count;i++){
+	const gchar *name=codec->validValues[i];
+	if (strlen(name)!=len)
+	    continue;
+	if (((codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE) ?
+		    g_ascii_strncasecmp(name, token, len) : strncmp(name, token, len))==0){
+	    return i;
+	}
+    }
+    return -1;
+}
+
+/*
+ * Tokens are scanned in place, numbers are accepted for bits without names.
+ * Unknown tokens are skipped as mkdg_flag_parse() does, but NULL is returned.
+ */
+static MkdgValue *md_flags_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    guint64 flags=0;
+    gboolean valid=TRUE;
+    const gchar *p=(str) ? str : "";
+    while(*p!='\0'){
+	p+=strspn(p, MD_FLAGS_DELIMITERS);
+	gsize len=strcspn(p, MD_FLAGS_DELIMITERS);
+	if (len==0)
+	    break;
+	gint bit=md_flags_find_bit(codec, p, len);
+	if (bit>=0){
+	    flags |= G_GUINT64_CONSTANT(1)<<bit;
+	}else{
+	    gchar numBuf[MD_FLAGS_NUMBER_LEN_MAX];
+	    guint64 num=0;
+	    if (len<MD_FLAGS_NUMBER_LEN_MAX){
+		memcpy(numBuf, p, len);
+		numBuf[len]='\0';
+	    }
+	    if (len<MD_FLAGS_NUMBER_LEN_MAX && mkdg_number_parse_uint64(numBuf, 0, &num)==MKDG_NUMBER_OK){
+		flags |= num;
+	    }else{
+		MKDG_DEBUG_MSG(2,"[I2] md_flags_from_string(-, %s) invalid flag at %s", str, p);
+		valid=FALSE;
+	    }
+	}
+	p+=len;
+    }
+    mkdg_value_set_flags(mValue, flags);
+    return (valid) ? mValue : NULL;
+}
+
+static gsize md_flags_format_append(const gchar *str, gsize strLen, gchar *buf, gsize bufSize, gsize len){
+    if (len<bufSize){
+	md_format_copy(str, strLen, buf+len, bufSize-len);
+    }
+    return len+strLen;
+}
+
+static gsize md_flags_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    guint64 flags=mkdg_value_get_flags(mValue);
+    gsize len=md_format_copy("", 0, buf, bufSize);
+    gint i, count=md_flags_bit_count(codec);
+    for(i=0;i<count && flags;i++){
+	guint64 bit=G_GUINT64_CONSTANT(1)<<i;
+	if (!(flags & bit))
+	    continue;
+	if (len>0)
+	    len=md_flags_format_append("|", 1, buf, bufSize, len);
+	len=md_flags_format_append(codec->validValues[i], strlen(codec->validValues[i]), buf, bufSize, len);
+	flags &= ~bit;
+    }
+    if (flags){
+	/* Bits without names */
+	gchar numBuf[MD_FLAGS_NUMBER_LEN_MAX];
+	gsize numLen=md_format_printf(numBuf, MD_FLAGS_NUMBER_LEN_MAX, "0x%" G_GINT64_MODIFIER "X", flags);
+	if (len>0)
+	    len=md_flags_format_append("|", 1, buf, bufSize, len);
+	len=md_flags_format_append(numBuf, numLen, buf, bufSize, len);
+    }
+    return len;
+}
+
+static gint md_flags_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
+    if (mValue2->mType!=MKDG_TYPE_FLAGS){
+	return -3;
+    }
+    return MD_NUMBER_CMP(mkdg_value_get_flags(mValue1), mkdg_value_get_flags(mValue2));
+}
+
+static guint md_flags_hash(MkdgValue *mValue){
+    return md_number_hash_bits(mkdg_value_get_flags(mValue));
+}
+/*=== End flags type ===*/
+/*=== Start number array type ===*/
+#define MD_ARRAY_DELIMITERS " \t,;"
+#define MD_ARRAY_SEPARATOR ";"
+#define MD_ARRAY_TOKEN_LEN_MAX 128
+
+#define md_number_array_size(count) \
+    (G_STRUCT_OFFSET(MkdgNumberArray, elements)+sizeof(gint64)*(count))
+
+#define md_number_array_count(array) ((array) ? (array)->count : 0)
+
+/* Elements are 64-bit for both types, so they are hashed as bits. */
+static void md_number_array_rehash(MkdgNumberArray *array){
+    const guint64 *bits=(const guint64 *) array->elements.v_int64;
+    guint32 hash=array->count;
+    guint i;
+    for(i=0;i<array->count;i++){
+	hash=hash*31+md_number_hash_bits(bits[i]);
+    }
+    array->hash=hash;
+}
+
+/*
+ * Doubles that compare equal must be equal in bytes,
+ * so -0.0 is stored as 0.0, and all NaNs as one NaN.
+ */
+static void md_number_array_canonicalize(MkdgNumberArray *array){
+    gdouble *v=array->elements.v_double;
+    guint i;
+    for(i=0;i<array->count;i++){
+	if (v[i]==0.0){
+	    v[i]=0.0;
+	}else if (isnan(v[i])){
+	    v[i]=NAN;
+	}
+    }
+}
+
+/* Allocate an array, elements are not initialized. */
+static MkdgNumberArray *md_number_array_alloc(MkdgType mType, guint count){
+    MkdgNumberArray *array=(MkdgNumberArray *) g_malloc(md_number_array_size(count));
+    array->mType=mType;
+    array->count=count;
+    array->refCount=1;
+    array->hash=0;
+    return array;
+}
+
+MkdgNumberArray *mkdg_number_array_new(MkdgType mType, gconstpointer elements, guint count){
+    if (mType!=MKDG_TYPE_INT_ARRAY && mType!=MKDG_TYPE_DOUBLE_ARRAY)
+	return NULL;
+    MkdgNumberArray *array=md_number_array_alloc(mType, count);
+    if (elements){
+	memcpy(array->elements.v_int64, elements, sizeof(gint64)*count);
+	if (mType==MKDG_TYPE_DOUBLE_ARRAY)
+	    md_number_array_canonicalize(array);
+    }else{
+	/* All bits 0 is also 0.0 */
+	memset(array->elements.v_int64, 0, sizeof(gint64)*count);
+    }
+    md_number_array_rehash(array);
+    return array;
+}
+
+MkdgNumberArray *mkdg_number_array_ref(MkdgNumberArray *array){
+    if (array)
+	g_atomic_int_inc(&array->refCount);
+    return array;
+}
+
+void mkdg_number_array_free(MkdgNumberArray *array){
+    if (array && g_atomic_int_dec_and_test(&array->refCount))
+	g_free(array);
+}
+
+/*
+ * Out-of-range elements are counted instead of returning early,
+ * so the loops have no branches and can be vectorized by compiler.
+ */
+gboolean mkdg_number_array_in_range(const MkdgNumberArray *array, gdouble min, gdouble max){
+    guint i, count=md_number_array_count(array);
+    if (count==0)
+	return TRUE;
+    if (array->mType==MKDG_TYPE_INT_ARRAY){
+	const gint64 *v=array->elements.v_int64;
+	gint64 vMin=v[0], vMax=v[0];
+	for(i=1;i<count;i++){
+	    vMin=(v[i]<vMin) ? v[i] : vMin;
+	    vMax=(v[i]>vMax) ? v[i] : vMax;
+	}
+	return ((gdouble) vMin>=min && (gdouble) vMax<=max) ? TRUE : FALSE;
+    }
+    const gdouble *v=array->elements.v_double;
+    guint outCount=0;
+    for(i=0;i<count;i++){
+	outCount+=!(v[i]>=min && v[i]<=max);
+    }
+    return (outCount==0) ? TRUE : FALSE;
+}
+
+static void md_number_array_extract(MkdgValue *mValue, gpointer ptr){
+    MkdgNumberArray **ptr2=(MkdgNumberArray **) ptr;
+    *ptr2=mkdg_number_array_ref(mkdg_value_get_number_array(mValue));
+}
+
+static void md_number_array_set(MkdgValue *mValue, gpointer setValue){
+    /* Array is immutable, so setting it only adds a reference. */
+    mkdg_value_set_number_array(mValue, mkdg_number_array_ref((MkdgNumberArray *) setValue));
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+}
+
+static MkdgNumberStatus md_number_array_parse_token(MkdgType mType, const gchar *token, gsize len,
+	const MkdgValueCodec *codec, gint64 *element){
+    gchar tokenBuf[MD_ARRAY_TOKEN_LEN_MAX];
+    gchar *str=(len<MD_ARRAY_TOKEN_LEN_MAX) ? tokenBuf : g_malloc(len+1);
+    memcpy(str, token, len);
+    str[len]='\0';
+    MkdgNumberStatus status=(mType==MKDG_TYPE_INT_ARRAY) ?
+	mkdg_number_parse_int64(str, codec->base, element) :
+	mkdg_number_parse_double(str, (gdouble *) element);
+    if (str!=tokenBuf)
+	g_free(str);
+    return status;
+}
+
+/*
+ * Tokens are counted in the first pass, then parsed in place into the array,
+ * so no token strings are allocated.
+ * Invalid elements are stored as 0, and NULL is returned.
+ */
+static MkdgValue *md_number_array_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    const gchar *p;
+    guint count=0, i;
+    for(p=(str) ? str : "";;){
+	p+=strspn(p, MD_ARRAY_DELIMITERS);
+	if (*p=='\0')
+	    break;
+	p+=strcspn(p, MD_ARRAY_DELIMITERS);
+	count++;
+    }
+    if (count==0){
+	mkdg_value_set_number_array(mValue, NULL);
+	return mValue;
+    }
+    MkdgNumberArray *array=md_number_array_alloc(mValue->mType, count);
+    gboolean valid=TRUE;
+    for(p=str, i=0;i<count;i++){
+	p+=strspn(p, MD_ARRAY_DELIMITERS);
+	gsize len=strcspn(p, MD_ARRAY_DELIMITERS);
+	gint64 *element=&array->elements.v_int64[i];
+	MkdgNumberStatus status=md_number_array_parse_token(mValue->mType, p, len, codec, element);
+	if (status!=MKDG_NUMBER_OK){
+	    MKDG_DEBUG_MSG(2,"[I2] md_number_array_from_string(-, %s) invalid element %u", str, i);
+	    *element=0;
+	    valid=FALSE;
+	}
+	p+=len;
+    }
+    if (mValue->mType==MKDG_TYPE_DOUBLE_ARRAY)
+	md_number_array_canonicalize(array);
+    md_number_array_rehash(array);
+    mkdg_value_set_number_array(mValue, array);
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    return (valid) ? mValue : NULL;
+}
+
+static gsize md_number_array_format_element(const MkdgNumberArray *array, guint i,
+	const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    if (array->mType==MKDG_TYPE_INT_ARRAY)
+	return md_format_codec_int64(codec, array->elements.v_int64[i], buf, bufSize);
+    if (!codec->toStringFormat)
+	return mkdg_number_format_double(array->elements.v_double[i], buf, bufSize);
+    return md_format_codec_double(codec, array->elements.v_double[i], buf, bufSize);
+}
+
+static gsize md_number_array_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    const MkdgNumberArray *array=mkdg_value_get_number_array(mValue);
+    gsize len=md_format_copy("", 0, buf, bufSize);
+    guint i, count=md_number_array_count(array);
+    for(i=0;i<count;i++){
+	if (i>0){
+	    len+=md_format_copy(MD_ARRAY_SEPARATOR, 1, (len<bufSize) ? buf+len : NULL,
+		    (len<bufSize) ? bufSize-len : 0);
+	}
+	len+=md_number_array_format_element(array, i, codec, (len<bufSize) ? buf+len : NULL,
+		(len<bufSize) ? bufSize-len : 0);
+    }
+    return len;
+}
+
+/*
+ * Equal arrays are equal in bytes, so memcmp() decides equality,
+ * and only the first differing element is compared as number.
+ */
+static gint md_number_array_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
+    if (mValue2->mType!=mValue1->mType){
 	return -3;
     }
-    MkdgColor v1=mkdg_value_get_color(mValue1);
-    MkdgColor v2=mkdg_value_get_color(mValue2);
-    return (v1==v2) ? 0 : (v1>v2)? 1: -1;
+    const MkdgNumberArray *array1=mkdg_value_get_number_array(mValue1);
+    const MkdgNumberArray *array2=mkdg_value_get_number_array(mValue2);
+    guint count1=md_number_array_count(array1);
+    guint count2=md_number_array_count(array2);
+    if (count1!=count2){
+	return (count1 > count2) ? 1 : -1;
+    }
+    if (array1==array2 || count1==0){
+	/* Shared by copy, or both empty */
+	return 0;
+    }
+    if (memcmp(array1->elements.v_int64, array2->elements.v_int64, sizeof(gint64)*count1)==0){
+	return 0;
+    }
+    guint i;
+    for(i=0;array1->elements.v_int64[i]==array2->elements.v_int64[i];i++){
+    }
+    if (array1->mType==MKDG_TYPE_INT_ARRAY){
+	return MD_NUMBER_CMP(array1->elements.v_int64[i], array2->elements.v_int64[i]);
+    }
+    gdouble d1=array1->elements.v_double[i], d2=array2->elements.v_double[i];
+    if (isnan(d1) || isnan(d2)){
+	/* NaN is after all numbers */
+	return (isnan(d1)) ? 1 : -1;
+    }
+    return MD_NUMBER_CMP(d1, d2);
+}
+
+static guint md_number_array_hash(MkdgValue *mValue){
+    const MkdgNumberArray *array=mkdg_value_get_number_array(mValue);
+    return (array) ? array->hash : 0;
 }
 
+static void md_number_array_free(MkdgValue *mValue){
+    if (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE){
+	mkdg_number_array_free(mkdg_value_get_number_array(mValue));
+    }
+}
+/*=== End number array type ===*/
+/*=== Start blob type ===*/
+/*
+ * Blobs are output as their paths, so that configuration files refer to them.
+ * Blobs only in memory are output as base64 with this prefix.
+ */
+#define MD_BLOB_BASE64_PREFIX "base64:"
+#define MD_BLOB_BASE64_PREFIX_LEN 7
+
+static void md_blob_extract(MkdgValue *mValue, gpointer ptr){
+    MkdgBlob **ptr2=(MkdgBlob **) ptr;
+    *ptr2=mkdg_blob_ref(mkdg_value_get_blob(mValue));
+}
+
+static void md_blob_set(MkdgValue *mValue, gpointer setValue){
+    /* Blob is immutable, so setting it only adds a reference. */
+    mkdg_value_set_blob(mValue, mkdg_blob_ref((MkdgBlob *) setValue));
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+}
+
+/* A path is not accessed until the content is needed. */
+static MkdgValue *md_blob_from_string(MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec){
+    MkdgBlob *blob=NULL;
+    if (mkdg_string_is_empty(str)){
+	blob=NULL;
+    }else if (strncmp(str, MD_BLOB_BASE64_PREFIX, MD_BLOB_BASE64_PREFIX_LEN)==0){
+	gsize size=0;
+	guchar *data=g_base64_decode(str+MD_BLOB_BASE64_PREFIX_LEN, &size);
+	blob=mkdg_blob_new_static(data, size, g_free, data);
+    }else{
+	blob=mkdg_blob_new_from_file(str);
+    }
+    mkdg_value_set_blob(mValue, blob);
+    mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    return mValue;
+}
+
+static gsize md_blob_format_into(MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize){
+    MkdgBlob *blob=mkdg_value_get_blob(mValue);
+    if (!blob)
+	return md_format_copy("", 0, buf, bufSize);
+    const gchar *path=mkdg_blob_get_path(blob);
+    if (path)
+	return md_format_copy(path, strlen(path), buf, bufSize);
+    gsize size;
+    gconstpointer data=mkdg_blob_get_data(blob, &size);
+    gsize len=md_format_copy(MD_BLOB_BASE64_PREFIX, MD_BLOB_BASE64_PREFIX_LEN, buf, bufSize);
+    gsize encodedLen=(size+2)/3*4;
+    if (len+1<bufSize){
+	/* Whole 3-byte groups encode to the leading characters of the full output. */
+	gsize avail=bufSize-len-1;
+	gsize encodeSize=MIN(size, (avail+3)/4*3);
+	gchar *encoded=g_base64_encode((const guchar *) data, encodeSize);
+	md_format_copy(encoded, strlen(encoded), buf+len, bufSize-len);
+	g_free(encoded);
+    }
+    return len+encodedLen;
+}
+
+static gint md_blob_compare(MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec){
+    if (mValue2->mType!=MKDG_TYPE_BLOB){
+	return -3;
+    }
+    return mkdg_blob_compare(mkdg_value_get_blob(mValue1), mkdg_value_get_blob(mValue2));
+}
+
+static guint md_blob_hash(MkdgValue *mValue){
+    return mkdg_blob_hash(mkdg_value_get_blob(mValue));
+}
+
+static void md_blob_free(MkdgValue *mValue){
+    if (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE){
+	mkdg_blob_free(mkdg_value_get_blob(mValue));
+    }
+}
+/*=== End blob type ===*/
+
 const MkdgTypeInterfaceMkdgType mkdgTypeInterfaces[]={
     { MKDG_TYPE_POINTER,	"POINTER",
 	{md_pointer_extract,		md_pointer_set,
 	    NULL, 	NULL,
-	    md_pointer_compare,	NULL}},
+	    md_pointer_compare,	md_pointer_hash,	NULL}},
     { MKDG_TYPE_BOOLEAN,	"BOOLEAN",
 	{md_boolean_extract,		md_boolean_set,
-	    md_boolean_from_string, 	md_boolean_to_string,
-	    md_boolean_compare,	NULL}},
+	    md_boolean_from_string, 	md_boolean_format_into,
+	    md_boolean_compare,	md_boolean_hash,	NULL}},
     { MKDG_TYPE_INT,		"INT",
 	{md_int_extract,		md_int_set,
-	    md_int_from_string, 	md_int_to_string,
-	    md_number_compare,	NULL}},
+	    md_int_from_string, 	md_int_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_UINT,		"UINT",
 	{md_uint_extract,		md_uint_set,
-	    md_uint_from_string, 	md_uint_to_string,
-	    md_number_compare,	NULL}},
+	    md_uint_from_string, 	md_uint_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_INT32,		"INT32",
 	{md_int32_extract,		md_int32_set,
-	    md_int32_from_string, 	md_int32_to_string,
-	    md_number_compare,	NULL}},
+	    md_int32_from_string, 	md_int32_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_UINT32,		"UINT32",
 	{md_uint32_extract,		md_uint32_set,
-	    md_uint32_from_string, 	md_uint32_to_string,
-	    md_number_compare,	NULL}},
+	    md_uint32_from_string, 	md_uint32_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_INT64,		"INT64",
 	{md_int64_extract,		md_int64_set,
-	    md_int64_from_string, 	md_int64_to_string,
-	    md_number_compare,	NULL}},
+	    md_int64_from_string, 	md_int64_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_UINT64,		"UINT64",
 	{md_uint64_extract,		md_uint64_set,
-	    md_uint64_from_string, 	md_uint64_to_string,
-	    md_number_compare,	NULL}},
+	    md_uint64_from_string, 	md_uint64_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_LONG,		"LONG",
 	{md_long_extract,		md_long_set,
-	    md_long_from_string, 	md_long_to_string,
-	    md_number_compare,	NULL}},
+	    md_long_from_string, 	md_long_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_ULONG,		"ULONG",
 	{md_ulong_extract,		md_ulong_set,
-	    md_ulong_from_string, 	md_ulong_to_string,
-	    md_number_compare,	NULL}},
+	    md_ulong_from_string, 	md_ulong_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_FLOAT,		"FLOAT",
 	{md_float_extract,		md_float_set,
-	    md_float_from_string, 	md_float_to_string,
-	    md_number_compare,	NULL}},
+	    md_float_from_string, 	md_float_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_DOUBLE,		"DOUBLE",
 	{md_double_extract,		md_double_set,
-	    md_double_from_string, 	md_double_to_string,
-	    md_number_compare,	NULL}},
+	    md_double_from_string, 	md_double_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
     { MKDG_TYPE_STRING,		"STRING",
 	{md_string_extract,		md_string_set,
-	    md_string_from_string, 	md_string_to_string,
-	    md_string_compare,		md_string_free}},
+	    md_string_from_string, 	md_string_format_into,
+	    md_string_compare,		md_string_hash,	md_string_free}},
     { MKDG_TYPE_STRING_LIST,	"STRING_LIST",
 	{md_string_list_extract,		md_string_list_set,
-	    md_string_list_from_string, 	md_string_list_to_string,
-	    md_string_list_compare,	md_string_list_free}},
+	    md_string_list_from_string, 	md_string_list_format_into,
+	    md_string_list_compare,	md_string_list_hash,	md_string_list_free}},
     { MKDG_TYPE_COLOR,		"COLOR",
 	{md_color_extract,		md_color_set,
-	    md_color_from_string, 	md_color_to_string,
-	    md_color_compare,	NULL}},
+	    md_color_from_string, 	md_color_format_into,
+	    md_number_compare,	md_number_hash,	NULL}},
+    { MKDG_TYPE_ENUM,		"ENUM",
+	{md_enum_extract,		md_enum_set,
+	    md_enum_from_string, 	md_enum_format_into,
+	    md_enum_compare,		md_enum_hash,	NULL}},
+    { MKDG_TYPE_FLAGS,		"FLAGS",
+	{md_flags_extract,		md_flags_set,
+	    md_flags_from_string, 	md_flags_format_into,
+	    md_flags_compare,		md_flags_hash,	NULL}},
+    { MKDG_TYPE_INT_ARRAY,	"INT_ARRAY",
+	{md_number_array_extract,	md_number_array_set,
+	    md_number_array_from_string, 	md_number_array_format_into,
+	    md_number_array_compare,	md_number_array_hash,	md_number_array_free}},
+    { MKDG_TYPE_DOUBLE_ARRAY,	"DOUBLE_ARRAY",
+	{md_number_array_extract,	md_number_array_set,
+	    md_number_array_from_string, 	md_number_array_format_into,
+	    md_number_array_compare,	md_number_array_hash,	md_number_array_free}},
+    { MKDG_TYPE_BLOB,		"BLOB",
+	{md_blob_extract,		md_blob_set,
+	    md_blob_from_string, 	md_blob_format_into,
+	    md_blob_compare,		md_blob_hash,	md_blob_free}},
     { MKDG_TYPE_NONE,		"NONE",
 	{NULL,			NULL,			NULL,
-	    NULL,			NULL}},
+	    NULL,			NULL,			NULL}},
 };
 
 static const MkdgTypeInterface *mkdg_find_type_interface(MkdgType mType){
@@ -766,7 +1740,7 @@ const gchar *mkdg_type_to_string(MkdgType mType){
 
 static void mkdg_value_set_private(MkdgValue *mValue, gpointer setValue, const MkdgTypeInterface *typeInterface){
     if (mkdg_type_is_pointer(mValue->mType)){
-	if (mValue->data[0].v_pointer && (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE)){
+	if (mValue->data[0].v_pointer && (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE) && typeInterface->free){
 	    /* Free old data */
 	    typeInterface->free(mValue);
 	}
@@ -774,48 +1748,143 @@ static void mkdg_value_set_private(MkdgValue *mValue, gpointer setValue, const M
     typeInterface->set(mValue, setValue);
 }
 
-MkdgValue *mkdg_value_new(MkdgType mType, gpointer setValue){
+static MkdgValue *mkdg_value_init_private(MkdgValue *mValue, MkdgType mType, MkdgValueFlags flags,
+	gpointer setValue, const MkdgTypeInterface *typeInterface){
+    mValue->mType=mType;
+    mValue->flags=flags;
+    memset(mValue->data, 0, sizeof(MkdgValueHolder));
+    mkdg_value_set_private(mValue, setValue, typeInterface);
+    return mValue;
+}
+
+MkdgValue *mkdg_value_init(MkdgValue *mValue, MkdgType mType){
     const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mType);
     if (!typeInterface)
 	return NULL;
-    MkdgValue *mValue=g_new0(MkdgValue, 1);
-    mValue->flags=0;
-    mValue->mType=mType;
-    if (mkdg_type_is_pointer(mValue->mType)){
-	mValue->data[0].v_pointer=NULL;
-	mValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    return mkdg_value_init_private(mValue, mType,
+	    (mkdg_type_is_pointer(mType)) ? MKDG_VALUE_FLAG_NEED_FREE : 0, NULL, typeInterface);
+}
+
+MkdgValue *mkdg_value_init_static(MkdgValue *mValue, MkdgType mType){
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mType);
+    if (!typeInterface)
+	return NULL;
+    return mkdg_value_init_private(mValue, mType, 0, NULL, typeInterface);
+}
+
+void mkdg_value_clear(MkdgValue *mValue){
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue->mType);
+    if (typeInterface && typeInterface->free && (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE)){
+	typeInterface->free(mValue);
     }
-    mkdg_value_set_private(mValue, setValue, typeInterface);
-    return mValue;
+    mValue->flags &= ~(MKDG_VALUE_FLAG_INLINE | MKDG_VALUE_FLAG_INTERNED);
+    memset(mValue->data, 0, sizeof(MkdgValueHolder));
+}
+
+MkdgValue *mkdg_value_new(MkdgType mType, gpointer setValue){
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mType);
+    if (!typeInterface)
+	return NULL;
+    MkdgValue *mValue=g_new(MkdgValue, 1);
+    return mkdg_value_init_private(mValue, mType,
+	    (mkdg_type_is_pointer(mType)) ? MKDG_VALUE_FLAG_NEED_FREE : 0, setValue, typeInterface);
 }
 
 MkdgValue *mkdg_value_new_static(MkdgType mType, gpointer setValue){
     const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mType);
     if (!typeInterface)
 	return NULL;
-    MkdgValue *mValue=g_new0(MkdgValue, 1);
-    mValue->flags=0;
-    mValue->mType=mType;
-    if (mkdg_type_is_pointer(mValue->mType)){
-	mValue->data[0].v_pointer=NULL;
-    }
-    mkdg_value_set_private(mValue, setValue, typeInterface);
-    return mValue;
+    MkdgValue *mValue=g_new(MkdgValue, 1);
+    return mkdg_value_init_private(mValue, mType, 0, setValue, typeInterface);
 }
 
 gboolean mkdg_value_copy(MkdgValue *srcValue, MkdgValue *destValue){
     if (srcValue->mType!=destValue->mType){
 	return FALSE;
     }
-    if (mkdg_type_is_pointer(srcValue->mType)){
+    if (srcValue->mType==MKDG_TYPE_STRING){
+	MkdgValueFlags shareFlags=srcValue->flags & (MKDG_VALUE_FLAG_INTERNED | MKDG_VALUE_FLAG_SHARED);
+	if (shareFlags){
+	    /* Share the string instead of copying it. */
+	    gchar *str=srcValue->data[0].v_string;
+	    if (shareFlags & MKDG_VALUE_FLAG_SHARED){
+		/* Add reference before clearing, in case destValue holds the same block. */
+		g_atomic_int_inc(&md_shared_string_get_block(str)->refCount);
+		shareFlags |= MKDG_VALUE_FLAG_NEED_FREE;
+	    }
+	    mkdg_value_clear(destValue);
+	    mkdg_value_set_string(destValue, str);
+	    destValue->flags |= shareFlags;
+	}else if (srcValue->flags & MKDG_VALUE_FLAG_INLINE){
+	    /* Inline bytes belong to srcValue, so copy them into destValue's own storage. */
+	    if (srcValue!=destValue){
+		mkdg_value_clear(destValue);
+		memcpy(destValue->data[0].v_inline, srcValue->data[0].v_inline, sizeof(MkdgValueHolder));
+		destValue->flags |= MKDG_VALUE_FLAG_INLINE;
+	    }
+	}else{
+	    mkdg_value_set(destValue, mkdg_value_get_string(srcValue));
+	}
+    }else if (srcValue->mType==MKDG_TYPE_STRING_LIST){
+	MkdgStringList *sList=mkdg_string_list_ref(mkdg_value_get_packed_string_list(srcValue));
+	md_string_list_free(destValue);
+	mkdg_value_set_string_list(destValue, sList);
+	destValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    }else if (srcValue->mType==MKDG_TYPE_INT_ARRAY || srcValue->mType==MKDG_TYPE_DOUBLE_ARRAY){
+	MkdgNumberArray *array=mkdg_number_array_ref(mkdg_value_get_number_array(srcValue));
+	md_number_array_free(destValue);
+	mkdg_value_set_number_array(destValue, array);
+	destValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    }else if (mkdg_type_is_pointer(srcValue->mType)){
 	mkdg_value_set(destValue, srcValue->data[0].v_pointer);
     }else{
 	destValue->data[0]=srcValue->data[0];
-	destValue->data[1]=srcValue->data[1];
     }
     return TRUE;
 }
 
+MkdgValue *mkdg_value_intern(MkdgValue *mValue){
+    if (mValue->mType!=MKDG_TYPE_STRING || (mValue->flags & (MKDG_VALUE_FLAG_INLINE | MKDG_VALUE_FLAG_INTERNED))){
+	return mValue;
+    }
+    gchar *str=mValue->data[0].v_string;
+    const gchar *iStr=g_intern_string((str) ? str : "");
+    if (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE){
+	md_string_free(mValue);
+    }
+    mkdg_value_set_string(mValue, (gchar *) iStr);
+    mValue->flags |= MKDG_VALUE_FLAG_INTERNED;
+    return mValue;
+}
+
+void mkdg_value_make_writable(MkdgValue *mValue){
+    if (mValue->mType==MKDG_TYPE_STRING){
+	gchar *str=mValue->data[0].v_string;
+	if ((mValue->flags & MKDG_VALUE_FLAG_INTERNED)
+		|| ((mValue->flags & MKDG_VALUE_FLAG_SHARED)
+		    && g_atomic_int_get(&md_shared_string_get_block(str)->refCount)>1)){
+	    gchar *newStr=md_shared_string_new(str, strlen(str));
+	    if (mValue->flags & MKDG_VALUE_FLAG_NEED_FREE)
+		md_string_free(mValue);
+	    mkdg_value_set_string(mValue, newStr);
+	    mValue->flags |= MKDG_VALUE_FLAG_SHARED | MKDG_VALUE_FLAG_NEED_FREE;
+	}
+    }else if (mValue->mType==MKDG_TYPE_STRING_LIST){
+	MkdgStringList *sList=mkdg_value_get_packed_string_list(mValue);
+	if (sList && g_atomic_int_get(&sList->refCount)>1){
+	    mkdg_value_set_string_list(mValue, mkdg_string_list_copy(sList));
+	    mkdg_string_list_free(sList);
+	}
+    }else if (mValue->mType==MKDG_TYPE_INT_ARRAY || mValue->mType==MKDG_TYPE_DOUBLE_ARRAY){
+	MkdgNumberArray *array=mkdg_value_get_number_array(mValue);
+	if (array && g_atomic_int_get(&array->refCount)>1){
+	    mkdg_value_set_number_array(mValue,
+		    mkdg_number_array_new(array->mType, array->elements.v_int64, array->count));
+	    mkdg_number_array_free(array);
+	}
+    }
+}
+
 void mkdg_value_extract(MkdgValue *mValue, gpointer ptr){
     const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue->mType);
     typeInterface->extract(mValue, ptr);
@@ -827,12 +1896,8 @@ void mkdg_value_set(MkdgValue *mValue, gpointer setValue){
 }
 
 void mkdg_value_free(gpointer mValue){
-    MkdgValue *mV=(MkdgValue *) mValue;
-    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mV->mType);
-    if (mV->flags  & MKDG_VALUE_FLAG_NEED_FREE){
-	typeInterface->free(mV);
-    }
-    g_free(mV);
+    mkdg_value_clear((MkdgValue *) mValue);
+    g_free(mValue);
 }
 
 gboolean mkdg_type_is_pointer(MkdgType mType){
@@ -840,6 +1905,9 @@ gboolean mkdg_type_is_pointer(MkdgType mType){
 	case MKDG_TYPE_POINTER:
 	case MKDG_TYPE_STRING:
 	case MKDG_TYPE_STRING_LIST:
+	case MKDG_TYPE_INT_ARRAY:
+	case MKDG_TYPE_DOUBLE_ARRAY:
+	case MKDG_TYPE_BLOB:
 	    return TRUE;
 	default:
 	    break;
@@ -930,39 +1998,150 @@ gdouble mkdg_value_to_double(MkdgValue *value){
 	case MKDG_TYPE_DOUBLE:
 	    return (gdouble) mkdg_value_get_double(value);
 	case MKDG_TYPE_COLOR:
-	    return (gdouble) mkdg_value_get_double(value);
+	    return (gdouble) mkdg_value_get_color(value);
 	default:
 	    break;
     }
     return  0.0;
 }
 
-MkdgValue *mkdg_value_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
+/*=== Start codec functions ===*/
+#define COMPARE_CASE_INSENSITIVE_OPTSTR  "icase"
+/*
+ * Scan the ';' separated compareOption in place.
+ */
+static guint md_compare_option_parse(const gchar *compareOption){
+    guint flags=0;
+    const gchar *p=compareOption;
+    while(p && *p!='\0'){
+	const gchar *end=strchr(p, ';');
+	gsize len=(end) ? (gsize) (end-p) : strlen(p);
+	if (len==strlen(COMPARE_CASE_INSENSITIVE_OPTSTR)
+		&& strncmp(p, COMPARE_CASE_INSENSITIVE_OPTSTR, len)==0){
+	    flags |= MKDG_COMPARE_FLAG_CASE_INSENSITIVE;
+	}
+	p=(end) ? end+1 : NULL;
+    }
+    return flags;
+}
+
+MkdgValueCodec *mkdg_value_codec_init(MkdgValueCodec *codec, MkdgType mType,
+	const gchar *parseOption, const gchar *toStringFormat, const gchar *compareOption){
+    codec->parseOption=parseOption;
+    codec->base=mkdg_number_base_parse(parseOption);
+    codec->compareFlags=md_compare_option_parse(compareOption);
+    codec->formatArg=MKDG_FORMAT_ARG_NONE;
+    codec->toStringFormat=NULL;
+    codec->validValues=NULL;
+    codec->validValueCount=0;
+    if (toStringFormat){
+	codec->formatArg=md_format_arg_parse(toStringFormat, mType);
+	if (codec->formatArg!=MKDG_FORMAT_ARG_NONE){
+	    codec->toStringFormat=toStringFormat;
+	}
+    }
+    codec->compiled=TRUE;
+    return codec;
+}
+
+MkdgValueCodec *mkdg_value_codec_set_valid_values(MkdgValueCodec *codec, gchar **validValues){
+    codec->validValues=validValues;
+    codec->validValueCount=(validValues) ? g_strv_length(validValues) : 0;
+    return codec;
+}
+
+MkdgValue *mkdg_value_codec_from_string(const MkdgValueCodec *codec, MkdgValue *mValue, const gchar *str){
     const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue->mType);
     if (!typeInterface)
 	return NULL;
     if (mkdg_type_is_pointer(mValue->mType)){
-	if (mValue->data[0].v_pointer && (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE)){
+	if (mValue->data[0].v_pointer && (mValue->flags  & MKDG_VALUE_FLAG_NEED_FREE) && typeInterface->free){
 	    /* Free old data */
 	    typeInterface->free(mValue);
 	}
     }
-    typeInterface->from_string(mValue, str, parseOption);
-    return mValue;
+    return typeInterface->from_string(mValue, str, codec);
 }
 
-gchar *mkdg_value_to_string(MkdgValue *mValue, const gchar *toStringFormat){
+gsize mkdg_value_codec_format_into(const MkdgValueCodec *codec, MkdgValue *mValue, gchar *buf, gsize bufSize){
     const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue->mType);
-    if (!typeInterface)
+    if (!typeInterface || !typeInterface->format_into)
+	return md_format_copy("", 0, buf, bufSize);
+    return typeInterface->format_into(mValue, codec, buf, bufSize);
+}
+
+gchar *mkdg_value_codec_to_string(const MkdgValueCodec *codec, MkdgValue *mValue){
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue->mType);
+    if (!typeInterface || !typeInterface->format_into)
 	return NULL;
-    return typeInterface->to_string(mValue, toStringFormat);
+    gchar buf[MKDG_VALUE_FORMAT_BUFFER_SIZE];
+    gsize len=typeInterface->format_into(mValue, codec, buf, MKDG_VALUE_FORMAT_BUFFER_SIZE);
+    if (len<MKDG_VALUE_FORMAT_BUFFER_SIZE)
+	return g_strndup(buf, len);
+    gchar *result=g_new(gchar, len+1);
+    typeInterface->format_into(mValue, codec, result, len+1);
+    return result;
+}
+
+gint mkdg_value_codec_compare(const MkdgValueCodec *codec, MkdgValue *mValue1, MkdgValue *mValue2){
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue2->mType);
+    if (!typeInterface)
+	return -2;
+    typeInterface=mkdg_find_type_interface(mValue1->mType);
+    if (!typeInterface)
+	return -2;
+    return typeInterface->compare(mValue1,mValue2, codec);
+}
+
+/*
+ * Get the hash if it is cached or cheaper than comparing.
+ */
+static gboolean md_value_peek_hash(MkdgValue *mValue, guint *hash){
+    if (mValue->mType==MKDG_TYPE_STRING_LIST
+	    || mValue->mType==MKDG_TYPE_INT_ARRAY || mValue->mType==MKDG_TYPE_DOUBLE_ARRAY
+	    || (mValue->mType==MKDG_TYPE_STRING && (mValue->flags & MKDG_VALUE_FLAG_SHARED))){
+	*hash=mkdg_value_hash(mValue);
+	return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean mkdg_value_codec_equal(const MkdgValueCodec *codec, MkdgValue *mValue1, MkdgValue *mValue2){
+    guint hash1, hash2;
+    if (!(codec->compareFlags & MKDG_COMPARE_FLAG_CASE_INSENSITIVE)
+	    && md_value_peek_hash(mValue1, &hash1) && md_value_peek_hash(mValue2, &hash2)
+	    && hash1!=hash2){
+	return FALSE;
+    }
+    return (mkdg_value_codec_compare(codec, mValue1, mValue2)==0) ? TRUE : FALSE;
+}
+/*=== End codec functions ===*/
+
+MkdgValue *mkdg_value_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption){
+    MkdgValueCodec codec;
+    mkdg_value_codec_init(&codec, mValue->mType, parseOption, NULL, NULL);
+    return mkdg_value_codec_from_string(&codec, mValue, str);
+}
+
+gsize mkdg_value_format_into(MkdgValue *mValue, const gchar *toStringFormat, gchar *buf, gsize bufSize){
+    MkdgValueCodec codec;
+    mkdg_value_codec_init(&codec, mValue->mType, NULL, toStringFormat, NULL);
+    return mkdg_value_codec_format_into(&codec, mValue, buf, bufSize);
+}
+
+gchar *mkdg_value_to_string(MkdgValue *mValue, const gchar *toStringFormat){
+    MkdgValueCodec codec;
+    mkdg_value_codec_init(&codec, mValue->mType, NULL, toStringFormat, NULL);
+    return mkdg_value_codec_to_string(&codec, mValue);
 }
 
 gchar *mkdg_string_convert(const gchar *str, MkdgType mType, const gchar *parseOption, const gchar *toStringFormat){
-    MkdgValue *mValue=mkdg_value_new(mType,NULL);
-    mkdg_value_from_string(mValue, str, parseOption);
-    gchar *result=mkdg_value_to_string(mValue, toStringFormat);
-    mkdg_value_free(mValue);
+    MkdgValue mValue;
+    if (!mkdg_value_init_static(&mValue, mType))
+	return NULL;
+    mkdg_value_from_string(&mValue, str, parseOption);
+    gchar *result=mkdg_value_to_string(&mValue, toStringFormat);
+    mkdg_value_clear(&mValue);
     return result;
 }
 
@@ -971,13 +2150,23 @@ gchar *mkdg_string_normalized(const gchar *str, MkdgType mType){
 }
 
 gint mkdg_value_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption){
-    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(mValue2->mType);
-    if (!typeInterface)
-	return -2;
-    typeInterface=mkdg_find_type_interface(mValue1->mType);
-    if (!typeInterface)
-	return -2;
-    return typeInterface->compare(mValue1,mValue2, compareOption);
+    MkdgValueCodec codec;
+    mkdg_value_codec_init(&codec, mValue1->mType, NULL, NULL, compareOption);
+    return mkdg_value_codec_compare(&codec, mValue1, mValue2);
+}
+
+guint mkdg_value_hash(gconstpointer mValue){
+    MkdgValue *value=(MkdgValue *) mValue;
+    const MkdgTypeInterface *typeInterface=mkdg_find_type_interface(value->mType);
+    if (!typeInterface || !typeInterface->hash)
+	return 0;
+    return typeInterface->hash(value);
+}
+
+gboolean mkdg_value_equal(gconstpointer mValue1, gconstpointer mValue2){
+    MkdgValueCodec codec;
+    mkdg_value_codec_init(&codec, ((MkdgValue *) mValue1)->mType, NULL, NULL, NULL);
+    return mkdg_value_codec_equal(&codec, (MkdgValue *) mValue1, (MkdgValue *) mValue2);
 }
 
 
@@ -32,6 +32,7 @@
 #include <glib.h>
 #include <glib-object.h>
 #include "MakerDialogUtil.h"
+#include "MakerDialogBlob.h"
 
 /**
  * Type of MakerDialog color.
@@ -66,6 +67,11 @@ typedef enum {
     MKDG_TYPE_STRING,		//!< String type.
     MKDG_TYPE_STRING_LIST,	//!< List of strings.
     MKDG_TYPE_COLOR,		//!< Color type.
+    MKDG_TYPE_ENUM,		//!< Enumeration type, stored as index of valid values. @since 0.3
+    MKDG_TYPE_FLAGS,		//!< Set of flags, stored as 64-bit mask over valid values. @since 0.3
+    MKDG_TYPE_INT_ARRAY,	//!< Packed array of 64-bit integers. @since 0.3
+    MKDG_TYPE_DOUBLE_ARRAY,	//!< Packed array of doubles. @since 0.3
+    MKDG_TYPE_BLOB,		//!< Binary data, which can be a memory-mapped file. @since 0.3
 //    MKDG_TYPE_FILE,		//!< File type.
 //    MKDG_TYPE_KEY_COMBINATION,	//!< Type for key combination. Such as "Ctrl-A"
     MKDG_TYPE_NONE,		//!< "None" type.
@@ -76,6 +82,9 @@ typedef enum {
  */
 typedef enum{
     MKDG_VALUE_FLAG_NEED_FREE		=0x1,	//!< Need to free the data.
+    MKDG_VALUE_FLAG_INLINE		=0x2,	//!< String is stored inline in the value holder.
+    MKDG_VALUE_FLAG_INTERNED		=0x4,	//!< String is an interned string, which is shared and never freed.
+    MKDG_VALUE_FLAG_SHARED		=0x8,	//!< String is in a reference-counted block, which is shared by copies.
 } MKDG_VALUE_FLAG;
 
 /**
@@ -83,17 +92,127 @@ typedef enum{
  */
 typedef guint32 MkdgValueFlags;
 
+/**
+ * Maximum length of string that can be stored inline.
+ *
+ * Owned strings that are not longer than this (excluding the terminating '\\0')
+ * are copied into the value holder instead of being allocated.
+ * @since 0.3
+ */
+#define MKDG_VALUE_INLINE_STRING_MAX	(sizeof(MkdgValueHolder)-1)
+
+/**
+ * Packed string list.
+ *
+ * Value of #MKDG_TYPE_STRING_LIST is stored in one block:
+ * this header with the NULL-terminated string vector,
+ * followed by the hash of each string, then the string bytes.
+ * Thus copying, comparing and freeing a list take one memcpy(), memcmp() and g_free().
+ *
+ * The block is reference-counted and immutable, so values share it on copy.
+ * Create it with mkdg_string_list_new(), add a reference with mkdg_string_list_ref(),
+ * and release it with mkdg_string_list_free().
+ * @since 0.3
+ */
+typedef struct{
+    gsize	size;		//!< Size of the whole block in bytes.
+    guint	count;		//!< Number of strings, excluding the terminating NULL.
+    gint	refCount;	//!< Reference count.
+    guint32	hash;		//!< Hash of the whole list, computed from hashes of strings.
+    gchar	*strv[1];	//!< NULL-terminated string vector, which has \a count+1 elements.
+} MkdgStringList;
+
+/**
+ * Packed number array.
+ *
+ * Value of #MKDG_TYPE_INT_ARRAY and #MKDG_TYPE_DOUBLE_ARRAY is stored in one block:
+ * this header followed by contiguous elements,
+ * thus comparing two arrays of the same length takes one memcmp().
+ * Doubles are stored with -0.0 turned to 0.0 and a single NaN representation,
+ * so equal arrays are also equal in bytes.
+ *
+ * Like MkdgStringList, the block is reference-counted and immutable, so values share it on copy.
+ * Create it with mkdg_number_array_new(), add a reference with mkdg_number_array_ref(),
+ * and release it with mkdg_number_array_free().
+ * @since 0.3
+ */
+typedef struct{
+    MkdgType	mType;		//!< #MKDG_TYPE_INT_ARRAY or #MKDG_TYPE_DOUBLE_ARRAY.
+    guint	count;		//!< Number of elements.
+    gint	refCount;	//!< Reference count.
+    guint32	hash;		//!< Hash of the elements.
+    union{
+	gint64	v_int64[1];	//!< Elements of #MKDG_TYPE_INT_ARRAY.
+	gdouble	v_double[1];	//!< Elements of #MKDG_TYPE_DOUBLE_ARRAY.
+    } elements;			//!< Elements, which has \a count items.
+} MkdgNumberArray;
+
 /**
  * Generic value and type holder for Maker Dialog.
  *
  * This data structure mimics GValue.
+ *
+ * It is kept in 16 bytes: a type tag, flags, and a single value holder.
+ * Short strings are stored in the holder itself and flagged with
+ * #MKDG_VALUE_FLAG_INLINE, so always access strings with mkdg_value_get_string().
  */
 typedef struct{
     MkdgType 		mType;		//!< MakerDialog type.
     MkdgValueFlags	flags;		//!< Flags MakerDialog value.
-    MkdgValueHolder     data[2];	//!< Value holder.
+    MkdgValueHolder     data[1];	//!< Value holder.
 } MkdgValue;
 
+/**
+ * Enumeration of compare flags.
+ *
+ * Compare flags are parsed from compareOption, see mkdg_value_codec_init().
+ * @since 0.3
+ */
+typedef enum{
+    MKDG_COMPARE_FLAG_CASE_INSENSITIVE	=0x1,	//!< Compare strings case-insensitively, compareOption "icase".
+} MKDG_COMPARE_FLAG;
+
+/**
+ * Enumeration of printf() argument kinds.
+ *
+ * The argument that a validated toStringFormat expects.
+ * Values are converted to this kind before passing to printf(),
+ * so mismatched length modifiers are harmless.
+ * @since 0.3
+ */
+typedef enum{
+    MKDG_FORMAT_ARG_NONE=0,		//!< No valid format, default format is used.
+    MKDG_FORMAT_ARG_INT,		//!< int, such as "%d" and "%x".
+    MKDG_FORMAT_ARG_LONG,		//!< long, such as "%ld".
+    MKDG_FORMAT_ARG_LONG_LONG,		//!< long long, such as "%lld".
+    MKDG_FORMAT_ARG_DOUBLE,		//!< double, such as "%f" and "%g".
+    MKDG_FORMAT_ARG_LONG_DOUBLE,	//!< long double, such as "%Lg".
+    MKDG_FORMAT_ARG_STRING,		//!< string, "%s".
+} MKDG_FORMAT_ARG;
+
+/**
+ * Compiled parse, output and compare options.
+ *
+ * A codec holds parseOption, toStringFormat and compareOption in the
+ * form that value operations use directly, so the option strings are
+ * interpreted once instead of on every parse, output or comparison.
+ *
+ * The option strings are borrowed, they must outlive the codec.
+ * Each MkdgPropertySpec has a codec, see mkdg_property_spec_get_codec().
+ * @see mkdg_value_codec_init()
+ * @since 0.3
+ */
+typedef struct{
+    const gchar *parseOption;		//!< Parse option. Such as delimiters for string list. Can be \c NULL.
+    const gchar *toStringFormat;	//!< Validated printf()-like format string. \c NULL for default format.
+    gint base;				//!< Base for integer types. 0 for detecting from prefix.
+    guint compareFlags;			//!< Compare flags, see ::MKDG_COMPARE_FLAG.
+    gint formatArg;			//!< Argument kind of \a toStringFormat, see ::MKDG_FORMAT_ARG.
+    gchar **validValues;		//!< Names of #MKDG_TYPE_ENUM values or #MKDG_TYPE_FLAGS bits. Can be \c NULL.
+    gint validValueCount;		//!< Number of strings in \a validValues.
+    gboolean compiled;			//!< Whether the codec is initialized.
+} MkdgValueCodec;
+
 /**
  * Type interface.
  *
@@ -101,8 +220,9 @@ typedef struct{
  * - extract(): Extract the content of a MkdgValue to an appointed pointer.
  * - set(): Set a value to MkdgValue.
  * - from_string() : parse value from string.
- * - to_string(): output value as a string.
+ * - format_into(): output value as a string to a caller-provided buffer.
  * - compare(): compare 2 values. See mkdg_value_compare() for details of return values.
+ * - hash(): hash a value. See mkdg_value_hash().
  */
 typedef struct{
     /**
@@ -156,20 +276,24 @@ typedef struct{
      * @param mValue 		MkdgValue that stores the result.
      * @param str   		String to be parse from. \c NULL or "" to assign type default,
      * such as 0 for numeric values.
-     * @param parseOption 	Option for parsing.
+     * @param codec 		Compiled options. Never \c NULL.
      * @return \a value if succeed; \c NULL if failed.
      */
-    MkdgValue *(* from_string) (MkdgValue *mValue, const gchar *str, const gchar *parseOption);
+    MkdgValue *(* from_string) (MkdgValue *mValue, const gchar *str, const MkdgValueCodec *codec);
 
     /**
-     * Output value as string callback function.
+     * Output value as string to a buffer callback function.
      *
-     * Output value as string callback function.
+     * Output value as string to a caller-provided buffer callback function.
+     * Like snprintf(), the output is truncated if it does not fit in \a bufSize.
      * @param mValue 		A MkdgValue.
-     * @param toStringFormat 	printf()-like format string.
-     * @return A newly allocated string which shows the value; \c NULL if failed.
+     * @param codec 		Compiled options. Never \c NULL.
+     * @param buf		Buffer to write to.
+     * @param bufSize		Size of \a buf, including the terminating '\\0'.
+     * @return Length of the full output, excluding the terminating '\\0'.
+     * @see mkdg_value_format_into()
      */
-    gchar *(* to_string) (MkdgValue *mValue, const gchar *toStringFormat);
+    gsize (* format_into) (MkdgValue *mValue, const MkdgValueCodec *codec, gchar *buf, gsize bufSize);
 
     /**
      * Compare value of two MkdgValues.
@@ -178,7 +302,7 @@ typedef struct{
      *
      * @param mValue1 	The first value.
      * @param mValue2 	The second value.
-     * @param compareOption Comparison option. Can be \c NULL.
+     * @param codec 	Compiled options. Never \c NULL.
      * @retval -3  if the values cannot be compared.
      * @retval -2 if the type is not supported.
      * @retval -1 if \a value1 \< \a value2.
@@ -186,7 +310,18 @@ typedef struct{
      * @retval 1 if \a value1 \> \a value2.
      * @see mkdg_value_compare()
      */
-    gint (* compare) (MkdgValue *mValue1, MkdgValue *mValue2, const gchar *compareOption);
+    gint (* compare) (MkdgValue *mValue1, MkdgValue *mValue2, const MkdgValueCodec *codec);
+
+    /**
+     * Hash a MkdgValue.
+     *
+     * Hash a MkdgValue.
+     * Values that compare equal with the default compare option must have the same hash.
+     * @param mValue 		A MkdgValue.
+     * @return The hash of \a mValue.
+     * @see mkdg_value_hash()
+     */
+    guint (* hash) (MkdgValue *mValue);
 
     /**
      * Free the MkdgValues.
@@ -235,6 +370,7 @@ MkdgValue *mkdg_value_new(MkdgType mType, gpointer setValue);
  *
  * New a MakerDialog value from a static content, such as static string.
  * This function does not set MKDG_VALUE_FLAG_NEED_FREE, regardless the value type.
+ * Strings parsed by mkdg_value_from_string() into such value are borrowed instead of copied.
  *
  * @param mType		MakerDialog type.
  * @param setValue	Value to be set. \c NULL for default value of each type.
@@ -242,18 +378,217 @@ MkdgValue *mkdg_value_new(MkdgType mType, gpointer setValue);
  */
 MkdgValue *mkdg_value_new_static(MkdgType mType, gpointer setValue);
 
+/**
+ * Initialize a caller-provided MakerDialog value.
+ *
+ * Initialize a caller-provided MakerDialog value, usually on stack,
+ * to the default value of \a mType.
+ * Like mkdg_value_new(), pointer types get MKDG_VALUE_FLAG_NEED_FREE.
+ * Release the content with mkdg_value_clear(), not mkdg_value_free().
+ *
+ * @param mValue	Storage of the MakerDialog value.
+ * @param mType		MakerDialog type.
+ * @return \a mValue if succeed; \c NULL if \a mType is not supported.
+ * @since 0.3
+ */
+MkdgValue *mkdg_value_init(MkdgValue *mValue, MkdgType mType);
+
+/**
+ * Initialize a caller-provided MakerDialog value for static content.
+ *
+ * Initialize a caller-provided MakerDialog value for static content.
+ * Like mkdg_value_new_static(), MKDG_VALUE_FLAG_NEED_FREE is not set,
+ * so parsing a string into it does not allocate.
+ * The value must not outlive the strings it borrows.
+ *
+ * @param mValue	Storage of the MakerDialog value.
+ * @param mType		MakerDialog type.
+ * @return \a mValue if succeed; \c NULL if \a mType is not supported.
+ * @since 0.3
+ */
+MkdgValue *mkdg_value_init_static(MkdgValue *mValue, MkdgType mType);
+
+/**
+ * Release the content of a MakerDialog value.
+ *
+ * Release the content of a MakerDialog value,
+ * but not the MkdgValue itself.
+ * Use it for values initialized by mkdg_value_init() or mkdg_value_init_static().
+ *
+ * @param mValue	The MakerDialog value to be cleared.
+ * @since 0.3
+ */
+void mkdg_value_clear(MkdgValue *mValue);
+
 /**
  * Copy a MakerDialog value to another.
  *
  * Copy a MakerDialog value to another.
  * This function returns \c FALSE if types of these values are not identical.
  *
+ * Owned strings, string lists and number arrays are immutable and reference-counted,
+ * so copying them only adds a reference, and \a destValue owns that reference.
+ * Call mkdg_value_make_writable() before modifying the content in place.
+ *
  * @param srcValue	A MakerDialog value to be copied from.
  * @param destValue	A MakerDialog value to be copied to.
  * @return \c TRUE if succeed; \c FALSE if types of these values are not identical.
  */
 gboolean mkdg_value_copy(MkdgValue *srcValue, MkdgValue *destValue);
 
+/**
+ * Intern the string of a MakerDialog value.
+ *
+ * Intern the string of a MakerDialog value.
+ * The string is replaced by its canonical copy from g_intern_string(),
+ * and the old copy is freed if the value owns it.
+ * Interned strings are shared by all values and specs, thus
+ * mkdg_value_copy() of an interned value only copies the pointer,
+ * and equal interned strings compare by pointer.
+ *
+ * Strings short enough to be stored inline are left as they are,
+ * and values of other types are not changed.
+ * This function is thread-safe as g_intern_string() is.
+ * @param mValue	A MakerDialog value.
+ * @return \a mValue for convenience.
+ * @since 0.3
+ */
+MkdgValue *mkdg_value_intern(MkdgValue *mValue);
+
+/**
+ * Make the content of a MakerDialog value writable.
+ *
+ * Make the content of a MakerDialog value writable.
+ * Strings, string lists and number arrays that are shared with other values
+ * (see mkdg_value_copy()) or interned are copied, so the content
+ * of \a mValue can be modified in place without affecting other values.
+ * Values of other types are not changed.
+ * @param mValue	A MakerDialog value that owns its content.
+ * @since 0.3
+ */
+void mkdg_value_make_writable(MkdgValue *mValue);
+
+/**
+ * New a packed string list.
+ *
+ * New a packed string list by copying strings in \a strList,
+ * and hash of each string is computed.
+ * @param strList	NULL-terminated string vector to be copied.
+ * @return A newly allocated packed string list.
+ * @see mkdg_string_list_free().
+ * @since 0.3
+ */
+MkdgStringList *mkdg_string_list_new(gchar **strList);
+
+/**
+ * Copy a packed string list.
+ *
+ * Copy a packed string list with a single memcpy().
+ * The copy is not shared, thus it can be modified.
+ * @param sList		Packed string list to be copied. Can be \c NULL.
+ * @return A newly allocated packed string list; or \c NULL if \a sList is \c NULL.
+ * @see mkdg_string_list_ref().
+ * @since 0.3
+ */
+MkdgStringList *mkdg_string_list_copy(const MkdgStringList *sList);
+
+/**
+ * Add a reference to a packed string list.
+ *
+ * Add a reference to a packed string list.
+ * This function is thread-safe.
+ * @param sList		Packed string list. Can be \c NULL.
+ * @return \a sList.
+ * @see mkdg_string_list_free().
+ * @since 0.3
+ */
+MkdgStringList *mkdg_string_list_ref(MkdgStringList *sList);
+
+/**
+ * Release a reference to a packed string list.
+ *
+ * Release a reference to a packed string list.
+ * The list is freed when the last reference is released.
+ * This function is thread-safe.
+ * @param sList		Packed string list to be freed. Can be \c NULL.
+ * @since 0.3
+ */
+void mkdg_string_list_free(MkdgStringList *sList);
+
+/**
+ * Return the cached hash of a string in a packed string list.
+ *
+ * Return the hash of the string at \a index, as g_str_hash() would return.
+ * @param sList		A packed string list.
+ * @param index		Index of the string, must be less than \a sList->count.
+ * @return Hash of the string.
+ * @since 0.3
+ */
+guint32 mkdg_string_list_get_hash(const MkdgStringList *sList, guint index);
+
+/**
+ * Find a string in a packed string list.
+ *
+ * Find a string in a packed string list.
+ * Cached hashes are compared first, so only strings with the same hash are compared.
+ * @param sList		A packed string list.
+ * @param str		String to be found.
+ * @return Index of the first string that equals \a str; or -1 if not found.
+ * @since 0.3
+ */
+gint mkdg_string_list_find(const MkdgStringList *sList, const gchar *str);
+
+/**
+ * New a packed number array.
+ *
+ * New a packed number array by copying \a count elements,
+ * and the hash of elements is computed.
+ * @param mType		#MKDG_TYPE_INT_ARRAY for \c gint64 elements,
+ * or #MKDG_TYPE_DOUBLE_ARRAY for \c gdouble elements.
+ * @param elements	Elements to be copied. \c NULL for \a count zeros.
+ * @param count		Number of elements.
+ * @return A newly allocated packed number array; or \c NULL if \a mType is not an array type.
+ * @see mkdg_number_array_free().
+ * @since 0.3
+ */
+MkdgNumberArray *mkdg_number_array_new(MkdgType mType, gconstpointer elements, guint count);
+
+/**
+ * Add a reference to a packed number array.
+ *
+ * Add a reference to a packed number array.
+ * This function is thread-safe.
+ * @param array		Packed number array. Can be \c NULL.
+ * @return \a array.
+ * @see mkdg_number_array_free().
+ * @since 0.3
+ */
+MkdgNumberArray *mkdg_number_array_ref(MkdgNumberArray *array);
+
+/**
+ * Release a reference to a packed number array.
+ *
+ * Release a reference to a packed number array.
+ * The array is freed when the last reference is released.
+ * This function is thread-safe.
+ * @param array		Packed number array to be freed. Can be \c NULL.
+ * @since 0.3
+ */
+void mkdg_number_array_free(MkdgNumberArray *array);
+
+/**
+ * Whether all elements of a packed number array are in a range.
+ *
+ * Whether all elements of a packed number array are between \a min and \a max, inclusively.
+ * The elements are scanned in one pass without branches, and NaN is never in range.
+ * @param array		Packed number array. \c NULL is deemed as empty.
+ * @param min		Minimum value.
+ * @param max		Maximum value.
+ * @return \c TRUE if all elements are in range, or the array is empty; \c FALSE otherwise.
+ * @since 0.3
+ */
+gboolean mkdg_number_array_in_range(const MkdgNumberArray *array, gdouble min, gdouble max);
+
 /**
  * Extract the content of a MkdgValue to an appointed pointer.
  *
@@ -356,21 +691,57 @@ gdouble mkdg_value_to_double(MkdgValue *value);
  *
  * This function returns the value if the setting is successful;
  * or \c NULL if type of value is not supported.
+ * Numeric values are parsed strictly by MakerDialogNumber.h functions,
+ * so \c NULL is also returned if \a str is not a valid number or out of range;
+ * in that case \a mValue holds 0 or the clamped value.
  *
  * Available Option:
  *  - Set base for \c MKDG_TYPE_INT, \c MKDG_TYPE_UINT, \c MKDG_TYPE_LONG, \c MKDG_TYPE_ULONG values:
- *    - Default is "10" (decimal).
+ *    - Default is detecting base from prefix: "0x" for hexadecimal, "0" for octal, otherwise decimal.
  *  - Others ignore \a parseOption.
  *
+ * \c MKDG_TYPE_ENUM values are parsed as decimal indices here,
+ * use mkdg_value_codec_from_string() with mkdg_value_codec_set_valid_values() for parsing names.
+ *
  *
  * @param mValue	A MakerDialog value.
  * @param str 		The string to be converted from.
  * @param parseOption	Additional parse control. Can be \c NULL.
- * @return The argument \a mValue if setting is successful; or \c NULL if type is not supported.
+ * @return The argument \a mValue if setting is successful; or \c NULL if type is not supported or \a str is invalid.
  * @see mkdg_value_to_string()
  */
 MkdgValue *mkdg_value_from_string(MkdgValue *mValue, const gchar *str, const gchar *parseOption);
 
+/**
+ * Buffer size that fits all non-string values.
+ *
+ * Buffer size that fits all MakerDialog values output with default format,
+ * except strings and string lists.
+ * @since 0.3
+ */
+#define MKDG_VALUE_FORMAT_BUFFER_SIZE	64
+
+/**
+ * Output a MakerDialog value to a caller-provided buffer.
+ *
+ * This function outputs a MakerDialog value to a caller-provided buffer
+ * without allocation.
+ * Parameter \a toStringFormat works as in mkdg_value_to_string().
+ *
+ * Like snprintf(), the output is truncated and always '\\0' terminated
+ * if it does not fit in \a bufSize.
+ * Compare the return value with \a bufSize to detect truncation.
+ *
+ * @param mValue		A MakerDialog value.
+ * @param toStringFormat	printf()-like format string. Can be \c NULL.
+ * @param buf			Buffer to write to.
+ * @param bufSize		Size of \a buf, including the terminating '\\0'.
+ * @return Length of the full output, excluding the terminating '\\0'.
+ * @see mkdg_value_to_string()
+ * @since 0.3
+ */
+gsize mkdg_value_format_into(MkdgValue *mValue, const gchar *toStringFormat, gchar *buf, gsize bufSize);
+
 /**
  * Output a MakerDialog value to a string.
  *
@@ -379,6 +750,9 @@ MkdgValue *mkdg_value_from_string(MkdgValue *mValue, const gchar *str, const gch
  * Its format is identical to the format string of printf().
  * Pass \c NULL for using default format for that type.
  *
+ * The default format of \c MKDG_TYPE_FLOAT and \c MKDG_TYPE_DOUBLE is
+ * the shortest string that parses back to the same value,
+ * see mkdg_number_format_double().
  *
  * @param mValue		A MakerDialog value.
  * @param toStringFormat	Custom printf()-like format string. Pass \c NULL for using default format for that type.
@@ -426,9 +800,16 @@ gchar *mkdg_string_normalized(const gchar *str, MkdgType mType);
  *  - Numeric types (e.g. MKDG_TYPE_INT, MKDG_TYPE_FLOAT): Natural order.
  *  - MKDG_TYPE_STRING: As in strcmp.
  *  - MKDG_TYPE_COLOR: Converted to unsigned integers with RRGGBB format, then do integer comparison.
+ *  - MKDG_TYPE_ENUM: Order of indices, i.e. the order of valid values.
+ *  - MKDG_TYPE_FLAGS: Masks are compared as unsigned integers.
+ *  - MKDG_TYPE_INT_ARRAY, MKDG_TYPE_DOUBLE_ARRAY: Shorter array is less,
+ *    arrays of the same length are compared element by element.
+ *  - MKDG_TYPE_BLOB: As mkdg_blob_compare().
  *
  * Numeric values can be compared each other, but MKDG_TYPE_BOOLEAN does not count as
  * number. Nor can number compare with string.
+ * Integers are compared exactly, even with floating point numbers or
+ * beyond the precision of double.
  *
  * -3 is returned if the values cannot be compared.
  * -2 is returned if the either of value types is not supported.
@@ -484,6 +865,169 @@ gint mkdg_value_compare(MkdgValue *mValue1, MkdgValue *mValue2, const gchar *com
  */
 gint mkdg_value_compare_with_func(MkdgValue *mValue1, MkdgValue *mValue2, MkdgCompareFunc compFunc);
 
+/**
+ * Hash a MakerDialog value.
+ *
+ * Hash a MakerDialog value.
+ * Values that are equal in mkdg_value_equal() have the same hash,
+ * including numbers of different types, such as 5 in MKDG_TYPE_INT and 5.0 in MKDG_TYPE_DOUBLE.
+ * The hash is stable, and cached in the payload of
+ * shared strings and string lists, so hashing them again is cheap.
+ *
+ * This function can be used as GHashFunc, see mkdg_value_equal().
+ * @param mValue 	A MakerDialog value.
+ * @return The hash of \a mValue; or 0 if the type is not supported.
+ * @since 0.3
+ */
+guint mkdg_value_hash(gconstpointer mValue);
+
+/**
+ * Whether two MakerDialog values are equal.
+ *
+ * Whether two MakerDialog values are equal, that is,
+ * mkdg_value_compare() with the default compare option returns 0.
+ * Cached hashes are compared first, so unequal strings and string lists
+ * are usually told apart without comparing the content.
+ *
+ * This function can be used as GEqualFunc, thus values can be stored in a hash set:
+ * @code
+ * GHashTable *valueSet=g_hash_table_new(mkdg_value_hash, mkdg_value_equal);
+ * @endcode
+ * @param mValue1 	The first value.
+ * @param mValue2 	The second value.
+ * @return \c TRUE if the values are equal; \c FALSE otherwise.
+ * @see mkdg_value_codec_equal()
+ * @since 0.3
+ */
+gboolean mkdg_value_equal(gconstpointer mValue1, gconstpointer mValue2);
+
+/**
+ * Compile options into a codec.
+ *
+ * This function interprets the option strings once and stores the result in \a codec:
+ *  - \a parseOption: base of integer types (e.g. "16"), or delimiters of string list.
+ *  - \a toStringFormat: validated against \a mType. It must contain exactly one
+ *    conversion that suits the type, such as "%05d" for numbers or "[%s]" for strings.
+ *    Invalid format is silently ignored, and the default format is used.
+ *    mkdg_property_spec_compile() warns about it once per spec.
+ *  - \a compareOption: ';' separated flags, such as "icase".
+ *
+ * The strings are borrowed, so they must outlive \a codec.
+ * No memory is allocated.
+ *
+ * @param codec			Codec to be initialized.
+ * @param mType			Type of values that the codec handles.
+ * @param parseOption		Parse option. Can be \c NULL.
+ * @param toStringFormat	printf()-like format string. Can be \c NULL.
+ * @param compareOption		Comparison option. Can be \c NULL.
+ * @return \a codec.
+ * @since 0.3
+ */
+MkdgValueCodec *mkdg_value_codec_init(MkdgValueCodec *codec, MkdgType mType,
+	const gchar *parseOption, const gchar *toStringFormat, const gchar *compareOption);
+
+/**
+ * Maximum number of named bits of #MKDG_TYPE_FLAGS.
+ *
+ * Maximum number of named bits of #MKDG_TYPE_FLAGS.
+ * Valid values beyond this are ignored.
+ * @since 0.3
+ */
+#define MKDG_FLAGS_BIT_MAX	64
+
+/**
+ * Set the names of enumeration values or flag bits to a codec.
+ *
+ * Set the names of #MKDG_TYPE_ENUM values or #MKDG_TYPE_FLAGS bits to a codec.
+ * An enumeration value is the index of its name in \a validValues,
+ * so the codec parses a name to its index and outputs an index as its name.
+ * If names are not set, enumeration values are parsed and output as decimal indices.
+ *
+ * Similarly, bit \c i of a flags value is named \a validValues[i].
+ * Flags are parsed as in mkdg_flag_parse(), i.e. names separated by
+ * spaces, tabs, '|' or ';', and output as names joined by '|', such as "A|B|C".
+ * Bits without names are parsed and output as numbers, such as "0x100".
+ *
+ * Like other options, \a validValues is borrowed and must outlive \a codec.
+ * mkdg_value_codec_init() clears the names.
+ * @param codec		A compiled codec.
+ * @param validValues	NULL-terminated names of enumeration values. Can be \c NULL.
+ * @return \a codec.
+ * @since 0.3
+ */
+MkdgValueCodec *mkdg_value_codec_set_valid_values(MkdgValueCodec *codec, gchar **validValues);
+
+/**
+ * Set the content of MakerDialog value from a string with a codec.
+ *
+ * This function works as mkdg_value_from_string(), but the parse option
+ * is taken from \a codec.
+ * @param codec		A compiled codec.
+ * @param mValue	A MakerDialog value.
+ * @param str 		The string to be converted from.
+ * @return The argument \a mValue if setting is successful; or \c NULL if type is not supported or \a str is invalid.
+ * @see mkdg_value_from_string()
+ * @since 0.3
+ */
+MkdgValue *mkdg_value_codec_from_string(const MkdgValueCodec *codec, MkdgValue *mValue, const gchar *str);
+
+/**
+ * Output a MakerDialog value to a caller-provided buffer with a codec.
+ *
+ * This function works as mkdg_value_format_into(), but the format
+ * is taken from \a codec.
+ * @param codec		A compiled codec.
+ * @param mValue	A MakerDialog value.
+ * @param buf		Buffer to write to.
+ * @param bufSize	Size of \a buf, including the terminating '\\0'.
+ * @return Length of the full output, excluding the terminating '\\0'.
+ * @see mkdg_value_format_into()
+ * @since 0.3
+ */
+gsize mkdg_value_codec_format_into(const MkdgValueCodec *codec, MkdgValue *mValue, gchar *buf, gsize bufSize);
+
+/**
+ * Output a MakerDialog value to a string with a codec.
+ *
+ * This function works as mkdg_value_to_string(), but the format
+ * is taken from \a codec.
+ * @param codec		A compiled codec.
+ * @param mValue	A MakerDialog value.
+ * @return The string representation of value; or \c NULL if the type is not supported.
+ * @see mkdg_value_to_string()
+ * @since 0.3
+ */
+gchar *mkdg_value_codec_to_string(const MkdgValueCodec *codec, MkdgValue *mValue);
+
+/**
+ * Compare value of two MakerDialog values with a codec.
+ *
+ * This function works as mkdg_value_compare(), but the compare option
+ * is taken from \a codec.
+ * @param codec		A compiled codec.
+ * @param mValue1 	The first value.
+ * @param mValue2 	The second value.
+ * @return See mkdg_value_compare().
+ * @see mkdg_value_compare()
+ * @since 0.3
+ */
+gint mkdg_value_codec_compare(const MkdgValueCodec *codec, MkdgValue *mValue1, MkdgValue *mValue2);
+
+/**
+ * Whether two MakerDialog values are equal with a codec.
+ *
+ * This function works as mkdg_value_equal(), but the compare option
+ * is taken from \a codec.
+ * Hashes are not used for case-insensitive comparison.
+ * @param codec		A compiled codec.
+ * @param mValue1 	The first value.
+ * @param mValue2 	The second value.
+ * @return \c TRUE if the values are equal; \c FALSE otherwise.
+ * @see mkdg_value_equal()
+ * @since 0.3
+ */
+gboolean mkdg_value_codec_equal(const MkdgValueCodec *codec, MkdgValue *mValue1, MkdgValue *mValue2);
+
 /**
  * Get a pointer value from a MakerDialog value.
  *
@@ -708,34 +1252,140 @@ gint mkdg_value_compare_with_func(MkdgValue *mValue1, MkdgValue *mValue2, MkdgCo
  * @param mValue A MakerDailog value.
  * @return the string value.
  */
-#define mkdg_value_get_string(mValue) 		mValue->data[0].v_string
+#define mkdg_value_get_string(mValue) 		(((mValue)->flags & MKDG_VALUE_FLAG_INLINE) ? \
+	(mValue)->data[0].v_inline : (mValue)->data[0].v_string)
 
 /**
  * Set a string value to a MakerDialog value.
  *
  * Set a string value to a MakerDialog value.
+ * The string is stored as pointer, use mkdg_value_set() for copying.
  * @param mValue A MakerDailog value.
  * @param setValue The value to be set.
  */
-#define mkdg_value_set_string(mValue, setValue)	mValue->data[0].v_string = setValue
+#define mkdg_value_set_string(mValue, setValue)	((mValue)->flags &= \
+	~(MKDG_VALUE_FLAG_INLINE | MKDG_VALUE_FLAG_INTERNED | MKDG_VALUE_FLAG_SHARED), \
+	(mValue)->data[0].v_string = (setValue))
+
+/**
+ * Get the packed string list from a MakerDialog value.
+ *
+ * Get the packed string list from a MakerDialog value.
+ * @param mValue A MakerDailog value.
+ * @return the packed string list, can be \c NULL.
+ * @since 0.3
+ */
+#define mkdg_value_get_packed_string_list(mValue)	((MkdgStringList *) (mValue)->data[0].v_pointer)
 
 /**
  * Get a string list value from a MakerDialog value.
  *
  * Get a string list value from a MakerDialog value.
+ * The returned vector is owned by \a mValue, and cannot be freed with g_strfreev().
  * @param mValue A MakerDailog value.
  * @return the string list value.
  */
-#define mkdg_value_get_string_list(mValue) 	mValue->data[0].v_string_list
+#define mkdg_value_get_string_list(mValue) 	((mkdg_value_get_packed_string_list(mValue)) ? \
+	mkdg_value_get_packed_string_list(mValue)->strv : NULL)
 
 /**
- * Set a string list value to a MakerDialog value.
+ * Get the number of strings in a string list value.
  *
- * Set a string list value to a MakerDialog value.
+ * Get the number of strings in a string list value, which is cached.
  * @param mValue A MakerDailog value.
- * @param setValue The value to be set.
+ * @return the number of strings.
+ * @since 0.3
  */
-#define mkdg_value_set_string_list(mValue, setValue)	mValue->data[0].v_string_list = setValue
+#define mkdg_value_get_string_list_length(mValue) 	((mkdg_value_get_packed_string_list(mValue)) ? \
+	mkdg_value_get_packed_string_list(mValue)->count : 0)
+
+/**
+ * Set a packed string list to a MakerDialog value.
+ *
+ * Set a packed string list to a MakerDialog value.
+ * The list is stored as pointer, use mkdg_value_set() for copying a string vector.
+ * @param mValue A MakerDailog value.
+ * @param setValue The packed string list (MkdgStringList) to be set.
+ */
+#define mkdg_value_set_string_list(mValue, setValue)	(mValue)->data[0].v_pointer = (setValue)
+
+/**
+ * Get the packed number array from a MakerDialog value.
+ *
+ * Get the packed number array from a MakerDialog value
+ * of #MKDG_TYPE_INT_ARRAY or #MKDG_TYPE_DOUBLE_ARRAY.
+ * @param mValue A MakerDailog value.
+ * @return the packed number array, can be \c NULL for empty array.
+ * @since 0.3
+ */
+#define mkdg_value_get_number_array(mValue)	((MkdgNumberArray *) (mValue)->data[0].v_pointer)
+
+/**
+ * Get the number of elements in an array value.
+ *
+ * Get the number of elements in a #MKDG_TYPE_INT_ARRAY or #MKDG_TYPE_DOUBLE_ARRAY value.
+ * @param mValue A MakerDailog value.
+ * @return the number of elements.
+ * @since 0.3
+ */
+#define mkdg_value_get_array_length(mValue) 	((mkdg_value_get_number_array(mValue)) ? \
+	mkdg_value_get_number_array(mValue)->count : 0)
+
+/**
+ * Get the elements of an integer array value.
+ *
+ * Get the elements of a #MKDG_TYPE_INT_ARRAY value.
+ * The elements are owned by \a mValue, and cannot be modified.
+ * @param mValue A MakerDailog value.
+ * @return the \c gint64 elements, can be \c NULL for empty array.
+ * @since 0.3
+ */
+#define mkdg_value_get_int_array(mValue) 	((mkdg_value_get_number_array(mValue)) ? \
+	(const gint64 *) mkdg_value_get_number_array(mValue)->elements.v_int64 : NULL)
+
+/**
+ * Get the elements of a double array value.
+ *
+ * Get the elements of a #MKDG_TYPE_DOUBLE_ARRAY value.
+ * The elements are owned by \a mValue, and cannot be modified.
+ * @param mValue A MakerDailog value.
+ * @return the \c gdouble elements, can be \c NULL for empty array.
+ * @since 0.3
+ */
+#define mkdg_value_get_double_array(mValue) 	((mkdg_value_get_number_array(mValue)) ? \
+	(const gdouble *) mkdg_value_get_number_array(mValue)->elements.v_double : NULL)
+
+/**
+ * Set a packed number array to a MakerDialog value.
+ *
+ * Set a packed number array to a MakerDialog value.
+ * The array is stored as pointer, use mkdg_value_set() for adding a reference.
+ * @param mValue A MakerDailog value.
+ * @param setValue The packed number array (MkdgNumberArray) to be set.
+ * @since 0.3
+ */
+#define mkdg_value_set_number_array(mValue, setValue)	(mValue)->data[0].v_pointer = (setValue)
+
+/**
+ * Get the blob from a MakerDialog value.
+ *
+ * Get the blob from a #MKDG_TYPE_BLOB value.
+ * @param mValue A MakerDailog value.
+ * @return the blob, can be \c NULL for empty data.
+ * @since 0.3
+ */
+#define mkdg_value_get_blob(mValue)	((MkdgBlob *) (mValue)->data[0].v_pointer)
+
+/**
+ * Set a blob to a MakerDialog value.
+ *
+ * Set a blob to a MakerDialog value.
+ * The blob is stored as pointer, use mkdg_value_set() for adding a reference.
+ * @param mValue A MakerDailog value.
+ * @param setValue The blob (MkdgBlob) to be set.
+ * @since 0.3
+ */
+#define mkdg_value_set_blob(mValue, setValue)	(mValue)->data[0].v_pointer = (setValue)
 
 /**
  * Get a color value from a MakerDialog value.
@@ -755,4 +1405,44 @@ gint mkdg_value_compare_with_func(MkdgValue *mValue1, MkdgValue *mValue2, MkdgCo
  */
 #define mkdg_value_set_color(mValue, setValue)	mValue->data[0].v_uint32 = setValue
 
+/**
+ * Get an enumeration value from a MakerDialog value.
+ *
+ * Get an enumeration value, that is, the index of valid values, from a MakerDialog value.
+ * @param mValue A MakerDailog value.
+ * @return The index.
+ * @since 0.3
+ */
+#define mkdg_value_get_enum(mValue) 		mValue->data[0].v_int
+
+/**
+ * Set an enumeration value to a MakerDialog value.
+ *
+ * Set an enumeration value, that is, the index of valid values, to a MakerDialog value.
+ * @param mValue A MakerDailog value.
+ * @param setValue The index to be set.
+ * @since 0.3
+ */
+#define mkdg_value_set_enum(mValue, setValue)	mValue->data[0].v_int = setValue
+
+/**
+ * Get a flags value from a MakerDialog value.
+ *
+ * Get a flags value, that is, the 64-bit mask, from a MakerDialog value.
+ * @param mValue A MakerDailog value.
+ * @return The mask.
+ * @since 0.3
+ */
+#define mkdg_value_get_flags(mValue) 		mValue->data[0].v_uint64
+
+/**
+ * Set a flags value to a MakerDialog value.
+ *
+ * Set a flags value, that is, the 64-bit mask, to a MakerDialog value.
+ * @param mValue A MakerDailog value.
+ * @param setValue The mask to be set.
+ * @since 0.3
+ */
+#define mkdg_value_set_flags(mValue, setValue)	mValue->data[0].v_uint64 = setValue
+
 #endif /* MKDG_TYPES_H_ */
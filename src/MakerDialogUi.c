@@ -77,7 +77,6 @@ gboolean mkdg_ui_update(MkdgUi *dlgUi, MkdgPropertyContext *ctx){
 	ret=FALSE;
     }else{
 	mkdg_property_set_value_fast(ctx, value, -2);
-	ctx->flags |= MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
 	mkdg_property_foreach_control_rule(ctx, mkdg_ui_each_control_rule, (gpointer) dlgUi );
     }
     mkdg_value_free(value);
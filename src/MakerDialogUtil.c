@@ -214,93 +214,185 @@ gboolean mkdg_string_is_empty(const gchar *str){
     return FALSE;
 }
 
-static gint mkdg_string_char_at(const gchar *str, gchar ch){
-    gint i;
-    for(i=0; str[i]!='\0'; i++){
-	if (str[i]==ch)
-	    return i;
+/*=== Start split and combine ===*/
+/*
+ * Delimiters and escape character are ASCII, and never match bytes of
+ * multi-byte UTF-8 characters, so strings are scanned bytewise with strcspn(),
+ * which is vectorized by most libc.
+ */
+
+/* Set of characters that stop a scan: delimiters followed by the escape character. */
+static gchar *mkdg_string_stop_set_init(gchar *stopSet, const gchar *delimiters, gchar escapeChar){
+    gsize len=strlen(delimiters);
+    memcpy(stopSet, delimiters, len);
+    stopSet[len]=escapeChar;
+    stopSet[len+1]='\0';
+    return stopSet;
+}
+
+/*
+ * Scan a token from *strPtr, write the unescaped token to dest if it is not NULL.
+ * *strPtr is moved after the delimiter that ends the token.
+ * Returns the length of the token,
+ * and set *endByDelimiter to whether the token is ended by a delimiter.
+ */
+static gsize mkdg_string_token_scan(const gchar **strPtr, const gchar *stopSet, gchar escapeChar,
+	gchar *dest, gboolean *endByDelimiter){
+    const gchar *chPtr=*strPtr;
+    gsize len=0;
+    *endByDelimiter=FALSE;
+    while(TRUE){
+	gsize n=strcspn(chPtr, stopSet);
+	if (dest){
+	    memcpy(dest+len, chPtr, n);
+	}
+	len+=n;
+	chPtr+=n;
+	if (*chPtr=='\0'){
+	    break;
+	}else if (*chPtr==escapeChar){
+	    /* Character after escape character is taken literally */
+	    chPtr++;
+	    if (*chPtr=='\0')
+		break;
+	    if (dest){
+		dest[len]=*chPtr;
+	    }
+	    len++;
+	    chPtr++;
+	}else{
+	    chPtr++;
+	    *endByDelimiter=TRUE;
+	    break;
+	}
     }
-    return -1;
+    *strPtr=chPtr;
+    return len;
 }
 
+/*
+ * Whether next token is the last token, thus delimiters should be taken literally.
+ */
+#define mkdg_string_is_last_token(maxTokens, tokenCount) (maxTokens>0 && tokenCount>=maxTokens-1)
+
 gchar **mkdg_string_split_set
 (const gchar *str, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gint maxTokens){
     g_return_val_if_fail (str != NULL, NULL);
     g_return_val_if_fail (delimiters != NULL, NULL);
+    gchar *stopSet=mkdg_string_stop_set_init(g_alloca(strlen(delimiters)+2), delimiters, escapeChar);
+    gchar *escapeSet=stopSet+strlen(delimiters);
     GPtrArray *ptrArray=g_ptr_array_new();
-    gint tokenCount=0;
-    gchar *chPtr=(gchar *)str;
-    GString *strBuf=g_string_new("");
-    while(*chPtr!='\0'){
-	if (*chPtr==escapeChar){
-	    chPtr++;
-	}else if (mkdg_string_char_at(delimiters, *chPtr)>=0){
-	    if (maxTokens<0 || tokenCount<maxTokens-1){
-		/* Can have more tokens */
-		if (emptyToken || strBuf->len){
-		    /* A valid token */
-		    g_ptr_array_add(ptrArray,g_string_free(strBuf,FALSE));
-		    tokenCount++;
-		    strBuf=g_string_new("");
-		}
-		chPtr++;
-		continue;
-	    }
-	}
-	gunichar wch=g_utf8_get_char(chPtr);
-	if (wch){
-	    g_string_append_unichar(strBuf,wch);
-	    chPtr=g_utf8_next_char(chPtr);
-	}else{
-	    g_warning("mkdg_string_split_set(): Invalid format. str=%s",str);
+    const gchar *chPtr=str;
+    gboolean endByDelimiter=TRUE;
+    while(endByDelimiter){
+	const gchar *tokenStart=chPtr;
+	const gchar *scanSet=(mkdg_string_is_last_token(maxTokens, ptrArray->len)) ? escapeSet : stopSet;
+	gsize len=mkdg_string_token_scan(&chPtr, scanSet, escapeChar, NULL, &endByDelimiter);
+	if (emptyToken || len){
+	    /* A valid token, scan again to copy with exact size */
+	    gchar *token=g_new(gchar, len+1);
+	    mkdg_string_token_scan(&tokenStart, scanSet, escapeChar, token, &endByDelimiter);
+	    token[len]='\0';
+	    g_ptr_array_add(ptrArray, token);
 	}
     }
-
-    /* Pick up the rest of the string */
-    g_assert(strBuf);
-    if (emptyToken || strBuf->len){
-	/* A valid token */
-	g_ptr_array_add(ptrArray,g_string_free(strBuf,FALSE));
-	tokenCount++;
-    }else{
-	g_string_free(strBuf,TRUE);
-    }
     g_ptr_array_add(ptrArray, NULL);
     return (gchar **) g_ptr_array_free(ptrArray, FALSE);
 }
 
-gchar *mkdg_string_list_combine
-(gchar **strList, const gchar *delimiters, gchar escapeChar, gboolean emptyToken){
-    g_return_val_if_fail (strList != NULL, NULL);
+gchar **mkdg_string_split_set_packed
+(const gchar *str, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gint maxTokens){
+    g_return_val_if_fail (str != NULL, NULL);
     g_return_val_if_fail (delimiters != NULL, NULL);
-    GString *strBuf=g_string_new(NULL);
+    gchar *stopSet=mkdg_string_stop_set_init(g_alloca(strlen(delimiters)+2), delimiters, escapeChar);
+    gchar *escapeSet=stopSet+strlen(delimiters);
+    const gchar *chPtr=str;
+    gboolean endByDelimiter=TRUE;
+    gsize tokenCount=0, totalLen=0;
+
+    /* First pass: count tokens and bytes */
+    while(endByDelimiter){
+	gsize len=mkdg_string_token_scan(&chPtr,
+		(mkdg_string_is_last_token(maxTokens, tokenCount)) ? escapeSet : stopSet,
+		escapeChar, NULL, &endByDelimiter);
+	if (emptyToken || len){
+	    tokenCount++;
+	    totalLen+=len+1;
+	}
+    }
+
+    /* Second pass: write pointers and tokens in one block */
+    gchar **result=(gchar **) g_malloc(sizeof(gchar *)*(tokenCount+1)+totalLen);
+    gchar *dest=(gchar *) (result+tokenCount+1);
+    gsize i=0;
+    chPtr=str;
+    endByDelimiter=TRUE;
+    while(endByDelimiter){
+	gsize len=mkdg_string_token_scan(&chPtr,
+		(mkdg_string_is_last_token(maxTokens, i)) ? escapeSet : stopSet,
+		escapeChar, dest, &endByDelimiter);
+	if (emptyToken || len){
+	    dest[len]='\0';
+	    result[i++]=dest;
+	    dest+=len+1;
+	}
+    }
+    result[i]=NULL;
+    return result;
+}
+
+/*
+ * Put chars to buf, only count them when buf is full.
+ */
+static void mkdg_string_buffer_put(gchar *buf, gsize bufSize, gsize *len, const gchar *str, gsize n){
+    if (*len+1<bufSize){
+	gsize avail=bufSize-1-*len;
+	memcpy(buf+*len, str, (n<avail) ? n : avail);
+    }
+    *len+=n;
+}
+
+gsize mkdg_string_list_combine_into
+(gchar **strList, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gchar *buf, gsize bufSize){
+    gchar *stopSet=mkdg_string_stop_set_init(g_alloca(strlen(delimiters)+2), delimiters, escapeChar);
+    gsize len=0;
     gint i;
-    gchar *chPtr;
+    const gchar *chPtr;
     gboolean isPrevEmpty=TRUE;
     for(i=0;strList[i]!=NULL; i++){
-	if (!isPrevEmpty){
-	    g_string_append_c(strBuf, delimiters[0]);
+	if (i>0 && (emptyToken || !isPrevEmpty)){
+	    mkdg_string_buffer_put(buf, bufSize, &len, delimiters, 1);
 	}
-	chPtr=(gchar *) strList[i];
-	if (*chPtr!='\0'){
-	    isPrevEmpty=FALSE;
-	    while(*chPtr!='\0'){
-		if (mkdg_string_char_at(delimiters, *chPtr)>=0){
-		    g_string_append_c(strBuf,escapeChar);
-		}else if (*chPtr==escapeChar){
-		    g_string_append_c(strBuf,escapeChar);
-		}
-		gunichar wch=g_utf8_get_char(chPtr);
-		g_string_append_unichar(strBuf,wch);
-		chPtr=g_utf8_next_char(chPtr);
+	chPtr=strList[i];
+	isPrevEmpty=(*chPtr=='\0');
+	while(*chPtr!='\0'){
+	    gsize n=strcspn(chPtr, stopSet);
+	    mkdg_string_buffer_put(buf, bufSize, &len, chPtr, n);
+	    chPtr+=n;
+	    if (*chPtr!='\0'){
+		/* Escape delimiter or escape character */
+		mkdg_string_buffer_put(buf, bufSize, &len, &escapeChar, 1);
+		mkdg_string_buffer_put(buf, bufSize, &len, chPtr, 1);
+		chPtr++;
 	    }
-	}else{
-	    /* Empty string */
-	    isPrevEmpty=TRUE;
 	}
     }
-    return g_string_free(strBuf,FALSE);
+    if (bufSize>0){
+	buf[(len<bufSize) ? len : bufSize-1]='\0';
+    }
+    return len;
+}
+
+gchar *mkdg_string_list_combine
+(gchar **strList, const gchar *delimiters, gchar escapeChar, gboolean emptyToken){
+    g_return_val_if_fail (strList != NULL, NULL);
+    g_return_val_if_fail (delimiters != NULL, NULL);
+    gsize len=mkdg_string_list_combine_into(strList, delimiters, escapeChar, emptyToken, NULL, 0);
+    gchar *result=g_new(gchar, len+1);
+    mkdg_string_list_combine_into(strList, delimiters, escapeChar, emptyToken, result, len+1);
+    return result;
 }
+/*=== End split and combine ===*/
 
 gboolean mkdg_has_all_flags(guint flagSet, guint specFlags){
     return ((~(flagSet & specFlags)) & specFlags)? FALSE : TRUE;
@@ -64,6 +64,7 @@ typedef union {
     gchar	*v_string;		//!< For strings.
     gchar	**v_string_list;	//!< For list of strings.
     gpointer    v_pointer;		//!< For generic pointers.
+    gchar	v_inline[8];		//!< For short strings that stored in the holder itself.
 } MkdgValueHolder;
 
 /**
@@ -353,6 +354,29 @@ gboolean mkdg_string_is_empty(const gchar *str);
 gchar **mkdg_string_split_set
 (const gchar *str, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gint maxTokens);
 
+/**
+ * Splits string on unescaped delimiter characters into a single block.
+ *
+ * This function works as mkdg_string_split_set(),
+ * but the returned vector and all its strings are placed in one allocation,
+ * which is sized before copying.
+ * It suits long lists, such as phrase lists with tens of thousands of entries.
+ *
+ * Use g_free() on the returned vector to free it, <b>not</b> g_strfreev().
+ * Strings in the vector cannot be freed individually.
+ *
+ * @param str 		String to be split.
+ * @param delimiters	A set of characters to split the string.
+ * @param escapeChar	The escape character.
+ * @param emptyToken	Allow empty token.
+ * @param maxTokens	The maximum number of tokens to split string into. If this is less than 1, the string is split completely.
+ * @return A newly-allocated NULL-terminated array of strings; or NULL if either \a str or \a delimiters is \c NULL.
+ * @see mkdg_string_split_set()
+ * @since 0.3
+ */
+gchar **mkdg_string_split_set_packed
+(const gchar *str, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gint maxTokens);
+
 /**
  * Combine a listed of strings into a single string with delimiters.
  *
@@ -374,6 +398,27 @@ gchar **mkdg_string_split_set
 gchar *mkdg_string_list_combine
 (gchar **strList, const gchar *delimiters, gchar escapeChar, gboolean emptyToken);
 
+/**
+ * Combine a listed of strings into a caller-provided buffer.
+ *
+ * This function works as mkdg_string_list_combine(), but writes the result to \a buf
+ * without allocation.
+ * Like snprintf(), the output is truncated and always '\\0' terminated
+ * if it does not fit in \a bufSize.
+ *
+ * @param strList	List of string to be combined.
+ * @param delimiters	A set of characters to split the string.
+ * @param escapeChar	The escape character.
+ * @param emptyToken	Insert delimiters around empty string as well.
+ * @param buf		Buffer to write to.
+ * @param bufSize	Size of \a buf, including the terminating '\\0'.
+ * @return Length of the full result, excluding the terminating '\\0'.
+ * @see mkdg_string_list_combine()
+ * @since 0.3
+ */
+gsize mkdg_string_list_combine_into
+(gchar **strList, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gchar *buf, gsize bufSize);
+
 /**
  * Whether a set of flags contains all the specified flags.
  *
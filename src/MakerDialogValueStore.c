@@ -0,0 +1,279 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <math.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+/* Custom pointers are compared as scalars */
+static gboolean md_value_store_has_payload(MkdgType mType){
+    return (mType!=MKDG_TYPE_POINTER && mkdg_type_is_pointer(mType)) ? TRUE : FALSE;
+}
+
+/* As md_number_array_canonicalize(), doubles that compare equal get the same bits */
+static guint64 md_value_store_double_bits(gdouble number){
+    union{
+	gdouble	v_double;
+	guint64	v_uint64;
+    } bits;
+    if (number==0.0){
+	number=0.0;
+    }else if (isnan(number)){
+	number=NAN;
+    }
+    bits.v_double=number;
+    return bits.v_uint64;
+}
+
+static gdouble md_value_store_bits_double(guint64 scalar){
+    union{
+	gdouble	v_double;
+	guint64	v_uint64;
+    } bits;
+    bits.v_uint64=scalar;
+    return bits.v_double;
+}
+
+static guint64 md_value_store_scalar(MkdgValue *mValue){
+    switch(mValue->mType){
+	case MKDG_TYPE_POINTER:
+	    return (guint64) (gsize) mkdg_value_get_pointer(mValue);
+	case MKDG_TYPE_BOOLEAN:
+	    return (mkdg_value_get_boolean(mValue)) ? 1 : 0;
+	case MKDG_TYPE_INT:
+	    return (guint64) (gint64) mkdg_value_get_int(mValue);
+	case MKDG_TYPE_UINT:
+	    return mkdg_value_get_uint(mValue);
+	case MKDG_TYPE_INT32:
+	    return (guint64) (gint64) mkdg_value_get_int32(mValue);
+	case MKDG_TYPE_UINT32:
+	    return mkdg_value_get_uint32(mValue);
+	case MKDG_TYPE_INT64:
+	    return (guint64) mkdg_value_get_int64(mValue);
+	case MKDG_TYPE_UINT64:
+	    return mkdg_value_get_uint64(mValue);
+	case MKDG_TYPE_LONG:
+	    return (guint64) (gint64) mkdg_value_get_long(mValue);
+	case MKDG_TYPE_ULONG:
+	    return mkdg_value_get_ulong(mValue);
+	case MKDG_TYPE_FLOAT:
+	    return md_value_store_double_bits(mkdg_value_get_float(mValue));
+	case MKDG_TYPE_DOUBLE:
+	    return md_value_store_double_bits(mkdg_value_get_double(mValue));
+	case MKDG_TYPE_COLOR:
+	    return mkdg_value_get_color(mValue);
+	case MKDG_TYPE_ENUM:
+	    return (guint64) (gint64) mkdg_value_get_enum(mValue);
+	case MKDG_TYPE_FLAGS:
+	    return mkdg_value_get_flags(mValue);
+	default:
+	    break;
+    }
+    if (md_value_store_has_payload(mValue->mType))
+	return mkdg_value_hash(mValue);
+    return 0;
+}
+
+/* Inverse of md_value_store_scalar() for types without payload */
+static void md_value_store_load_scalar(MkdgValue *mValue, guint64 scalar){
+    switch(mValue->mType){
+	case MKDG_TYPE_POINTER:
+	    mkdg_value_set_pointer(mValue, (gpointer) (gsize) scalar);
+	    break;
+	case MKDG_TYPE_BOOLEAN:
+	    mkdg_value_set_boolean(mValue, (scalar) ? TRUE : FALSE);
+	    break;
+	case MKDG_TYPE_INT:
+	    mkdg_value_set_int(mValue, (gint) scalar);
+	    break;
+	case MKDG_TYPE_UINT:
+	    mkdg_value_set_uint(mValue, (guint) scalar);
+	    break;
+	case MKDG_TYPE_INT32:
+	    mkdg_value_set_int32(mValue, (gint32) scalar);
+	    break;
+	case MKDG_TYPE_UINT32:
+	    mkdg_value_set_uint32(mValue, (guint32) scalar);
+	    break;
+	case MKDG_TYPE_INT64:
+	    mkdg_value_set_int64(mValue, (gint64) scalar);
+	    break;
+	case MKDG_TYPE_UINT64:
+	    mkdg_value_set_uint64(mValue, scalar);
+	    break;
+	case MKDG_TYPE_LONG:
+	    mkdg_value_set_long(mValue, (glong) scalar);
+	    break;
+	case MKDG_TYPE_ULONG:
+	    mkdg_value_set_ulong(mValue, (gulong) scalar);
+	    break;
+	case MKDG_TYPE_FLOAT:
+	    mkdg_value_set_float(mValue, (gfloat) md_value_store_bits_double(scalar));
+	    break;
+	case MKDG_TYPE_DOUBLE:
+	    mkdg_value_set_double(mValue, md_value_store_bits_double(scalar));
+	    break;
+	case MKDG_TYPE_COLOR:
+	    mkdg_value_set_color(mValue, (MkdgColor) scalar);
+	    break;
+	case MKDG_TYPE_ENUM:
+	    mkdg_value_set_enum(mValue, (gint) scalar);
+	    break;
+	case MKDG_TYPE_FLAGS:
+	    mkdg_value_set_flags(mValue, scalar);
+	    break;
+	default:
+	    break;
+    }
+}
+
+/* Whether the stored value of id equals to mValue */
+static gboolean md_value_store_equal_at(MkdgValueStore *store, guint id, MkdgValue *mValue){
+    if (store->types[id]!=mValue->mType || store->scalars[id]!=md_value_store_scalar(mValue))
+	return FALSE;
+    if (md_value_store_has_payload(mValue->mType))
+	return mkdg_value_equal(&store->payloads[id], mValue);
+    return TRUE;
+}
+
+MkdgValueStore *mkdg_value_store_new(guint count){
+    MkdgValueStore *store=g_new(MkdgValueStore, 1);
+    guint i;
+    store->count=count;
+    store->types=g_new(gint8, MAX(count, 1));
+    store->flags=g_new0(guint8, MAX(count, 1));
+    store->scalars=g_new0(guint64, MAX(count, 1));
+    store->payloads=g_new0(MkdgValue, MAX(count, 1));
+    for(i=0;i<count;i++){
+	store->types[i]=MKDG_TYPE_NONE;
+    }
+    return store;
+}
+
+MkdgValueStore *mkdg_value_store_snapshot(Mkdg *mDialog){
+    guint i, count=mkdg_get_property_count(mDialog);
+    MkdgValueStore *store=mkdg_value_store_new(count);
+    for(i=0;i<count;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, i);
+	mkdg_value_store_set(store, i, ctx->value);
+	store->flags[i]=(guint8) ctx->flags;
+    }
+    return store;
+}
+
+MkdgValueStore *mkdg_value_store_new_defaults(Mkdg *mDialog){
+    guint i, count=mkdg_get_property_count(mDialog);
+    MkdgValueStore *store=mkdg_value_store_new(count);
+    for(i=0;i<count;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, i);
+	mkdg_value_store_set(store, i, (MkdgValue *) mkdg_property_spec_get_default_value(ctx->spec));
+    }
+    return store;
+}
+
+void mkdg_value_store_free(MkdgValueStore *store){
+    guint i;
+    for(i=0;i<store->count;i++){
+	if (md_value_store_has_payload(store->types[i]))
+	    mkdg_value_clear(&store->payloads[i]);
+    }
+    g_free(store->payloads);
+    g_free(store->scalars);
+    g_free(store->flags);
+    g_free(store->types);
+    g_free(store);
+}
+
+void mkdg_value_store_set(MkdgValueStore *store, MkdgPropertyHandle id, MkdgValue *mValue){
+    g_assert(id>=0 && (guint) id<store->count);
+    if (md_value_store_has_payload(store->types[id]))
+	mkdg_value_clear(&store->payloads[id]);
+    store->types[id]=mValue->mType;
+    store->scalars[id]=md_value_store_scalar(mValue);
+    if (md_value_store_has_payload(mValue->mType)){
+	/* Shares the content of mValue */
+	mkdg_value_init(&store->payloads[id], mValue->mType);
+	mkdg_value_copy(mValue, &store->payloads[id]);
+    }
+}
+
+gboolean mkdg_value_store_get(MkdgValueStore *store, MkdgPropertyHandle id, MkdgValue *mValue){
+    if (id<0 || (guint) id>=store->count || store->types[id]!=mValue->mType)
+	return FALSE;
+    if (md_value_store_has_payload(mValue->mType))
+	return mkdg_value_copy(&store->payloads[id], mValue);
+    md_value_store_load_scalar(mValue, store->scalars[id]);
+    return TRUE;
+}
+
+guint mkdg_value_store_restore(MkdgValueStore *store, Mkdg *mDialog){
+    guint i, setCount=0, count=MIN(store->count, mkdg_get_property_count(mDialog));
+    for(i=0;i<count;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, i);
+	if (store->types[i]!=ctx->value->mType || md_value_store_equal_at(store, i, ctx->value))
+	    continue;
+	if (md_value_store_has_payload(store->types[i])){
+	    mkdg_set_value_by_handle(mDialog, i, &store->payloads[i]);
+	}else{
+	    MkdgValue mValue;
+	    mkdg_value_init_static(&mValue, store->types[i]);
+	    md_value_store_load_scalar(&mValue, store->scalars[i]);
+	    mkdg_set_value_by_handle(mDialog, i, &mValue);
+	}
+	setCount++;
+    }
+    MKDG_DEBUG_MSG(3, "[I3] value_store_restore( , ) %u of %u set", setCount, count);
+    return setCount;
+}
+
+guint mkdg_value_store_diff(MkdgValueStore *store1, MkdgValueStore *store2, MkdgPropertyHandle *ids){
+    guint i, diffCount=0;
+    guint count=MIN(store1->count, store2->count);
+    for(i=0;i<count;i++){
+	/* Scan the columns first, payloads are compared only if the hashes are equal */
+	gboolean differ=(store1->types[i]!=store2->types[i]) | (store1->scalars[i]!=store2->scalars[i]);
+	if (!differ && md_value_store_has_payload(store1->types[i])){
+	    differ=!mkdg_value_equal(&store1->payloads[i], &store2->payloads[i]);
+	}
+	if (differ){
+	    if (ids)
+		ids[diffCount]=i;
+	    diffCount++;
+	}
+    }
+    for(;i<MAX(store1->count, store2->count);i++){
+	if (ids)
+	    ids[diffCount]=i;
+	diffCount++;
+    }
+    return diffCount;
+}
+
+guint mkdg_value_store_find_flags(MkdgValueStore *store, MkdgPropertyContextFlags flags, MkdgPropertyHandle *ids){
+    guint i, foundCount=0;
+    for(i=0;i<store->count;i++){
+	if (store->flags[i] & flags){
+	    if (ids)
+		ids[foundCount]=i;
+	    foundCount++;
+	}
+    }
+    return foundCount;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of Mkdg.
+ *
+ *  Mkdg is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Mkdg is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Mkdg.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file MakerDialogValueStore.h
+ * Column store of property values.
+ *
+ * This file lists the functions of MkdgValueStore, which keeps the values
+ * of all properties of a Mkdg in contiguous columns indexed by property id,
+ * for taking snapshots and comparing them in bulk.
+ * @since 0.3
+ */
+#ifndef MKDG_VALUE_STORE_H_
+#define MKDG_VALUE_STORE_H_
+#include <glib.h>
+#include "MakerDialogTypes.h"
+#include "MakerDialogProperty.h"
+
+/**
+ * Column store of property values.
+ *
+ * Value of property with id \a i is stored in \a types[i], \a scalars[i]
+ * and, for values with payload, \a payloads[i].
+ * Scalars are in a canonical 64-bit form: integers are extended to 64 bits,
+ * and floating point numbers are stored as bits of doubles, with -0.0 turned to 0.0
+ * and a single NaN representation.
+ * For strings, string lists, number arrays and blobs, the scalar is the hash
+ * of the value, and the payload is a value that shares the content
+ * of the property value, so taking a snapshot does not copy strings.
+ *
+ * Thus two stores are compared by scanning \a types and \a scalars,
+ * and only payloads with equal hashes are compared further.
+ *
+ * \a flags keeps the property context flags at the time of snapshot,
+ * see mkdg_value_store_find_flags().
+ * @since 0.3
+ */
+typedef struct{
+    guint	count;		//!< Number of properties.
+    gint8	*types;		//!< Column of value types.
+    guint8	*flags;		//!< Column of property context flags.
+    guint64	*scalars;	//!< Column of scalars in canonical form, or hashes of payloads.
+    MkdgValue	*payloads;	//!< Column of values with payload. Only valid if the type has payload.
+} MkdgValueStore;
+
+/**
+ * New an empty value store.
+ *
+ * New a value store of \a count properties, which are all of #MKDG_TYPE_NONE.
+ * @param count		Number of properties.
+ * @return A newly allocated MkdgValueStore.
+ * @see mkdg_value_store_free()
+ * @since 0.3
+ */
+MkdgValueStore *mkdg_value_store_new(guint count);
+
+/**
+ * Take a snapshot of the property values.
+ *
+ * Take a snapshot of the values and context flags of all properties in \a mDialog.
+ * @param mDialog	A Mkdg.
+ * @return A newly allocated MkdgValueStore.
+ * @see mkdg_value_store_restore()
+ * @since 0.3
+ */
+MkdgValueStore *mkdg_value_store_snapshot(Mkdg *mDialog);
+
+/**
+ * New a value store of default values.
+ *
+ * New a value store which holds the default value of each property in \a mDialog,
+ * and no flags.
+ * Comparing it with a snapshot finds the properties that are not default.
+ * @param mDialog	A Mkdg.
+ * @return A newly allocated MkdgValueStore.
+ * @see mkdg_property_spec_get_default_value()
+ * @since 0.3
+ */
+MkdgValueStore *mkdg_value_store_new_defaults(Mkdg *mDialog);
+
+/**
+ * Free a value store.
+ *
+ * Free a value store and release the payloads it shares.
+ * @param store		A MkdgValueStore.
+ * @since 0.3
+ */
+void mkdg_value_store_free(MkdgValueStore *store);
+
+/**
+ * Store a value.
+ *
+ * Store \a mValue as the value of property \a id.
+ * @param store		A MkdgValueStore.
+ * @param id		Id of property.
+ * @param mValue	Value to be stored.
+ * @since 0.3
+ */
+void mkdg_value_store_set(MkdgValueStore *store, MkdgPropertyHandle id, MkdgValue *mValue);
+
+/**
+ * Get a stored value.
+ *
+ * Copy the stored value of property \a id to \a mValue,
+ * which should be initialized as the same type.
+ * @param store		A MkdgValueStore.
+ * @param id		Id of property.
+ * @param mValue	Value to be copied to.
+ * @return \c TRUE if succeed; \c FALSE if \a id is out of range, or types are not identical.
+ * @since 0.3
+ */
+gboolean mkdg_value_store_get(MkdgValueStore *store, MkdgPropertyHandle id, MkdgValue *mValue);
+
+/**
+ * Restore the property values from a value store.
+ *
+ * Set the properties of \a mDialog to the stored values with mkdg_set_value_by_handle(),
+ * skipping the properties whose values are already equal.
+ * Context flags are not restored.
+ * @param store		A MkdgValueStore, usually from mkdg_value_store_snapshot().
+ * @param mDialog	A Mkdg.
+ * @return Number of properties that are set.
+ * @since 0.3
+ */
+guint mkdg_value_store_restore(MkdgValueStore *store, Mkdg *mDialog);
+
+/**
+ * Find the properties whose values differ.
+ *
+ * Compare two value stores, and find the properties whose values differ.
+ * If the stores have different numbers of properties,
+ * the properties that only exist in one of them are deemed as different.
+ * @param store1	A MkdgValueStore.
+ * @param store2	Another MkdgValueStore.
+ * @param ids		Returned ids of differing properties in ascending order.
+ * It should hold as many ids as the larger store. Can be \c NULL for counting only.
+ * @return Number of differing properties.
+ * @since 0.3
+ */
+guint mkdg_value_store_diff(MkdgValueStore *store1, MkdgValueStore *store2, MkdgPropertyHandle *ids);
+
+/**
+ * Find the properties with some context flags.
+ *
+ * Find the properties which have any of \a flags, such as
+ * ::MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED for the modified but unsaved properties.
+ * @param store		A MkdgValueStore, usually from mkdg_value_store_snapshot().
+ * @param flags		Property context flags to be found.
+ * @param ids		Returned ids of found properties in ascending order.
+ * It should hold \a store-&gt;count ids. Can be \c NULL for counting only.
+ * @return Number of found properties.
+ * @since 0.3
+ */
+guint mkdg_value_store_find_flags(MkdgValueStore *store, MkdgPropertyContextFlags flags, MkdgPropertyHandle *ids);
+
+#endif /* MKDG_VALUE_STORE_H_ */
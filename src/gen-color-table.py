@@ -0,0 +1,288 @@
+#!/usr/bin/env python
+#
+# Copyright © 2010  Red Hat, Inc. All rights reserved.
+# Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+#
+#  This file is part of MakerDialog.
+#
+#  MakerDialog is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU Lesser General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  MakerDialog is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU Lesser General Public License for more details.
+#
+#  You should have received a copy of the GNU Lesser General Public License
+#  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Generate MakerDialogColorTable.h, the color name tables of MKDG_TYPE_COLOR.
+#
+# Usage: python gen-color-table.py > MakerDialogColorTable.h
+#
+# Name lookup is a hash-and-displace perfect hash:
+#   h    = FNV-1a 64-bit of the ASCII-lowercased name
+#   slot = ((h & 0xFFFFFFFF) + disp[(h >> 32) % BUCKETS] * ((h >> 40) | 1)) % NAME_SLOTS
+# so each name is found with one hash and one string compare.
+#
+# Value lookup is an open addressing table with linear probing,
+# which holds the index of the preferred name of each value.
+#
+# When a value has several names, the first one in COLORS is used for output.
+
+import sys
+
+# CSS3 / X11 color names. Preferred names come first.
+COLORS = [
+    ("AliceBlue", 0xF0F8FF),
+    ("AntiqueWhite", 0xFAEBD7),
+    ("Aqua", 0x00FFFF),
+    ("Aquamarine", 0x7FFFD4),
+    ("Azure", 0xF0FFFF),
+    ("Beige", 0xF5F5DC),
+    ("Bisque", 0xFFE4C4),
+    ("Black", 0x000000),
+    ("BlanchedAlmond", 0xFFEBCD),
+    ("Blue", 0x0000FF),
+    ("BlueViolet", 0x8A2BE2),
+    ("Brown", 0xA52A2A),
+    ("BurlyWood", 0xDEB887),
+    ("CadetBlue", 0x5F9EA0),
+    ("Chartreuse", 0x7FFF00),
+    ("Chocolate", 0xD2691E),
+    ("Coral", 0xFF7F50),
+    ("CornflowerBlue", 0x6495ED),
+    ("Cornsilk", 0xFFF8DC),
+    ("Crimson", 0xDC143C),
+    ("Cyan", 0x00FFFF),
+    ("DarkBlue", 0x00008B),
+    ("DarkCyan", 0x008B8B),
+    ("DarkGoldenrod", 0xB8860B),
+    ("DarkGray", 0xA9A9A9),
+    ("DarkGreen", 0x006400),
+    ("DarkGrey", 0xA9A9A9),
+    ("DarkKhaki", 0xBDB76B),
+    ("DarkMagenta", 0x8B008B),
+    ("DarkOliveGreen", 0x556B2F),
+    ("DarkOrange", 0xFF8C00),
+    ("DarkOrchid", 0x9932CC),
+    ("DarkRed", 0x8B0000),
+    ("DarkSalmon", 0xE9967A),
+    ("DarkSeaGreen", 0x8FBC8F),
+    ("DarkSlateBlue", 0x483D8B),
+    ("DarkSlateGray", 0x2F4F4F),
+    ("DarkSlateGrey", 0x2F4F4F),
+    ("DarkTurquoise", 0x00CED1),
+    ("DarkViolet", 0x9400D3),
+    ("DeepPink", 0xFF1493),
+    ("DeepSkyBlue", 0x00BFFF),
+    ("DimGray", 0x696969),
+    ("DimGrey", 0x696969),
+    ("DodgerBlue", 0x1E90FF),
+    ("FireBrick", 0xB22222),
+    ("FloralWhite", 0xFFFAF0),
+    ("ForestGreen", 0x228B22),
+    ("Fuchsia", 0xFF00FF),
+    ("Gainsboro", 0xDCDCDC),
+    ("GhostWhite", 0xF8F8FF),
+    ("Gold", 0xFFD700),
+    ("Goldenrod", 0xDAA520),
+    ("Gray", 0x808080),
+    ("Green", 0x008000),
+    ("GreenYellow", 0xADFF2F),
+    ("Grey", 0x808080),
+    ("Honeydew", 0xF0FFF0),
+    ("HotPink", 0xFF69B4),
+    ("IndianRed", 0xCD5C5C),
+    ("Indigo", 0x4B0082),
+    ("Ivory", 0xFFFFF0),
+    ("Khaki", 0xF0E68C),
+    ("Lavender", 0xE6E6FA),
+    ("LavenderBlush", 0xFFF0F5),
+    ("LawnGreen", 0x7CFC00),
+    ("LemonChiffon", 0xFFFACD),
+    ("LightBlue", 0xADD8E6),
+    ("LightCoral", 0xF08080),
+    ("LightCyan", 0xE0FFFF),
+    ("LightGoldenrodYellow", 0xFAFAD2),
+    ("LightGray", 0xD3D3D3),
+    ("LightGreen", 0x90EE90),
+    ("LightGrey", 0xD3D3D3),
+    ("LightPink", 0xFFB6C1),
+    ("LightSalmon", 0xFFA07A),
+    ("LightSeaGreen", 0x20B2AA),
+    ("LightSkyBlue", 0x87CEFA),
+    ("LightSlateGray", 0x778899),
+    ("LightSlateGrey", 0x778899),
+    ("LightSteelBlue", 0xB0C4DE),
+    ("LightYellow", 0xFFFFE0),
+    ("Lime", 0x00FF00),
+    ("LimeGreen", 0x32CD32),
+    ("Linen", 0xFAF0E6),
+    ("Magenta", 0xFF00FF),
+    ("Maroon", 0x800000),
+    ("MediumAquamarine", 0x66CDAA),
+    ("MediumBlue", 0x0000CD),
+    ("MediumOrchid", 0xBA55D3),
+    ("MediumPurple", 0x9370DB),
+    ("MediumSeaGreen", 0x3CB371),
+    ("MediumSlateBlue", 0x7B68EE),
+    ("MediumSpringGreen", 0x00FA9A),
+    ("MediumTurquoise", 0x48D1CC),
+    ("MediumVioletRed", 0xC71585),
+    ("MidnightBlue", 0x191970),
+    ("MintCream", 0xF5FFFA),
+    ("MistyRose", 0xFFE4E1),
+    ("Moccasin", 0xFFE4B5),
+    ("NavajoWhite", 0xFFDEAD),
+    ("Navy", 0x000080),
+    ("OldLace", 0xFDF5E6),
+    ("Olive", 0x808000),
+    ("OliveDrab", 0x6B8E23),
+    ("Orange", 0xFFA500),
+    ("OrangeRed", 0xFF4500),
+    ("Orchid", 0xDA70D6),
+    ("PaleGoldenrod", 0xEEE8AA),
+    ("PaleGreen", 0x98FB98),
+    ("PaleTurquoise", 0xAFEEEE),
+    ("PaleVioletRed", 0xDB7093),
+    ("PapayaWhip", 0xFFEFD5),
+    ("PeachPuff", 0xFFDAB9),
+    ("Peru", 0xCD853F),
+    ("Pink", 0xFFC0CB),
+    ("Plum", 0xDDA0DD),
+    ("PowderBlue", 0xB0E0E6),
+    ("Purple", 0x800080),
+    ("RebeccaPurple", 0x663399),
+    ("Red", 0xFF0000),
+    ("RosyBrown", 0xBC8F8F),
+    ("RoyalBlue", 0x4169E1),
+    ("SaddleBrown", 0x8B4513),
+    ("Salmon", 0xFA8072),
+    ("SandyBrown", 0xF4A460),
+    ("SeaGreen", 0x2E8B57),
+    ("SeaShell", 0xFFF5EE),
+    ("Sienna", 0xA0522D),
+    ("Silver", 0xC0C0C0),
+    ("SkyBlue", 0x87CEEB),
+    ("SlateBlue", 0x6A5ACD),
+    ("SlateGray", 0x708090),
+    ("SlateGrey", 0x708090),
+    ("Snow", 0xFFFAFA),
+    ("SpringGreen", 0x00FF7F),
+    ("SteelBlue", 0x4682B4),
+    ("Tan", 0xD2B48C),
+    ("Teal", 0x008080),
+    ("Thistle", 0xD8BFD8),
+    ("Tomato", 0xFF6347),
+    ("Turquoise", 0x40E0D0),
+    ("Violet", 0xEE82EE),
+    ("Wheat", 0xF5DEB3),
+    ("White", 0xFFFFFF),
+    ("WhiteSmoke", 0xF5F5F5),
+    ("Yellow", 0xFFFF00),
+    ("YellowGreen", 0x9ACD32),
+    # Misspelling in MakerDialog 0.2, kept so old config files still load.
+    ("Sliver", 0xC0C0C0),
+]
+
+NAME_SLOTS = 256
+BUCKETS = 64
+VALUE_SLOTS = 256
+MASK64 = (1 << 64) - 1
+
+
+def name_hash(name):
+    h = 0xCBF29CE484222325
+    for c in name.lower().encode("ascii"):
+        h ^= c
+        h = (h * 0x100000001B3) & MASK64
+    return h
+
+
+def name_slot(h, d):
+    return ((h & 0xFFFFFFFF) + d * ((h >> 40) | 1)) % NAME_SLOTS
+
+
+def value_slot(value):
+    return ((value * 0x9E3779B1) & 0xFFFFFFFF) >> 24
+
+
+def build_name_table():
+    buckets = [[] for _ in range(BUCKETS)]
+    for i, (name, _) in enumerate(COLORS):
+        h = name_hash(name)
+        buckets[(h >> 32) % BUCKETS].append((i, h))
+    disp = [0] * BUCKETS
+    slots = [-1] * NAME_SLOTS
+    for b in sorted(range(BUCKETS), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(65536):
+            taken = [name_slot(h, d) for _, h in buckets[b]]
+            if len(set(taken)) == len(taken) and all(slots[s] < 0 for s in taken):
+                break
+        else:
+            sys.exit("Cannot place bucket %d" % b)
+        disp[b] = d
+        for (i, _), s in zip(buckets[b], taken):
+            slots[s] = i
+    return disp, slots
+
+
+def build_value_table():
+    slots = [-1] * VALUE_SLOTS
+    maxProbe = 0
+    seen = set()
+    for i, (_, value) in enumerate(COLORS):
+        if value in seen:
+            continue
+        seen.add(value)
+        s = value_slot(value)
+        probe = 1
+        while slots[s] >= 0:
+            s = (s + 1) % VALUE_SLOTS
+            probe += 1
+        slots[s] = i
+        maxProbe = max(maxProbe, probe)
+    return slots, maxProbe
+
+
+def main():
+    names = [n.lower() for n, _ in COLORS]
+    if len(set(names)) != len(names):
+        sys.exit("Duplicated color name")
+    disp, nameSlots = build_name_table()
+    valueSlots, maxProbe = build_value_table()
+    out = sys.stdout.write
+    out("/*\n * Generated by gen-color-table.py, do not edit.\n")
+    out(" * %d names, %d values, at most %d probes for a value.\n */\n"
+        % (len(COLORS), len(set(v for _, v in COLORS)), maxProbe))
+    out("#ifndef MKDG_COLOR_TABLE_H_\n#define MKDG_COLOR_TABLE_H_\n\n")
+    out("#define MKDG_COLOR_NAME_SLOTS\t%d\n" % NAME_SLOTS)
+    out("#define MKDG_COLOR_NAME_BUCKETS\t%d\n" % BUCKETS)
+    out("#define MKDG_COLOR_VALUE_SLOTS\t%d\n" % VALUE_SLOTS)
+    out("#define MKDG_COLOR_COUNT\t%d\n\n" % len(COLORS))
+    out("static const MkdgColorInfo mkdgColorList[]={\n")
+    for name, value in COLORS:
+        out("    {%-24s0x%06X},\n" % ('"%s",' % name, value))
+    out("    {NULL,\t\t\t0}\n};\n\n")
+
+    def out_array(ctype, cname, values, perLine):
+        out("static const %s %s[]={\n" % (ctype, cname))
+        for i in range(0, len(values), perLine):
+            out("    " + ", ".join("%3d" % v for v in values[i:i + perLine]) + ",\n")
+        out("};\n\n")
+
+    out_array("guint16", "mkdgColorNameDisp", disp, 16)
+    out("/* Index to mkdgColorList, -1 for empty slot */\n")
+    out_array("gint16", "mkdgColorNameSlots", nameSlots, 16)
+    out("/* Index to mkdgColorList, -1 for empty slot */\n")
+    out_array("gint16", "mkdgColorValueSlots", valueSlots, 16)
+    out("#endif /* MKDG_COLOR_TABLE_H_ */\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -329,7 +329,7 @@ static void listStore_prepend(GtkListStore *listStore, const gchar *listKey, con
 static gint listStore_find_value(GtkListStore *listStore, MkdgValue *value, MkdgPropertySpec *spec){
     int i=0,index=-1;
     GtkTreeIter iter;
-    gchar *valueStr=mkdg_value_to_string(value, spec->toStringFormat);
+    gchar *valueStr=mkdg_value_codec_to_string(mkdg_property_spec_get_codec(spec), value);
     MKDG_DEBUG_MSG(5,"[I5] Gtk:listStore_find_value(-,%s,%s)", valueStr, spec->key);
     GValue val={0};
     if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(listStore), &iter)){
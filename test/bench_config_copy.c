@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of copying values between config buffers and property contexts.
+ *
+ * It fills a config buffer with string and string list values,
+ * loads them into property contexts, then saves them to a new config buffer,
+ * as the config load and save do.
+ * The legacy deep copy is compared with mkdg_value_copy(),
+ * which shares the reference-counted payload.
+ *
+ * Usage: bench_config_copy.exe [keyCount] [listLength] [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+#define BENCH_KEY_COUNT_DEFAULT		5000
+#define BENCH_LIST_LENGTH_DEFAULT	200
+#define BENCH_ROUNDS_DEFAULT		20
+
+typedef gboolean (* BenchCopyFunc)(MkdgValue *srcValue, MkdgValue *destValue);
+
+/*=== Start of legacy copy ===*/
+/* Deep copy as mkdg_value_copy() did before payloads were shared. */
+static gboolean legacy_value_copy(MkdgValue *srcValue, MkdgValue *destValue){
+    if (srcValue->mType==MKDG_TYPE_STRING){
+	mkdg_value_set(destValue, mkdg_value_get_string(srcValue));
+    }else if (srcValue->mType==MKDG_TYPE_STRING_LIST){
+	if (destValue->flags & MKDG_VALUE_FLAG_NEED_FREE)
+	    mkdg_string_list_free(mkdg_value_get_packed_string_list(destValue));
+	mkdg_value_set_string_list(destValue, mkdg_string_list_copy(mkdg_value_get_packed_string_list(srcValue)));
+	destValue->flags |= MKDG_VALUE_FLAG_NEED_FREE;
+    }else{
+	return mkdg_value_copy(srcValue, destValue);
+    }
+    return TRUE;
+}
+/*=== End of legacy copy ===*/
+
+static MkdgConfigBuffer *bench_config_buffer_new(MkdgPropertyContext **ctxs, gint count, gint listLength){
+    MkdgConfigBuffer *configBuf=mkdg_config_buffer_new();
+    GString *strBuf=g_string_new(NULL);
+    gint i,j;
+    for(i=0;i<count;i++){
+	g_string_truncate(strBuf, 0);
+	if (ctxs[i]->spec->valueType==MKDG_TYPE_STRING_LIST){
+	    for(j=0;j<listLength;j++){
+		g_string_append_printf(strBuf, "%s新酷音詞庫_%d_%d", (j) ? ";" : "", i, j);
+	    }
+	}else{
+	    g_string_printf(strBuf, "/usr/share/chewing/dictionary_%d.dat", i);
+	}
+	mkdg_config_buffer_insert_string(configBuf, ctxs[i]->spec->key, ctxs[i]->spec->valueType, strBuf->str, NULL);
+    }
+    g_string_free(strBuf, TRUE);
+    return configBuf;
+}
+
+static gdouble bench_load_save(const gchar *name, BenchCopyFunc copyFunc,
+	MkdgConfigBuffer *configBuf, MkdgPropertyContext **ctxs, gint count, gint rounds){
+    GTimer *loadTimer=g_timer_new();
+    GTimer *saveTimer=g_timer_new();
+    g_timer_stop(loadTimer);
+    g_timer_stop(saveTimer);
+    gint r,i;
+    for(r=0;r<rounds;r++){
+	g_timer_continue(loadTimer);
+	for(i=0;i<count;i++){
+	    copyFunc(mkdg_config_buffer_lookup(configBuf, ctxs[i]->spec->key), ctxs[i]->value);
+	}
+	g_timer_stop(loadTimer);
+	g_timer_continue(saveTimer);
+	MkdgConfigBuffer *saveBuf=mkdg_config_buffer_new();
+	for(i=0;i<count;i++){
+	    MkdgValue *mValue=mkdg_config_buffer_insert_new(saveBuf, ctxs[i]->spec->key, ctxs[i]->spec->valueType);
+	    copyFunc(ctxs[i]->value, mValue);
+	}
+	mkdg_config_buffer_free(saveBuf);
+	g_timer_stop(saveTimer);
+    }
+    gdouble loadTime=g_timer_elapsed(loadTimer, NULL);
+    gdouble saveTime=g_timer_elapsed(saveTimer, NULL);
+    g_timer_destroy(loadTimer);
+    g_timer_destroy(saveTimer);
+    printf("%-16s load %8.3f s save %8.3f s\n", name, loadTime, saveTime);
+    return loadTime+saveTime;
+}
+
+int main(int argc, char** argv){
+    gint count=(argc>1) ? atoi(argv[1]) : BENCH_KEY_COUNT_DEFAULT;
+    gint listLength=(argc>2) ? atoi(argv[2]) : BENCH_LIST_LENGTH_DEFAULT;
+    gint rounds=(argc>3) ? atoi(argv[3]) : BENCH_ROUNDS_DEFAULT;
+    if (count<=0 || listLength<=0 || rounds<=0){
+	fprintf(stderr, "Usage: %s [keyCount] [listLength] [rounds]\n", argv[0]);
+	return 1;
+    }
+    MkdgPropertyContext **ctxs=g_new(MkdgPropertyContext *, count);
+    gint i;
+    for(i=0;i<count;i++){
+	/* Spec owns the key. Every fourth key is a plain string */
+	MkdgPropertySpec *spec=mkdg_property_spec_new(g_strdup_printf("key%05d", i),
+		(i%4) ? MKDG_TYPE_STRING_LIST : MKDG_TYPE_STRING);
+	ctxs[i]=mkdg_property_context_new(spec, NULL);
+    }
+    MkdgConfigBuffer *configBuf=bench_config_buffer_new(ctxs, count, listLength);
+    printf("%d keys, %d strings per list, %d rounds\n", count, listLength, rounds);
+
+    gdouble legacyTime=bench_load_save("legacy copy", legacy_value_copy, configBuf, ctxs, count, rounds);
+    gdouble copyTime=bench_load_save("shared copy", mkdg_value_copy, configBuf, ctxs, count, rounds);
+    printf("speedup load and save %.2fx\n", legacyTime/copyTime);
+
+    mkdg_config_buffer_free(configBuf);
+    for(i=0;i<count;i++){
+	mkdg_property_context_free(ctxs[i]);
+    }
+    g_free(ctxs);
+    return 0;
+}
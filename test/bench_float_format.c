@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of floating point formatting.
+ *
+ * It compares the throughput of the legacy "%g" output (lossy),
+ * "%.17g" output (round trip but long) and mkdg_number_format_double().
+ *
+ * Usage: bench_float_format.exe [valueCount] [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+#define BENCH_VALUE_COUNT_DEFAULT	1000000
+#define BENCH_ROUNDS_DEFAULT		3
+#define BENCH_BUFFER_SIZE		64
+
+static gsize format_g(gdouble value, gchar *buf, gsize bufSize){
+    return (gsize) g_snprintf(buf, bufSize, "%g", value);
+}
+
+static gsize format_17g(gdouble value, gchar *buf, gsize bufSize){
+    return (gsize) g_snprintf(buf, bufSize, "%.17g", value);
+}
+
+static void bench_run(const gchar *name, gsize (* format)(gdouble, gchar *, gsize), gdouble *values,
+	gint count, gint rounds){
+    gchar buf[BENCH_BUFFER_SIZE];
+    GTimer *timer=g_timer_new();
+    gsize totalLen=0;
+    gint i,r,lost=0;
+    for(r=0;r<rounds;r++){
+	for(i=0;i<count;i++){
+	    totalLen+=format(values[i], buf, BENCH_BUFFER_SIZE);
+	}
+    }
+    gdouble elapsed=g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    for(i=0;i<count;i++){
+	gdouble parsed;
+	format(values[i], buf, BENCH_BUFFER_SIZE);
+	mkdg_number_parse_double(buf, &parsed);
+	if (parsed!=values[i])
+	    lost++;
+    }
+    printf("%-8s %8.3f s %10.2f Mvalues/s  avg length %5.2f  lost %d\n", name, elapsed,
+	    (gdouble) count*rounds/elapsed/1e6, (gdouble) totalLen/count/rounds, lost);
+}
+
+int main(int argc, char** argv){
+    gint count=(argc>1) ? atoi(argv[1]) : BENCH_VALUE_COUNT_DEFAULT;
+    gint rounds=(argc>2) ? atoi(argv[2]) : BENCH_ROUNDS_DEFAULT;
+    gint i;
+    if (count<=0 || rounds<=0){
+	fprintf(stderr, "Usage: %s [valueCount] [rounds]\n", argv[0]);
+	return 1;
+    }
+    GRand *rand=g_rand_new_with_seed(20100101);
+    gdouble *values=g_new(gdouble, count);
+    for(i=0;i<count;i++){
+	/* Half of them look like config values, half are arbitrary. */
+	values[i]=(i % 2) ? g_rand_double_range(rand, -1e6, 1e6) : g_rand_int_range(rand, -100000, 100000) / 100.0;
+    }
+    g_rand_free(rand);
+    printf("%d values, %d rounds\n", count, rounds);
+    bench_run("%g", format_g, values, count, rounds);
+    bench_run("%.17g", format_17g, values, count, rounds);
+    bench_run("shortest", mkdg_number_format_double, values, count, rounds);
+    g_free(values);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of number parsing.
+ *
+ * It generates the values of a large numeric config file,
+ * then compares the throughput of the legacy determine_base() + strtol() path
+ * with mkdg_number_parse_*().
+ *
+ * Usage: bench_number.exe [valueCount] [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+#define BENCH_VALUE_COUNT_DEFAULT	1000000
+#define BENCH_ROUNDS_DEFAULT		5
+
+typedef enum{
+    BENCH_INT,
+    BENCH_INT64,
+    BENCH_HEX,
+    BENCH_DOUBLE,
+} BENCH_KIND;
+
+typedef struct{
+    BENCH_KIND kind;
+    const gchar *parseOption;
+    gchar *str;
+} BenchValue;
+
+/*=== Start of legacy parser ===*/
+/* Copied from MakerDialogTypes.c before the number parser module. */
+static gint legacy_determine_base(const gchar *str, const gchar *parseOption, gchar **startPtr){
+    gint base=10;
+    *startPtr=(gchar *) str;
+    if (parseOption){
+	base=atoi (parseOption);
+    }else{
+	if (strlen(str)>2 && str[0]=='0' && str[1]=='x'){
+	    base=16;
+	    *startPtr= (gchar *) str+2;
+	}else if (strlen(str)>2 && str[0]=='0' && str[1]!='.'){
+	    base=8;
+	    *startPtr= (gchar *) str+1;
+	}
+    }
+    return base;
+}
+
+static gdouble legacy_parse(BenchValue *bValue){
+    gchar *startPtr=NULL;
+    if (mkdg_string_is_empty(bValue->str))
+	return 0.0;
+    if (bValue->kind==BENCH_DOUBLE)
+	return strtod(bValue->str, NULL);
+    gint base=legacy_determine_base(bValue->str, bValue->parseOption, &startPtr);
+    return (gdouble) strtol(startPtr, NULL, base);
+}
+/*=== End of legacy parser ===*/
+
+static gdouble number_parse(BenchValue *bValue){
+    gint64 i64;
+    gdouble dbl;
+    if (bValue->kind==BENCH_DOUBLE){
+	mkdg_number_parse_double(bValue->str, &dbl);
+	return dbl;
+    }
+    mkdg_number_parse_int64(bValue->str, mkdg_number_base_parse(bValue->parseOption), &i64);
+    return (gdouble) i64;
+}
+
+static BenchValue *bench_values_new(gint count, gsize *totalBytes){
+    BenchValue *values=g_new(BenchValue, count);
+    GRand *rand=g_rand_new_with_seed(20100101);
+    gint i;
+    *totalBytes=0;
+    for(i=0;i<count;i++){
+	values[i].kind=(BENCH_KIND) (i % 4);
+	values[i].parseOption=NULL;
+	switch(values[i].kind){
+	    case BENCH_INT:
+		values[i].str=g_strdup_printf("%d", g_rand_int_range(rand, -100000, 100000));
+		break;
+	    case BENCH_INT64:
+		values[i].str=g_strdup_printf("%" G_GINT64_FORMAT,
+			(((gint64) g_rand_int(rand)) << 31) ^ g_rand_int(rand));
+		break;
+	    case BENCH_HEX:
+		values[i].str=g_strdup_printf("%X", g_rand_int(rand));
+		values[i].parseOption="16";
+		break;
+	    case BENCH_DOUBLE:
+		values[i].str=g_strdup_printf("%.3f", g_rand_double_range(rand, -1000.0, 1000.0));
+		break;
+	}
+	*totalBytes+=strlen(values[i].str);
+    }
+    g_rand_free(rand);
+    return values;
+}
+
+static gdouble bench_run(const gchar *name, gdouble (* parse)(BenchValue *), BenchValue *values, gint count,
+	gint rounds, gsize totalBytes){
+    GTimer *timer=g_timer_new();
+    gdouble sum=0.0;
+    gint i,r;
+    for(r=0;r<rounds;r++){
+	for(i=0;i<count;i++){
+	    sum+=parse(&values[i]);
+	}
+    }
+    gdouble elapsed=g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    printf("%-8s %8.3f s %10.2f MB/s %12.2f Mvalues/s (checksum %g)\n", name, elapsed,
+	    (gdouble) totalBytes*rounds/elapsed/1e6, (gdouble) count*rounds/elapsed/1e6, sum);
+    return elapsed;
+}
+
+int main(int argc, char** argv){
+    gint count=(argc>1) ? atoi(argv[1]) : BENCH_VALUE_COUNT_DEFAULT;
+    gint rounds=(argc>2) ? atoi(argv[2]) : BENCH_ROUNDS_DEFAULT;
+    gsize totalBytes;
+    gint i;
+    if (count<=0 || rounds<=0){
+	fprintf(stderr, "Usage: %s [valueCount] [rounds]\n", argv[0]);
+	return 1;
+    }
+    BenchValue *values=bench_values_new(count, &totalBytes);
+    printf("%d values, %u bytes, %d rounds\n", count, (guint) totalBytes, rounds);
+    gdouble legacyTime=bench_run("legacy", legacy_parse, values, count, rounds, totalBytes);
+    gdouble numberTime=bench_run("number", number_parse, values, count, rounds, totalBytes);
+    printf("speedup  %.2fx\n", legacyTime/numberTime);
+    for(i=0;i<count;i++){
+	g_free(values[i].str);
+    }
+    g_free(values);
+    return 0;
+}
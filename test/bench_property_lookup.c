@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of property lookup by key.
+ *
+ * It adds properties to a MakerDialog, then looks up every key
+ * in a shuffled order, first through the property hash table,
+ * then through the index built by mkdg_freeze().
+ * The looked up keys are copies, as keys read from config files are.
+ *
+ * Usage: bench_property_lookup.exe [keyCount] [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+#define BENCH_KEY_COUNT_DEFAULT		5000
+#define BENCH_ROUNDS_DEFAULT		200
+
+static gdouble bench_lookup(const gchar *name, Mkdg *mDialog, gchar **keys, gint count, gint rounds){
+    GTimer *timer=g_timer_new();
+    gint r,i;
+    gint found=0;
+    for(r=0;r<rounds;r++){
+	for(i=0;i<count;i++){
+	    if (mkdg_get_property_context(mDialog, keys[i]))
+		found++;
+	}
+    }
+    gdouble elapsed=g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    printf("%-16s %8.3f s %8.1f ns/lookup (found %d)\n", name, elapsed,
+	    elapsed*1e9/((gdouble) count*rounds), found);
+    return elapsed;
+}
+
+int main(int argc, char** argv){
+    gint count=(argc>1) ? atoi(argv[1]) : BENCH_KEY_COUNT_DEFAULT;
+    gint rounds=(argc>2) ? atoi(argv[2]) : BENCH_ROUNDS_DEFAULT;
+    if (count<=0 || rounds<=0){
+	fprintf(stderr, "Usage: %s [keyCount] [rounds]\n", argv[0]);
+	return 1;
+    }
+    Mkdg *mDialog=mkdg_new();
+    gchar **keys=g_new(gchar *, count+1);
+    gint i;
+    for(i=0;i<count;i++){
+	/* Spec owns the key */
+	MkdgPropertySpec *spec=mkdg_property_spec_new(g_strdup_printf("chewing/propertyKey%05d", i), MKDG_TYPE_INT);
+	mkdg_add_property(mDialog, mkdg_property_context_new(spec, NULL));
+	keys[i]=g_strdup(spec->key);
+    }
+    keys[count]=NULL;
+    GRand *rand=g_rand_new_with_seed(20100101);
+    for(i=count-1;i>0;i--){
+	gint j=g_rand_int_range(rand, 0, i+1);
+	gchar *tmp=keys[i];
+	keys[i]=keys[j];
+	keys[j]=tmp;
+    }
+    g_rand_free(rand);
+    printf("%d keys, %d rounds\n", count, rounds);
+
+    gdouble tableTime=bench_lookup("hash table", mDialog, keys, count, rounds);
+    GTimer *timer=g_timer_new();
+    if (!mkdg_freeze(mDialog)){
+	fprintf(stderr, "Failed to freeze\n");
+	return 2;
+    }
+    printf("%-16s %8.3f s\n", "freeze", g_timer_elapsed(timer, NULL));
+    g_timer_destroy(timer);
+    gdouble frozenTime=bench_lookup("frozen index", mDialog, keys, count, rounds);
+    printf("speedup lookup %.2fx\n", tableTime/frozenTime);
+
+    g_strfreev(keys);
+    mkdg_destroy(mDialog);
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2010  Red Hat, Inc. All rights reserved.
+ * Copyright © 2010  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of string list split and combine.
+ *
+ * It generates a phrase list like the STRING_LIST properties of input methods,
+ * then compares the legacy per-character split/combine with
+ * mkdg_string_split_set(), mkdg_string_split_set_packed()
+ * and mkdg_string_list_combine().
+ *
+ * Usage: bench_string_list.exe [phraseCount] [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+
+#define BENCH_PHRASE_COUNT_DEFAULT	50000
+#define BENCH_ROUNDS_DEFAULT		20
+
+/*=== Start of legacy split and combine ===*/
+/* Copied from MakerDialogUtil.c before the strcspn() based codec. */
+static gint legacy_char_at(const gchar *str, gchar ch){
+    gint i;
+    for(i=0; str[i]!='\0'; i++){
+	if (str[i]==ch)
+	    return i;
+    }
+    return -1;
+}
+
+static gchar **legacy_split_set
+(const gchar *str, const gchar *delimiters, gchar escapeChar, gboolean emptyToken, gint maxTokens){
+    GPtrArray *ptrArray=g_ptr_array_new();
+    gint tokenCount=0;
+    gchar *chPtr=(gchar *)str;
+    GString *strBuf=g_string_new("");
+    while(*chPtr!='\0'){
+	if (*chPtr==escapeChar){
+	    chPtr++;
+	}else if (legacy_char_at(delimiters, *chPtr)>=0){
+	    if (maxTokens<0 || tokenCount<maxTokens-1){
+		if (emptyToken || strBuf->len){
+		    g_ptr_array_add(ptrArray,g_string_free(strBuf,FALSE));
+		    tokenCount++;
+		    strBuf=g_string_new("");
+		}
+		chPtr++;
+		continue;
+	    }
+	}
+	gunichar wch=g_utf8_get_char(chPtr);
+	if (wch){
+	    g_string_append_unichar(strBuf,wch);
+	    chPtr=g_utf8_next_char(chPtr);
+	}
+    }
+    if (emptyToken || strBuf->len){
+	g_ptr_array_add(ptrArray,g_string_free(strBuf,FALSE));
+    }else{
+	g_string_free(strBuf,TRUE);
+    }
+    g_ptr_array_add(ptrArray, NULL);
+    return (gchar **) g_ptr_array_free(ptrArray, FALSE);
+}
+
+static void legacy_buffer_put(gchar *buf, gsize bufSize, gsize *len, gchar ch){
+    if (*len+1<bufSize){
+	buf[*len]=ch;
+    }
+    (*len)++;
+}
+
+static gsize legacy_combine_into
+(gchar **strList, const gchar *delimiters, gchar escapeChar, gchar *buf, gsize bufSize){
+    gsize len=0;
+    gint i;
+    const gchar *chPtr;
+    for(i=0;strList[i]!=NULL; i++){
+	if (i>0){
+	    legacy_buffer_put(buf, bufSize, &len, delimiters[0]);
+	}
+	for(chPtr=strList[i];*chPtr!='\0';chPtr++){
+	    if (*chPtr==escapeChar || legacy_char_at(delimiters, *chPtr)>=0){
+		legacy_buffer_put(buf, bufSize, &len, escapeChar);
+	    }
+	    legacy_buffer_put(buf, bufSize, &len, *chPtr);
+	}
+    }
+    if (bufSize>0){
+	buf[(len<bufSize) ? len : bufSize-1]='\0';
+    }
+    return len;
+}
+
+static gchar *legacy_combine(gchar **strList, const gchar *delimiters, gchar escapeChar){
+    gsize len=legacy_combine_into(strList, delimiters, escapeChar, NULL, 0);
+    gchar *result=g_new(gchar, len+1);
+    legacy_combine_into(strList, delimiters, escapeChar, result, len+1);
+    return result;
+}
+/*=== End of legacy split and combine ===*/
+
+static const gchar *phraseParts[]={
+    "新酷音", "輸入法", "測試", "注音", "詞庫", "選字", "ibus", "chewing",
+    "a;b", "c\\d", "hsu", "dvorak", NULL
+};
+
+static gchar **bench_phrases_new(gint count){
+    gchar **phrases=g_new(gchar *, count+1);
+    GRand *rand=g_rand_new_with_seed(20100101);
+    gint partCount=g_strv_length((gchar **) phraseParts);
+    gint i,j;
+    for(i=0;i<count;i++){
+	GString *strBuf=g_string_new(NULL);
+	gint parts=g_rand_int_range(rand, 1, 4);
+	for(j=0;j<parts;j++){
+	    g_string_append(strBuf, phraseParts[g_rand_int_range(rand, 0, partCount)]);
+	}
+	phrases[i]=g_string_free(strBuf, FALSE);
+    }
+    phrases[count]=NULL;
+    g_rand_free(rand);
+    return phrases;
+}
+
+static gdouble bench_split(const gchar *name, gchar **(* split)(const gchar *, const gchar *, gchar, gboolean, gint),
+	void (* freeFunc)(gchar **), const gchar *str, gint rounds){
+    GTimer *timer=g_timer_new();
+    gint r;
+    guint count=0;
+    for(r=0;r<rounds;r++){
+	gchar **strList=split(str, ";", '\\', TRUE, -1);
+	count+=g_strv_length(strList);
+	freeFunc(strList);
+    }
+    gdouble elapsed=g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    printf("%-16s %8.3f s %10.2f MB/s (tokens %u)\n", name, elapsed,
+	    (gdouble) strlen(str)*rounds/elapsed/1e6, count);
+    return elapsed;
+}
+
+static gdouble bench_combine(const gchar *name, gboolean legacy, gchar **strList, gint rounds){
+    GTimer *timer=g_timer_new();
+    gint r;
+    gsize len=0;
+    for(r=0;r<rounds;r++){
+	gchar *str=(legacy) ? legacy_combine(strList, ";", '\\')
+	    : mkdg_string_list_combine(strList, ";", '\\', TRUE);
+	len+=strlen(str);
+	g_free(str);
+    }
+    gdouble elapsed=g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    printf("%-16s %8.3f s %10.2f MB/s\n", name, elapsed, (gdouble) len/elapsed/1e6);
+    return elapsed;
+}
+
+static void packed_free(gchar **strList){
+    g_free(strList);
+}
+
+int main(int argc, char** argv){
+    gint count=(argc>1) ? atoi(argv[1]) : BENCH_PHRASE_COUNT_DEFAULT;
+    gint rounds=(argc>2) ? atoi(argv[2]) : BENCH_ROUNDS_DEFAULT;
+    if (count<=0 || rounds<=0){
+	fprintf(stderr, "Usage: %s [phraseCount] [rounds]\n", argv[0]);
+	return 1;
+    }
+    gchar **phrases=bench_phrases_new(count);
+    gchar *str=mkdg_string_list_combine(phrases, ";", '\\', TRUE);
+    gchar *legacyStr=legacy_combine(phrases, ";", '\\');
+    if (strcmp(str, legacyStr)!=0){
+	fprintf(stderr, "Combined strings differ\n");
+	return 2;
+    }
+    printf("%d phrases, %u bytes, %d rounds\n", count, (guint) strlen(str), rounds);
+
+    gdouble legacyTime=bench_split("legacy split", legacy_split_set, g_strfreev, str, rounds);
+    gdouble splitTime=bench_split("split", mkdg_string_split_set, g_strfreev, str, rounds);
+    gdouble packedTime=bench_split("split packed", mkdg_string_split_set_packed, packed_free, str, rounds);
+    printf("speedup split %.2fx, split packed %.2fx\n", legacyTime/splitTime, legacyTime/packedTime);
+
+    legacyTime=bench_combine("legacy combine", TRUE, phrases, rounds);
+    gdouble combineTime=bench_combine("combine", FALSE, phrases, rounds);
+    printf("speedup combine %.2fx\n", legacyTime/combineTime);
+
+    g_free(legacyStr);
+    g_free(str);
+    g_strfreev(phrases);
+    return 0;
+}
@@ -118,6 +118,7 @@ gboolean string_verify_func(OutputRec actual, OutputRec expect, const gchar *pro
     if (ret){
 	verboseMsg_print(VERBOSE_MSG_ERROR,"[Error]: %s: on input %s\n",prompt,input);
 	verboseMsg_print(VERBOSE_MSG_ERROR,"    Expect:%s\tActual:%s\n",expectDat,actualDat);
+	return FALSE;
     }else{
 	verboseMsg_print(VERBOSE_MSG_INFO2,"[Ok]: on input %s: expect:(%s) and actual:(%s) matched: \n", input, expectDat,actualDat);
     }
@@ -0,0 +1,1485 @@
+/*
+ * Copyright © 2009  Red Hat, Inc. All rights reserved.
+ * Copyright © 2009  Ding-Yi Chen <dchen at redhat.com>
+ *
+ *  This file is part of MakerDialog.
+ *
+ *  MakerDialog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  MakerDialog is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MakerDialog.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "MakerDialog.h"
+#include "check_functions.h"
+
+/*=== Start of allocation counter ===*/
+/*
+ * Interpose the libc allocator, so allocations made inside
+ * libMakerDialog and glib are counted as well.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static gboolean allocCounting=FALSE;
+static gint allocCount=0;
+
+void *malloc(size_t size){
+    if (allocCounting)
+	allocCount++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size){
+    if (allocCounting)
+	allocCount++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size){
+    if (allocCounting)
+	allocCount++;
+    return __libc_realloc(ptr, size);
+}
+/*=== End of allocation counter ===*/
+
+/*=== Start of zero allocation test ===*/
+#define ZERO_ALLOC_ITERATIONS 100
+
+typedef struct {
+    MkdgType mType;
+    const gchar *defaultValue;
+    const gchar *valueStr;
+    const gchar *testValue;
+    MkdgRelation relation;
+} MkdgZeroAlloc_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgZeroAlloc_InputRec in;
+} MkdgZeroAlloc_TestRec;
+
+/* String lists are packed and shared by copy; testValue NULL for no control rule. */
+MkdgZeroAlloc_TestRec ZERO_ALLOC_DATASET[]={
+    {{0}, {MKDG_TYPE_INT, "32", "103", "50", MKDG_RELATION_GREATER}},
+    {{0}, {MKDG_TYPE_BOOLEAN, "TRUE", "FALSE", "TRUE", MKDG_RELATION_EQUAL}},
+    {{0}, {MKDG_TYPE_DOUBLE, "1.5", "2.0", "1.0", MKDG_RELATION_LESS}},
+    {{0}, {MKDG_TYPE_STRING, "hsu", "dvorak", "hsu", MKDG_RELATION_NOT_EQUAL}},
+    {{0}, {MKDG_TYPE_STRING, "dvorak_hsu_layout", "dvorak_hsu_layout", "default_layout", MKDG_RELATION_EQUAL}},
+    {{0}, {MKDG_TYPE_COLOR, "white", "#FF0000", "red", MKDG_RELATION_EQUAL}},
+    {{0}, {MKDG_TYPE_STRING_LIST, "新酷音;輸入法", "hsu;dvorak", NULL, MKDG_RELATION_NIL}},
+    {{-1}, {MKDG_TYPE_INVALID, NULL, NULL, NULL, MKDG_RELATION_NIL}},
+};
+
+static void zeroAllocTest_each_rule(MkdgPropertyContext *ctx, MkdgWidgetControl control, gpointer userData){
+}
+
+OutputRec zeroAllocTest_run_func(InputRec inputRec, Param param){
+    MkdgZeroAlloc_InputRec *inRec=(MkdgZeroAlloc_InputRec *) inputRec;
+    /* Spec owns its strings and rules, see mkdg_property_spec_free() */
+    MkdgControlRule *rules=NULL;
+    if (inRec->testValue){
+	rules=g_new0(MkdgControlRule, 2);
+	rules[0].relation=inRec->relation;
+	rules[0].testValue=g_strdup(inRec->testValue);
+	rules[0].key=g_strdup("zeroAlloc");
+	rules[0].match=MKDG_WIDGET_CONTROL_SHOW;
+	rules[0].notMatch=MKDG_WIDGET_CONTROL_HIDE;
+    }
+    Mkdg *mDialog=mkdg_new();
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup("zeroAlloc"), inRec->mType,
+	    g_strdup(inRec->defaultValue), NULL, NULL, NULL, NULL,
+	    0.0, 1000.0, 1.0, 1, 0,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, rules, NULL);
+    MkdgPropertyContext *ctx=mkdg_property_context_new(spec, NULL);
+    mkdg_add_property(mDialog, ctx);
+    mkdg_property_from_string(ctx, inRec->valueStr);
+
+    gint i;
+    gchar strBuf[MKDG_VALUE_FORMAT_BUFFER_SIZE];
+    MkdgValue copyValue;
+    allocCount=0;
+    allocCounting=TRUE;
+    for(i=0;i<ZERO_ALLOC_ITERATIONS;i++){
+	mkdg_property_is_default(ctx);
+	mkdg_property_set_default(ctx);
+	mkdg_value_compare(ctx->value, ctx->value, NULL);
+	mkdg_property_foreach_control_rule(ctx, zeroAllocTest_each_rule, NULL);
+	mkdg_property_format_into(ctx, strBuf, MKDG_VALUE_FORMAT_BUFFER_SIZE);
+	/* Copy shares the content of ctx */
+	mkdg_value_init_static(&copyValue, inRec->mType);
+	mkdg_value_copy(ctx->value, &copyValue);
+	mkdg_value_clear(&copyValue);
+    }
+    allocCounting=FALSE;
+    mkdg_destroy(mDialog);
+    output_rec_set_int(result, allocCount);
+    return result;
+}
+
+gchar *zeroAllocTest_to_string(InputRec inputRec, Param param){
+    MkdgZeroAlloc_InputRec *inRec=(MkdgZeroAlloc_InputRec *) inputRec;
+    GString *strBuf=g_string_new(NULL);
+    g_string_printf(strBuf,"mType=%s,default=%s\tvalue=%s\ttestValue=%s",
+	    mkdg_type_to_string(inRec->mType), inRec->defaultValue, inRec->valueStr, inRec->testValue);
+    return g_string_free(strBuf, FALSE);
+}
+
+gboolean zeroAllocTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgZeroAlloc_TestRec *rec=(MkdgZeroAlloc_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgZeroAlloc_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=zeroAllocTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of zero allocation test ===*/
+
+/*=== Start of cached default test ===*/
+#define CACHED_DEFAULT_PROPERTY_COUNT 1000
+
+typedef struct {
+    MkdgType mType;
+    const gchar *defaultValue;
+    const gchar *validValues;
+    const gchar *valueStr;
+} MkdgCachedDefault_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgCachedDefault_InputRec in;
+} MkdgCachedDefault_TestRec;
+
+/* Output is number of allocations when checking and setting defaults; or -1 if default is wrong */
+MkdgCachedDefault_TestRec CACHED_DEFAULT_DATASET[]={
+    {{0}, {MKDG_TYPE_INT, "32", NULL, "103"}},
+    {{0}, {MKDG_TYPE_DOUBLE, "1.5", NULL, "2.0"}},
+    {{0}, {MKDG_TYPE_STRING, "dvorak_hsu_layout", NULL, "default_layout"}},
+    {{0}, {MKDG_TYPE_STRING, "not_valid", "default_layout;dvorak_hsu_layout", "dvorak_hsu_layout"}},
+    {{0}, {MKDG_TYPE_STRING_LIST, "新酷音;輸入法", NULL, "測試"}},
+    {{0}, {MKDG_TYPE_COLOR, "white", NULL, "#FF0000"}},
+    {{-1}, {MKDG_TYPE_INVALID, NULL, NULL, NULL}},
+};
+
+OutputRec cachedDefaultTest_run_func(InputRec inputRec, Param param){
+    MkdgCachedDefault_InputRec *inRec=(MkdgCachedDefault_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    MkdgPropertyContext *ctxs[CACHED_DEFAULT_PROPERTY_COUNT];
+    gint i;
+    for(i=0;i<CACHED_DEFAULT_PROPERTY_COUNT;i++){
+	gchar **validValues=(inRec->validValues) ? g_strsplit(inRec->validValues, ";", -1) : NULL;
+	MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("cachedDefault%d", i), inRec->mType,
+		g_strdup(inRec->defaultValue), validValues, NULL, NULL, NULL,
+		0.0, 1000.0, 1.0, 1, (validValues) ? MKDG_PROPERTY_FLAG_FIXED_SET : 0,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL);
+	ctxs[i]=mkdg_property_context_new(spec, NULL);
+	mkdg_add_property(mDialog, ctxs[i]);
+	mkdg_property_from_string(ctxs[i], inRec->valueStr);
+    }
+
+    gint ret=0;
+    allocCount=0;
+    allocCounting=TRUE;
+    for(i=0;i<CACHED_DEFAULT_PROPERTY_COUNT;i++){
+	if (mkdg_property_is_default(ctxs[i])){
+	    ret=-1;
+	}
+	mkdg_property_set_default(ctxs[i]);
+	if (!mkdg_property_is_default(ctxs[i])){
+	    ret=-1;
+	}
+    }
+    allocCounting=FALSE;
+    if (ret==0)
+	ret=allocCount;
+    mkdg_destroy(mDialog);
+    output_rec_set_int(result, ret);
+    return result;
+}
+
+gchar *cachedDefaultTest_to_string(InputRec inputRec, Param param){
+    MkdgCachedDefault_InputRec *inRec=(MkdgCachedDefault_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s,default=%s,validValues=%s\tvalue=%s",
+	    mkdg_type_to_string(inRec->mType), inRec->defaultValue, inRec->validValues, inRec->valueStr);
+}
+
+gboolean cachedDefaultTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgCachedDefault_TestRec *rec=(MkdgCachedDefault_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgCachedDefault_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=cachedDefaultTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of cached default test ===*/
+
+/*=== Start of valid values test ===*/
+#define VALID_VALUES_ITERATIONS 100
+#define VALID_VALUES_ALLOCATED -100
+
+typedef struct {
+    MkdgType mType;
+    const gchar *validValues;
+    const gchar *compareOption;
+    MkdgPropertyFlags flags;
+    const gchar *defaultValue;
+    const gchar *valueStr;
+} MkdgValidValues_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgValidValues_InputRec in;
+} MkdgValidValues_TestRec;
+
+/*
+ * Output is the valueIndex after setting valueStr, or the default if valueStr is NULL;
+ * VALID_VALUES_ALLOCATED if looking up the index allocates.
+ */
+MkdgValidValues_TestRec VALID_VALUES_DATASET[]={
+    {{2}, {MKDG_TYPE_STRING, "default;hsu;dvorak;dvorak_hsu", NULL, 0, NULL, "dvorak"}},
+    {{-1}, {MKDG_TYPE_STRING, "default;hsu;dvorak;dvorak_hsu", NULL, 0, NULL, "eten"}},
+    {{-1}, {MKDG_TYPE_STRING, "default;hsu;dvorak;dvorak_hsu", NULL, 0, NULL, "DVORAK"}},
+    {{2}, {MKDG_TYPE_STRING, "default;hsu;dvorak;dvorak_hsu", "icase", 0, NULL, "DVORAK"}},
+    {{1}, {MKDG_TYPE_STRING, "default;hsu;dvorak;hsu", NULL, 0, NULL, "hsu"}},
+    {{1}, {MKDG_TYPE_INT, "4;0x10;8", NULL, 0, NULL, "16"}},
+    {{0}, {MKDG_TYPE_DOUBLE, "1.5;2.5", NULL, 0, NULL, "1.50"}},
+    {{2}, {MKDG_TYPE_STRING, "default;hsu;dvorak", NULL, MKDG_PROPERTY_FLAG_FIXED_SET, "dvorak", NULL}},
+    {{0}, {MKDG_TYPE_STRING, "default;hsu;dvorak", NULL, MKDG_PROPERTY_FLAG_FIXED_SET, "eten", NULL}},
+    {{0}, {MKDG_TYPE_STRING, "default;hsu;dvorak", NULL, MKDG_PROPERTY_FLAG_FIXED_SET, NULL, NULL}},
+    {{-1}, {MKDG_TYPE_INVALID, NULL, NULL, 0, NULL, NULL}},
+};
+
+OutputRec validValuesTest_run_func(InputRec inputRec, Param param){
+    MkdgValidValues_InputRec *inRec=(MkdgValidValues_InputRec *) inputRec;
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup("validValues"), inRec->mType,
+	    g_strdup(inRec->defaultValue), g_strsplit(inRec->validValues, ";", -1), NULL, NULL,
+	    g_strdup(inRec->compareOption),
+	    0.0, 1000.0, 1.0, 1, inRec->flags,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, NULL, NULL);
+    MkdgPropertyContext *ctx=mkdg_property_context_new(spec, NULL);
+    if (inRec->valueStr){
+	mkdg_property_from_string(ctx, inRec->valueStr);
+    }else{
+	mkdg_property_set_default(ctx);
+    }
+    gint ret=ctx->valueIndex;
+
+    gint i;
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_copy(ctx->value, mValue);
+    allocCount=0;
+    allocCounting=TRUE;
+    for(i=0;i<VALID_VALUES_ITERATIONS;i++){
+	mkdg_property_set_value_fast(ctx, mValue, -2);
+	if (ctx->valueIndex!=ret)
+	    ret=-2;
+    }
+    allocCounting=FALSE;
+    if (allocCount>0)
+	ret=VALID_VALUES_ALLOCATED;
+    mkdg_value_free(mValue);
+    mkdg_property_context_free(ctx);
+    output_rec_set_int(result, ret);
+    return result;
+}
+
+gchar *validValuesTest_to_string(InputRec inputRec, Param param){
+    MkdgValidValues_InputRec *inRec=(MkdgValidValues_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s,validValues=%s,compareOption=%s,flags=%X,default=%s\tvalue=%s",
+	    mkdg_type_to_string(inRec->mType), inRec->validValues, inRec->compareOption,
+	    inRec->flags, inRec->defaultValue, inRec->valueStr);
+}
+
+gboolean validValuesTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgValidValues_TestRec *rec=(MkdgValidValues_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgValidValues_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=validValuesTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of valid values test ===*/
+
+/*=== Start of enumeration test ===*/
+typedef struct {
+    MkdgType mType;
+    MkdgPropertyFlags flags;
+    const gchar *compareOption;
+    const gchar *valueStr;
+    const gchar *testValue;
+} MkdgEnum_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgEnum_InputRec in;
+} MkdgEnum_TestRec;
+
+#define ENUM_VALID_VALUES "default;hsu;ibm;gin_yieh;eten;dvorak;dvorak_hsu"
+
+/*
+ * Output is "type,index,string,compare", where compare is
+ * the result of comparing the value with testValue.
+ * Invalid names are rejected, so the value is not set and index is -1.
+ */
+MkdgEnum_TestRec ENUM_DATASET[]={
+    {{.v_string="ENUM,5,dvorak,1"}, {MKDG_TYPE_STRING, MKDG_PROPERTY_FLAG_ENUM, NULL, "dvorak", "hsu"}},
+    {{.v_string="ENUM,1,hsu,0"}, {MKDG_TYPE_STRING, MKDG_PROPERTY_FLAG_ENUM, NULL, "hsu", "hsu"}},
+    {{.v_string="ENUM,0,default,-1"}, {MKDG_TYPE_ENUM, 0, NULL, "default", "eten"}},
+    {{.v_string="ENUM,-1,default,0"}, {MKDG_TYPE_ENUM, 0, NULL, "no_such_layout", "default"}},
+    {{.v_string="ENUM,6,dvorak_hsu,0"}, {MKDG_TYPE_ENUM, 0, "icase", "DVORAK_HSU", "Dvorak_Hsu"}},
+    {{.v_string="STRING,5,dvorak,-1"}, {MKDG_TYPE_STRING, MKDG_PROPERTY_FLAG_FIXED_SET, NULL, "dvorak", "hsu"}},
+    {{0}, {MKDG_TYPE_INVALID, 0, NULL, NULL, NULL}},
+};
+
+OutputRec enumTest_run_func(InputRec inputRec, Param param){
+    MkdgEnum_InputRec *inRec=(MkdgEnum_InputRec *) inputRec;
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup("enum"), inRec->mType,
+	    NULL, g_strsplit(ENUM_VALID_VALUES, ";", -1), NULL, NULL,
+	    g_strdup(inRec->compareOption),
+	    0.0, 0.0, 0.0, 0, inRec->flags,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, NULL, NULL);
+    MkdgPropertyContext *ctx=mkdg_property_context_new(spec, NULL);
+    mkdg_property_from_string(ctx, inRec->valueStr);
+
+    const MkdgValueCodec *codec=mkdg_property_spec_get_codec(spec);
+    MkdgValue mTestValue;
+    mkdg_value_init(&mTestValue, spec->valueType);
+    mkdg_value_codec_from_string(codec, &mTestValue, inRec->testValue);
+    gchar *str=mkdg_property_to_string(ctx);
+    gchar *resultStr=g_strdup_printf("%s,%d,%s,%d", mkdg_type_to_string(ctx->value->mType),
+	    ctx->valueIndex, str, mkdg_value_codec_compare(codec, ctx->value, &mTestValue));
+    g_free(str);
+    mkdg_value_clear(&mTestValue);
+    mkdg_property_context_free(ctx);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *enumTest_to_string(InputRec inputRec, Param param){
+    MkdgEnum_InputRec *inRec=(MkdgEnum_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s,flags=%X,compareOption=%s\tvalue=%s\ttestValue=%s",
+	    mkdg_type_to_string(inRec->mType), inRec->flags, inRec->compareOption,
+	    inRec->valueStr, inRec->testValue);
+}
+
+gboolean enumTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgEnum_TestRec *rec=(MkdgEnum_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgEnum_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=enumTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of enumeration test ===*/
+
+/*=== Start of flags test ===*/
+typedef struct {
+    const gchar *compareOption;
+    const gchar *valueStr;
+    const gchar *testValue;
+} MkdgFlags_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgFlags_InputRec in;
+} MkdgFlags_TestRec;
+
+#define FLAGS_VALID_VALUES "shift;ctrl;alt;super"
+#define FLAGS_DEFAULT_VALUE "ctrl|alt"
+
+/*
+ * Output is "string,mask,compare,isDefault", where compare is
+ * the result of comparing the value with testValue.
+ * Strings with unknown flags are rejected, so the value stays default.
+ */
+MkdgFlags_TestRec FLAGS_DATASET[]={
+    {{.v_string="shift|alt,5,0,0"}, {NULL, "shift|alt", "alt shift"}},
+    {{.v_string="shift|ctrl|alt,7,-1,0"}, {NULL, "alt;ctrl | shift", "super"}},
+    {{.v_string="ctrl|alt,6,0,1"}, {NULL, "alt|ctrl", FLAGS_DEFAULT_VALUE}},
+    {{.v_string="shift|super,9,0,0"}, {"icase", "SHIFT|Super", "super|shift"}},
+    {{.v_string="ctrl|alt,6,0,1"}, {NULL, "shift|hyper", FLAGS_DEFAULT_VALUE}},
+    {{.v_string="ctrl|0x100,102,1,0"}, {NULL, "ctrl|0x100", "ctrl"}},
+    {{.v_string=",0,-1,0"}, {NULL, "", "shift"}},
+    {{0}, {NULL, NULL, NULL}},
+};
+
+OutputRec flagsTest_run_func(InputRec inputRec, Param param){
+    MkdgFlags_InputRec *inRec=(MkdgFlags_InputRec *) inputRec;
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup("flags"), MKDG_TYPE_FLAGS,
+	    g_strdup(FLAGS_DEFAULT_VALUE), g_strsplit(FLAGS_VALID_VALUES, ";", -1), NULL, NULL,
+	    g_strdup(inRec->compareOption),
+	    0.0, 0.0, 0.0, 0, 0,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, NULL, NULL);
+    MkdgPropertyContext *ctx=mkdg_property_context_new(spec, NULL);
+    mkdg_property_set_default(ctx);
+    mkdg_property_from_string(ctx, inRec->valueStr);
+
+    const MkdgValueCodec *codec=mkdg_property_spec_get_codec(spec);
+    MkdgValue mTestValue;
+    mkdg_value_init(&mTestValue, spec->valueType);
+    mkdg_value_codec_from_string(codec, &mTestValue, inRec->testValue);
+    gchar *str=mkdg_property_to_string(ctx);
+    gchar *resultStr=g_strdup_printf("%s,%" G_GINT64_MODIFIER "x,%d,%d", str,
+	    mkdg_value_get_flags(ctx->value), mkdg_value_codec_compare(codec, ctx->value, &mTestValue),
+	    mkdg_property_is_default(ctx));
+    g_free(str);
+    mkdg_value_clear(&mTestValue);
+    mkdg_property_context_free(ctx);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *flagsTest_to_string(InputRec inputRec, Param param){
+    MkdgFlags_InputRec *inRec=(MkdgFlags_InputRec *) inputRec;
+    return g_strdup_printf("compareOption=%s\tvalue=%s\ttestValue=%s",
+	    inRec->compareOption, inRec->valueStr, inRec->testValue);
+}
+
+gboolean flagsTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgFlags_TestRec *rec=(MkdgFlags_TestRec *) testSubject->dataSet;
+    for(;rec->in.valueStr!=NULL;rec++){
+	MkdgFlags_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=flagsTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of flags test ===*/
+
+/*=== Start of handle test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *valueStr;
+    gint count;
+    const gchar *key;
+    gboolean replace;
+} MkdgHandle_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgHandle_InputRec in;
+} MkdgHandle_TestRec;
+
+/*
+ * Property i has a control rule on property i+1, which is added later.
+ * If replace is TRUE, the context of key is added again.
+ * Output is "handle,count,set,value,ruleTarget,ordered", where value is
+ * read back by handle after setting valueStr by handle, and ordered is 1
+ * if properties are visited in the order of ids.
+ */
+MkdgHandle_TestRec HANDLE_DATASET[]={
+    {{.v_string="0,1,1,103,(none),1"}, {MKDG_TYPE_INT, "103", 1, "handle0", FALSE}},
+    {{.v_string="3,10,1,TRUE,handle4,1"}, {MKDG_TYPE_BOOLEAN, "TRUE", 10, "handle3", FALSE}},
+    {{.v_string="0,10,1,TRUE,handle1,1"}, {MKDG_TYPE_BOOLEAN, "TRUE", 10, "handle0", TRUE}},
+    {{.v_string="99,100,1,dvorak_hsu_layout,(none),1"}, {MKDG_TYPE_STRING, "dvorak_hsu_layout", 100, "handle99", FALSE}},
+    {{.v_string="500,1000,1,新酷音;輸入法,handle501,1"}, {MKDG_TYPE_STRING_LIST, "新酷音;輸入法", 1000, "handle500", FALSE}},
+    {{.v_string="999,1000,1,新酷音;輸入法,(none),1"}, {MKDG_TYPE_STRING_LIST, "新酷音;輸入法", 1000, "handle999", TRUE}},
+    {{.v_string="-1,10,0,(none),(none),1"}, {MKDG_TYPE_INT, "103", 10, "noSuchKey", FALSE}},
+    {{.v_string="-1,10,0,(none),(none),1"}, {MKDG_TYPE_INT, "103", 10, "handle10", FALSE}},
+    {{.v_string="-1,0,0,(none),(none),1"}, {MKDG_TYPE_INT, "103", 0, "handle0", FALSE}},
+    {{0}, {MKDG_TYPE_INVALID, NULL, 0, NULL, FALSE}},
+};
+
+typedef struct{
+    MkdgPropertyContext *target;
+    gint visited;
+} HandleTest_Visit;
+
+static void handleTest_each_rule(MkdgPropertyContext *ctx, MkdgWidgetControl control, gpointer userData){
+    HandleTest_Visit *visit=(HandleTest_Visit *) userData;
+    visit->target=ctx;
+    visit->visited++;
+}
+
+static void handleTest_each_property(gpointer key, gpointer value, gpointer userData){
+    HandleTest_Visit *visit=(HandleTest_Visit *) userData;
+    MkdgPropertyContext *ctx=(MkdgPropertyContext *) value;
+    if (ctx->id!=visit->visited || strcmp((const gchar *) key, ctx->spec->key)!=0)
+	visit->target=ctx;
+    visit->visited++;
+}
+
+static MkdgPropertyContext *handleTest_context_new(gint i, MkdgType mType){
+    MkdgControlRule *rules=g_new0(MkdgControlRule, 2);
+    rules[0].relation=MKDG_RELATION_EQUAL;
+    rules[0].testValue=g_strdup("");
+    rules[0].key=g_strdup_printf("handle%d", i+1);
+    rules[0].match=MKDG_WIDGET_CONTROL_SHOW;
+    rules[0].notMatch=MKDG_WIDGET_CONTROL_HIDE;
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("handle%d", i), mType,
+	    NULL, NULL, NULL, NULL, NULL,
+	    0.0, 1000.0, 1.0, 1, 0,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, rules, NULL);
+    return mkdg_property_context_new(spec, NULL);
+}
+
+OutputRec handleTest_run_func(InputRec inputRec, Param param){
+    MkdgHandle_InputRec *inRec=(MkdgHandle_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    gint i;
+    for(i=0;i<inRec->count;i++){
+	mkdg_add_property(mDialog, handleTest_context_new(i, inRec->mType));
+    }
+    MkdgPropertyHandle handle=mkdg_property_handle(mDialog, inRec->key);
+    if (inRec->replace && handle!=MKDG_PROPERTY_HANDLE_INVALID){
+	mkdg_add_property(mDialog, handleTest_context_new(handle, inRec->mType));
+    }
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, handle);
+
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_from_string(mValue, inRec->valueStr, NULL);
+    gboolean set=mkdg_set_value_by_handle(mDialog, handle, mValue);
+    mkdg_value_free(mValue);
+    MkdgValue *curValue=mkdg_get_value_by_handle(mDialog, handle);
+    gchar *valueStr=NULL;
+    if (!curValue){
+	valueStr=g_strdup("(none)");
+    }else if (ctx->id!=handle || mkdg_get_value(mDialog, inRec->key)!=curValue){
+	valueStr=g_strdup("(mismatch)");
+    }else{
+	valueStr=mkdg_value_to_string(curValue, NULL);
+    }
+
+    HandleTest_Visit ruleVisit={NULL, 0};
+    if (ctx)
+	mkdg_property_foreach_control_rule(ctx, handleTest_each_rule, &ruleVisit);
+    HandleTest_Visit propertyVisit={NULL, 0};
+    mkdg_foreach_property(mDialog, handleTest_each_property, &propertyVisit);
+
+    gchar *resultStr=g_strdup_printf("%d,%u,%d,%s,%s,%d", handle, mkdg_get_property_count(mDialog), set, valueStr,
+	    (ruleVisit.target) ? ruleVisit.target->spec->key : "(none)",
+	    (propertyVisit.visited==inRec->count && propertyVisit.target==NULL));
+    g_free(valueStr);
+    mkdg_destroy(mDialog);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *handleTest_to_string(InputRec inputRec, Param param){
+    MkdgHandle_InputRec *inRec=(MkdgHandle_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s,value=%s,count=%d,replace=%d\tkey=%s",
+	    mkdg_type_to_string(inRec->mType), inRec->valueStr, inRec->count, inRec->replace, inRec->key);
+}
+
+gboolean handleTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgHandle_TestRec *rec=(MkdgHandle_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgHandle_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=handleTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of handle test ===*/
+
+/*=== Start of freeze test ===*/
+typedef struct {
+    const gchar *keyFormat;
+    gint count;
+    const gchar *key;
+} MkdgFreeze_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgFreeze_InputRec in;
+} MkdgFreeze_TestRec;
+
+/*
+ * Properties are named by keyFormat with 0 to count-1, then frozen twice.
+ * Output is "frozenBefore,frozenAfter,handle,added,count", where handle is
+ * looked up by key, and added is whether a property can be added after freezing.
+ */
+MkdgFreeze_TestRec FREEZE_DATASET[]={
+    {{.v_string="0,1,-1,0,0"}, {"key%d", 0, "key0"}},
+    {{.v_string="0,1,0,0,1"}, {"key%d", 1, "key0"}},
+    {{.v_string="0,1,1,0,2"}, {"key%d", 2, "key1"}},
+    {{.v_string="0,1,-1,0,2"}, {"key%d", 2, "key"}},
+    {{.v_string="0,1,-1,0,2"}, {"key%d", 2, "key1_"}},
+    {{.v_string="0,1,-1,0,3"}, {"key%d", 3, ""}},
+    {{.v_string="0,1,3,0,4"}, {"key%d", 4, "key3"}},
+    {{.v_string="0,1,3,0,5"}, {"chewing/%d", 5, "chewing/3"}},
+    {{.v_string="0,1,-1,0,5"}, {"chewing/%d", 5, "chewing/"}},
+    {{.v_string="0,1,99,0,100"}, {"新酷音_%d", 100, "新酷音_99"}},
+    {{.v_string="0,1,-1,0,100"}, {"新酷音_%d", 100, "新酷音_100"}},
+    {{.v_string="0,1,4999,0,5000"}, {"ibus/engine/chewing/propertyWithALongerKey%05d", 5000,
+	"ibus/engine/chewing/propertyWithALongerKey04999"}},
+    {{.v_string="0,1,-1,0,5000"}, {"ibus/engine/chewing/propertyWithALongerKey%05d", 5000,
+	"ibus/engine/chewing/propertyWithALongerKey0499"}},
+    {{0}, {NULL, 0, NULL}},
+};
+
+OutputRec freezeTest_run_func(InputRec inputRec, Param param){
+    MkdgFreeze_InputRec *inRec=(MkdgFreeze_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    gint i;
+    for(i=0;i<inRec->count;i++){
+	MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf(inRec->keyFormat, i), MKDG_TYPE_INT,
+		NULL, NULL, NULL, NULL, NULL,
+		0.0, 1000.0, 1.0, 1, 0,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL);
+	mkdg_add_property(mDialog, mkdg_property_context_new(spec, NULL));
+    }
+    gboolean frozenBefore=mkdg_is_frozen(mDialog);
+    gboolean frozenAfter=mkdg_freeze(mDialog) && mkdg_freeze(mDialog) && mkdg_is_frozen(mDialog);
+
+    MkdgPropertyHandle handle=mkdg_property_handle(mDialog, inRec->key);
+    MkdgPropertyContext *ctx=mkdg_get_property_context(mDialog, inRec->key);
+    if (ctx!=mkdg_get_property_context_by_handle(mDialog, handle)
+	    || (ctx && strcmp(ctx->spec->key, inRec->key)!=0)){
+	handle=-2;
+    }
+
+    MkdgPropertySpec *spec=mkdg_property_spec_new(g_strdup("addedAfterFreeze"), MKDG_TYPE_INT);
+    ctx=mkdg_property_context_new(spec, NULL);
+    gboolean added=mkdg_add_property(mDialog, ctx);
+    if (!added)
+	mkdg_property_context_free(ctx);
+
+    gchar *resultStr=g_strdup_printf("%d,%d,%d,%d,%u", frozenBefore, frozenAfter, handle,
+	    added || mkdg_property_handle(mDialog, "addedAfterFreeze")!=MKDG_PROPERTY_HANDLE_INVALID,
+	    mkdg_get_property_count(mDialog));
+    mkdg_destroy(mDialog);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *freezeTest_to_string(InputRec inputRec, Param param){
+    MkdgFreeze_InputRec *inRec=(MkdgFreeze_InputRec *) inputRec;
+    return g_strdup_printf("keyFormat=%s,count=%d\tkey=%s", inRec->keyFormat, inRec->count, inRec->key);
+}
+
+gboolean freezeTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgFreeze_TestRec *rec=(MkdgFreeze_TestRec *) testSubject->dataSet;
+    for(;rec->in.keyFormat!=NULL;rec++){
+	MkdgFreeze_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=freezeTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of freeze test ===*/
+
+/*=== Start of value store test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *defaultStr;
+    const gchar *valueStr;
+    gint count;
+    gint step;
+} MkdgValueStore_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgValueStore_InputRec in;
+} MkdgValueStore_TestRec;
+
+/*
+ * Every step-th property is set to valueStr, others are default.
+ * Output is "ids,value,restored,restoredAgain,diffAfterRestore,diffWithEmpty", where
+ * ids are the properties that differ from defaults, value is the stored value of the last of them,
+ * restored and restoredAgain are the number of properties set by restoring the defaults twice.
+ */
+MkdgValueStore_TestRec VALUE_STORE_DATASET[]={
+    {{.v_string="0,TRUE,1,0,0,1"}, {MKDG_TYPE_BOOLEAN, "FALSE", "TRUE", 1, 1}},
+    {{.v_string="0;1,-5,2,0,0,2"}, {MKDG_TYPE_INT, "3", "-5", 2, 1}},
+    {{.v_string=",3,0,0,0,10"}, {MKDG_TYPE_INT, "3", "3", 10, 2}},
+    {{.v_string="0;3;6;9,18446744073709551615,4,0,0,10"}, {MKDG_TYPE_UINT64, "0", "18446744073709551615", 10, 3}},
+    {{.v_string="0;4;8,0.25,3,0,0,10"}, {MKDG_TYPE_FLOAT, "1.5", "0.25", 10, 4}},
+    {{.v_string="0;30;60;90,-2.25,4,0,0,100"}, {MKDG_TYPE_DOUBLE, "0.5", "-2.25", 100, 30}},
+    {{.v_string="0;50,default,2,0,0,100"}, {MKDG_TYPE_STRING, "dvorak_hsu_layout", "default", 100, 50}},
+    {{.v_string="0;400;800,新酷音;注音,3,0,0,1000"}, {MKDG_TYPE_STRING_LIST, "新酷音;輸入法", "新酷音;注音", 1000, 400}},
+    {{0}, {MKDG_TYPE_INVALID, NULL, NULL, 0, 0}},
+};
+
+OutputRec valueStoreTest_run_func(InputRec inputRec, Param param){
+    MkdgValueStore_InputRec *inRec=(MkdgValueStore_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    gint i;
+    for(i=0;i<inRec->count;i++){
+	MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("valueStore%d", i), inRec->mType,
+		g_strdup(inRec->defaultStr), NULL, NULL, NULL, NULL,
+		-1000.0, 1000.0, 1.0, 2, 0,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL);
+	mkdg_add_property(mDialog, mkdg_property_context_new(spec, NULL));
+	mkdg_set_value_by_handle(mDialog, i, NULL);
+    }
+    MkdgValueStore *defaults=mkdg_value_store_new_defaults(mDialog);
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_from_string(mValue, inRec->valueStr, NULL);
+    for(i=0;i<inRec->count;i+=inRec->step){
+	mkdg_set_value_by_handle(mDialog, i, mValue);
+    }
+    MkdgValueStore *changed=mkdg_value_store_snapshot(mDialog);
+
+    MkdgPropertyHandle *ids=g_new(MkdgPropertyHandle, inRec->count);
+    guint diffCount=mkdg_value_store_diff(defaults, changed, ids);
+    GString *strBuf=g_string_new(NULL);
+    for(i=0;i<(gint) diffCount;i++){
+	g_string_append_printf(strBuf, (i>0) ? ";%d" : "%d", ids[i]);
+    }
+
+    /* Stored value is the property value */
+    MkdgPropertyHandle lastId=(diffCount>0) ? ids[diffCount-1] : 0;
+    gchar *valueStr=NULL;
+    if (mkdg_value_store_get(changed, lastId, mValue)
+	    && mkdg_value_equal(mValue, mkdg_get_value_by_handle(mDialog, lastId))){
+	valueStr=mkdg_value_to_string(mValue, NULL);
+    }else{
+	valueStr=g_strdup("(mismatch)");
+    }
+    g_string_append_printf(strBuf, ",%s", valueStr);
+    g_free(valueStr);
+    mkdg_value_free(mValue);
+
+    guint restored=mkdg_value_store_restore(defaults, mDialog);
+    guint restoredAgain=mkdg_value_store_restore(defaults, mDialog);
+    MkdgValueStore *snapshot=mkdg_value_store_snapshot(mDialog);
+    MkdgValueStore *empty=mkdg_value_store_new(0);
+    g_string_append_printf(strBuf, ",%u,%u,%u,%u", restored, restoredAgain,
+	    mkdg_value_store_diff(defaults, snapshot, NULL), mkdg_value_store_diff(snapshot, empty, NULL));
+
+    mkdg_value_store_free(empty);
+    mkdg_value_store_free(snapshot);
+    mkdg_value_store_free(changed);
+    mkdg_value_store_free(defaults);
+    g_free(ids);
+    mkdg_destroy(mDialog);
+    output_rec_set_string(result, g_string_free(strBuf, FALSE));
+    return result;
+}
+
+gchar *valueStoreTest_to_string(InputRec inputRec, Param param){
+    MkdgValueStore_InputRec *inRec=(MkdgValueStore_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s,default=%s,value=%s\tcount=%d,step=%d",
+	    mkdg_type_to_string(inRec->mType), inRec->defaultStr, inRec->valueStr, inRec->count, inRec->step);
+}
+
+gboolean valueStoreTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgValueStore_TestRec *rec=(MkdgValueStore_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgValueStore_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=valueStoreTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of value store test ===*/
+
+/*=== Start of dirty test ===*/
+typedef struct {
+    gint pageCount;
+    gint count;
+    const gchar *setHandles;
+    const gchar *savedHandles;
+} MkdgDirty_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgDirty_InputRec in;
+} MkdgDirty_TestRec;
+
+/*
+ * Property i is in page i % pageCount. All properties are applied and saved,
+ * then setHandles are set, dirty properties are applied, and savedHandles are saved.
+ * Output is "initial,dirtyHandles,dirtyPages,applied,dirtyPagesAfterSave,unsavedAfterSave", where
+ * initial is the number of properties applied from defaults.
+ */
+MkdgDirty_TestRec DIRTY_DATASET[]={
+    {{.v_string="1,0,0,1,,0"}, {1, 1, "0", "0"}},
+    {{.v_string="10,9,1,1,,0"}, {2, 10, "9", "9"}},
+    {{.v_string="10,3;9,1,2,1,1"}, {2, 10, "3;9", "9"}},
+    {{.v_string="10,3;9,1,2,,0"}, {2, 10, "9;3;9", "3;9"}},
+    {{.v_string="64,63,0,1,,0"}, {3, 64, "63", "63"}},
+    {{.v_string="65,0;64,0;4,2,0,1"}, {5, 65, "0;64", "64"}},
+    {{.v_string="1000,999,9,1,,0"}, {10, 1000, "999", "999"}},
+    {{.v_string="1000,,,0,,0"}, {10, 1000, "", ""}},
+    {{0}, {0, 0, NULL, NULL}},
+};
+
+static void dirtyTest_apply(MkdgPropertyContext *ctx, MkdgValue *value){
+    gint *appliedCount=(gint *) ctx->userData;
+    (*appliedCount)++;
+}
+
+static void dirtyTest_append_dirty_pages(GString *strBuf, Mkdg *mDialog, gint pageCount){
+    gchar pageName[20];
+    gboolean first=TRUE;
+    gint i;
+    g_string_append_c(strBuf, ',');
+    for(i=0;i<pageCount;i++){
+	g_snprintf(pageName, 20, "page%d", i);
+	if (mkdg_page_is_dirty(mDialog, pageName)){
+	    g_string_append_printf(strBuf, (first) ? "%d" : ";%d", i);
+	    first=FALSE;
+	}
+    }
+}
+
+OutputRec dirtyTest_run_func(InputRec inputRec, Param param){
+    MkdgDirty_InputRec *inRec=(MkdgDirty_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    gint i, appliedCount=0;
+    for(i=0;i<inRec->count;i++){
+	MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("dirty%d", i), MKDG_TYPE_INT,
+		g_strdup("3"), NULL, NULL, NULL, NULL,
+		0.0, 1000.0, 1.0, 1, 0,
+		g_strdup_printf("page%d", i % inRec->pageCount), NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL);
+	mkdg_add_property(mDialog, mkdg_property_context_new_full(spec, &appliedCount, NULL, dirtyTest_apply));
+	mkdg_set_value_by_handle(mDialog, i, NULL);
+    }
+    GString *strBuf=g_string_new(NULL);
+    guint applied=mkdg_apply_dirty(mDialog);
+    g_string_printf(strBuf, "%d", (applied==(guint) appliedCount) ? appliedCount : -1);
+    for(i=0;i<inRec->count;i++){
+	mkdg_get_property_context_by_handle(mDialog, i)->flags&=~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
+    }
+
+    gchar **setHandles=g_strsplit(inRec->setHandles, ";", -1);
+    MkdgValue *mValue=mkdg_value_new(MKDG_TYPE_INT, NULL);
+    mkdg_value_set_int(mValue, 7);
+    for(i=0;setHandles[i]!=NULL;i++){
+	mkdg_set_value_by_handle(mDialog, atoi(setHandles[i]), mValue);
+    }
+    mkdg_value_free(mValue);
+    g_strfreev(setHandles);
+
+    MkdgPropertyHandle *handles=g_new(MkdgPropertyHandle, inRec->count);
+    guint dirtyCount=mkdg_get_dirty_handles(mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED, handles);
+    g_string_append_c(strBuf, ',');
+    for(i=0;i<(gint) dirtyCount;i++){
+	g_string_append_printf(strBuf, (i>0) ? ";%d" : "%d", handles[i]);
+    }
+    g_free(handles);
+    dirtyTest_append_dirty_pages(strBuf, mDialog, inRec->pageCount);
+
+    appliedCount=0;
+    applied=mkdg_apply_dirty(mDialog);
+    g_string_append_printf(strBuf, ",%d", (applied==(guint) appliedCount) ? appliedCount : -1);
+
+    gchar **savedHandles=g_strsplit(inRec->savedHandles, ";", -1);
+    for(i=0;savedHandles[i]!=NULL;i++){
+	mkdg_get_property_context_by_handle(mDialog, atoi(savedHandles[i]))->flags&=~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
+    }
+    g_strfreev(savedHandles);
+    dirtyTest_append_dirty_pages(strBuf, mDialog, inRec->pageCount);
+    g_string_append_printf(strBuf, ",%u", mkdg_get_dirty_handles(mDialog, ~0, NULL));
+
+    mkdg_destroy(mDialog);
+    output_rec_set_string(result, g_string_free(strBuf, FALSE));
+    return result;
+}
+
+gchar *dirtyTest_to_string(InputRec inputRec, Param param){
+    MkdgDirty_InputRec *inRec=(MkdgDirty_InputRec *) inputRec;
+    return g_strdup_printf("pageCount=%d,count=%d\tset=%s\tsaved=%s",
+	    inRec->pageCount, inRec->count, inRec->setHandles, inRec->savedHandles);
+}
+
+gboolean dirtyTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgDirty_TestRec *rec=(MkdgDirty_TestRec *) testSubject->dataSet;
+    for(;rec->in.count>0;rec++){
+	MkdgDirty_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=dirtyTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of dirty test ===*/
+
+/*=== Start of set values test ===*/
+#define SET_VALUES_COUNT 5
+
+typedef struct {
+    const gchar *keyValues;
+    MkdgSetValuesFlags flags;
+} MkdgSetValues_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgSetValues_InputRec in;
+} MkdgSetValues_TestRec;
+
+/*
+ * There are SET_VALUES_COUNT properties with default 5, values above 100 are invalid.
+ * Property i hides property i+1 unless its value is 5.
+ * keyValues are "key=value" separated by ';', a key without value sets the default.
+ * Output is "setCount,values,hiddenHandles,unapplied,applied".
+ */
+MkdgSetValues_TestRec SET_VALUES_DATASET[]={
+    {{.v_string="0,5;5;5;5;5,,0,0"}, {"setValues1=7;setValues4=200", MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING}},
+    {{.v_string="1,5;7;5;5;5,2,1,0"}, {"setValues1=7;setValues4=200", 0}},
+    {{.v_string="3,5;7;8;5;5,2;3,2,0"}, {"setValues0=5;setValues1=7;setValues2=8", 0}},
+    {{.v_string="2,7;5;5;5;5,1,0,1"}, {"setValues0=8;setValues0=7", MKDG_SET_VALUES_FLAG_APPLY}},
+    {{.v_string="2,5;5;5;5;5,,0,0"}, {"setValues1=7;setValues1", 0}},
+    {{.v_string="2,5;5;1;2;5,3;4,0,2"}, {"setValues2=1;setValues3=2",
+	MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING | MKDG_SET_VALUES_FLAG_APPLY}},
+    {{.v_string="0,5;5;5;5;5,,0,0"}, {"noSuchKey=5;setValues3=9", MKDG_SET_VALUES_FLAG_ALL_OR_NOTHING}},
+    {{.v_string="1,5;5;5;9;5,4,1,0"}, {"noSuchKey=5;setValues3=9", 0}},
+    {{.v_string="0,5;5;5;5;5,,0,0"}, {"setValues4=101", 0}},
+    {{0}, {NULL, 0}},
+};
+
+static gboolean setValuesTest_validate(MkdgPropertySpec *spec, MkdgValue *value){
+    return (mkdg_value_get_int(value)<=100) ? TRUE : FALSE;
+}
+
+static void setValuesTest_apply(MkdgPropertyContext *ctx, MkdgValue *value){
+    gint *appliedCount=(gint *) ctx->userData;
+    (*appliedCount)++;
+}
+
+static MkdgPropertyContext *setValuesTest_context_new(gint i, gint *appliedCount){
+    MkdgControlRule *rules=g_new0(MkdgControlRule, 2);
+    rules[0].relation=MKDG_RELATION_EQUAL;
+    rules[0].testValue=g_strdup("5");
+    rules[0].key=g_strdup_printf("setValues%d", i+1);
+    rules[0].match=MKDG_WIDGET_CONTROL_SHOW;
+    rules[0].notMatch=MKDG_WIDGET_CONTROL_HIDE;
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("setValues%d", i), MKDG_TYPE_INT,
+	    g_strdup("5"), NULL, NULL, NULL, NULL,
+	    0.0, 1000.0, 1.0, 1, 0,
+	    NULL, NULL, NULL, NULL,
+	    NULL, NULL, rules, NULL);
+    return mkdg_property_context_new_full(spec, appliedCount, setValuesTest_validate, setValuesTest_apply);
+}
+
+OutputRec setValuesTest_run_func(InputRec inputRec, Param param){
+    MkdgSetValues_InputRec *inRec=(MkdgSetValues_InputRec *) inputRec;
+    Mkdg *mDialog=mkdg_new();
+    gint i, appliedCount=0;
+    for(i=0;i<SET_VALUES_COUNT;i++){
+	mkdg_add_property(mDialog, setValuesTest_context_new(i, &appliedCount));
+	mkdg_set_value_by_handle(mDialog, i, NULL);
+    }
+    mkdg_apply_dirty(mDialog);
+    for(i=0;i<SET_VALUES_COUNT;i++){
+	mkdg_get_property_context_by_handle(mDialog, i)->flags&=~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
+    }
+    appliedCount=0;
+
+    gchar **keyValues=g_strsplit(inRec->keyValues, ";", -1);
+    guint count=g_strv_length(keyValues);
+    gchar **keys=g_new0(gchar *, count+1);
+    MkdgValue **values=g_new0(MkdgValue *, count);
+    for(i=0;i<(gint) count;i++){
+	gchar **pair=g_strsplit(keyValues[i], "=", 2);
+	keys[i]=g_strdup(pair[0]);
+	if (pair[1]){
+	    values[i]=mkdg_value_new(MKDG_TYPE_INT, NULL);
+	    mkdg_value_from_string(values[i], pair[1], NULL);
+	}
+	g_strfreev(pair);
+    }
+    g_strfreev(keyValues);
+    guint setCount=mkdg_set_values(mDialog, (const gchar **) keys, values, count, inRec->flags);
+
+    GString *valuesBuf=g_string_new(NULL);
+    GString *hiddenBuf=g_string_new(NULL);
+    for(i=0;i<SET_VALUES_COUNT;i++){
+	MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, i);
+	g_string_append_printf(valuesBuf, (i>0) ? ";%d" : "%d", mkdg_value_get_int(ctx->value));
+	if (ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_HIDDEN)
+	    g_string_append_printf(hiddenBuf, (hiddenBuf->len>0) ? ";%d" : "%d", i);
+    }
+    gchar *resultStr=g_strdup_printf("%u,%s,%s,%u,%d", setCount, valuesBuf->str, hiddenBuf->str,
+	    mkdg_get_dirty_handles(mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNAPPLIED, NULL), appliedCount);
+    g_string_free(hiddenBuf, TRUE);
+    g_string_free(valuesBuf, TRUE);
+    for(i=0;i<(gint) count;i++){
+	if (values[i])
+	    mkdg_value_free(values[i]);
+    }
+    g_free(values);
+    g_strfreev(keys);
+    mkdg_destroy(mDialog);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *setValuesTest_to_string(InputRec inputRec, Param param){
+    MkdgSetValues_InputRec *inRec=(MkdgSetValues_InputRec *) inputRec;
+    return g_strdup_printf("flags=%X\tkeyValues=%s", inRec->flags, inRec->keyValues);
+}
+
+gboolean setValuesTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgSetValues_TestRec *rec=(MkdgSetValues_TestRec *) testSubject->dataSet;
+    for(;rec->in.keyValues!=NULL;rec++){
+	MkdgSetValues_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=setValuesTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of set values test ===*/
+
+/*=== Start of config load test ===*/
+#define CONFIG_TEST_FILENAME "check_property.ini"
+
+static gchar *configTest_dir_new(){
+    gchar *dir=g_build_filename(g_get_tmp_dir(), "check_property_config", NULL);
+    g_mkdir_with_parents(dir, 0755);
+    return dir;
+}
+
+static void configTest_file_remove(const gchar *dir, const gchar *filename){
+    gchar *path=g_build_filename(dir, filename, NULL);
+    g_remove(path);
+    g_free(path);
+}
+
+typedef struct {
+    MkdgType mType;
+    const gchar *validValues;
+    const gchar *defaultStr;
+    const gchar *fileStr;
+} MkdgConfigLoad_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgConfigLoad_InputRec in;
+} MkdgConfigLoad_TestRec;
+
+/*
+ * Output is the error code, the value after loading, and whether it is unsaved.
+ * Negative integers are rejected by the validate function.
+ */
+MkdgConfigLoad_TestRec CONFIG_LOAD_DATASET[]={
+    {{.v_string="0,Gamma,0"},	{MKDG_TYPE_ENUM, "Alpha;Beta;Gamma", "Alpha", "Gamma"}},
+    {{.v_string="7,Alpha,1"},	{MKDG_TYPE_ENUM, "Alpha;Beta;Gamma", "Alpha", "Delta"}},
+    {{.v_string="0,Alpha|Gamma,0"},{MKDG_TYPE_FLAGS, "Alpha;Beta;Gamma", "Beta", "Alpha|Gamma"}},
+    {{.v_string="7,Beta,1"},	{MKDG_TYPE_FLAGS, "Alpha;Beta;Gamma", "Beta", "Alpha|Delta"}},
+    {{.v_string="7,3,1"},	{MKDG_TYPE_INT, NULL, "3", "12x"}},
+    {{.v_string="0,12,0"},	{MKDG_TYPE_INT, NULL, "3", "12"}},
+    {{.v_string="0,3,1"},	{MKDG_TYPE_INT, NULL, "3", "-12"}},
+    {{.v_string="7,1;2,1"},	{MKDG_TYPE_INT_ARRAY, NULL, "1;2", "4;5;x"}},
+    {{.v_string="0,3.4028235e+38,0"},{MKDG_TYPE_FLOAT, NULL, "0", "3.4028235e+38"}},
+    {{0}, {MKDG_TYPE_INVALID, NULL, NULL, NULL}},
+};
+
+static gboolean configLoadTest_validate(MkdgPropertySpec *spec, MkdgValue *value){
+    return (value->mType!=MKDG_TYPE_INT || mkdg_value_get_int(value)>=0);
+}
+
+OutputRec configLoadTest_run_func(InputRec inputRec, Param param){
+    MkdgConfigLoad_InputRec *inRec=(MkdgConfigLoad_InputRec *) inputRec;
+    static const gchar *pageNames[]={"page0", NULL};
+    gchar *dir=configTest_dir_new();
+    const gchar *searchDirs[]={dir, NULL};
+    gchar *path=g_build_filename(dir, CONFIG_TEST_FILENAME, NULL);
+    gchar *content=g_strdup_printf("[page0]\nconfigLoad=%s\n", inRec->fileStr);
+    g_file_set_contents(path, content, -1, NULL);
+    g_free(content);
+    g_free(path);
+
+    Mkdg *mDialog=mkdg_new();
+    MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup("configLoad"), inRec->mType,
+	    g_strdup(inRec->defaultStr), (inRec->validValues) ? g_strsplit(inRec->validValues, ";", -1) : NULL,
+	    NULL, NULL, NULL,
+	    -G_MAXFLOAT, G_MAXFLOAT, 1.0, 0, 0,
+	    g_strdup("page0"), NULL, NULL, NULL,
+	    NULL, NULL, NULL, NULL);
+    mkdg_add_property(mDialog, mkdg_property_context_new_full(spec, NULL, configLoadTest_validate, NULL));
+    mkdg_set_value_by_handle(mDialog, 0, NULL);
+    MkdgConfig *config=mkdg_config_use_key_file(mDialog);
+    MkdgConfigSet *configSet=mkdg_config_set_new_full(pageNames, CONFIG_TEST_FILENAME, searchDirs,
+	    CONFIG_TEST_FILENAME, 1, 0, NULL, NULL);
+    MkdgError *cfgErr=NULL;
+    mkdg_config_add_config_set(config, configSet, &cfgErr);
+    if (!cfgErr)
+	mkdg_config_load_all(config, &cfgErr);
+    MkdgPropertyContext *ctx=mkdg_get_property_context_by_handle(mDialog, 0);
+    gchar *str=mkdg_property_to_string(ctx);
+    gchar *resultStr=g_strdup_printf("%d,%s,%d", (cfgErr) ? cfgErr->code : 0, str,
+	    (ctx->flags & MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED) ? 1 : 0);
+    g_free(str);
+    if (cfgErr)
+	g_error_free(cfgErr);
+    mkdg_destroy(mDialog);
+    configTest_file_remove(dir, CONFIG_TEST_FILENAME);
+    g_free(dir);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *configLoadTest_to_string(InputRec inputRec, Param param){
+    MkdgConfigLoad_InputRec *inRec=(MkdgConfigLoad_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s\tfileStr=%s", mkdg_type_to_string(inRec->mType), inRec->fileStr);
+}
+
+gboolean configLoadTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgConfigLoad_TestRec *rec=(MkdgConfigLoad_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgConfigLoad_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=configLoadTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of config load test ===*/
+
+/*=== Start of save dirty test ===*/
+typedef struct {
+    gint count;
+    gboolean saveProperties;
+    const gchar *setHandles;
+    gint failSet;
+} MkdgSaveDirty_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgSaveDirty_InputRec in;
+} MkdgSaveDirty_TestRec;
+
+/*
+ * Property i is in page i % 2, set i % 2 stores page i % 2.
+ * All properties are saved, then setHandles are set and saved twice,
+ * the first time set failSet fails to write.
+ * If saveProperties is FALSE, the key file back-end rewrites whole files.
+ * Output is "first|second", each is "ret,errorCode,unsavedHandles,set0,set1", where
+ * setN is "calls/count" that the back-end got, or whether the file is written.
+ */
+MkdgSaveDirty_TestRec SAVE_DIRTY_DATASET[]={
+    {{.v_string="1,0,,1/1,0/0|1,0,,1/1,0/0"}, {2, TRUE, "0", -1}},
+    {{.v_string="1,0,,1/1,0/0|1,0,,1/1,0/0"}, {10, TRUE, "8", -1}},
+    {{.v_string="1,0,,1/2,1/1|1,0,,1/2,1/1"}, {10, TRUE, "2;5;8", -1}},
+    {{.v_string="0,3,1,1/1,1/1|1,0,,1/1,2/2"}, {10, TRUE, "0;1", 1}},
+    {{.v_string="0,3,1;3;5,0/0,1/3|1,0,,0/0,2/6"}, {10, TRUE, "1;3;5", 1}},
+    {{.v_string="0,3,0;2,1/2,1/1|1,0,,2/4,1/1"}, {10, TRUE, "0;2;3", 0}},
+    {{.v_string="1,0,,written,untouched|1,0,,written,untouched"}, {2, FALSE, "0", -1}},
+    {{.v_string="1,0,,untouched,written|1,0,,untouched,written"}, {10, FALSE, "9", -1}},
+    {{0}, {0, FALSE, NULL, -1}},
+};
+
+#define SAVE_DIRTY_UNTOUCHED "# untouched\n"
+
+/* What the back-end got, as the userData of a config set */
+typedef struct {
+    gint calls;
+    guint count;
+    gboolean fail;
+} SaveDirtyRecord;
+
+static gboolean saveDirtyTest_save_properties(MkdgConfigFile *configFile, MkdgConfigBuffer *configBuf,
+	MkdgPropertyContext **ctxs, guint count, MkdgError **error){
+    SaveDirtyRecord *record=(SaveDirtyRecord *) configFile->configSet->userData;
+    record->calls++;
+    record->count+=count;
+    if (record->fail){
+	mkdg_error_handle(mkdg_error_new(MKDG_ERROR_CONFIG_CANT_WRITE, "saveDirtyTest_save_properties()"), error);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+static void saveDirtyTest_append_save(GString *strBuf, Mkdg *mDialog, MkdgSaveDirty_InputRec *inRec,
+	SaveDirtyRecord *records, const gchar *dir, const gchar **filenames){
+    MkdgError *cfgErr=NULL;
+    gboolean ret=mkdg_config_save_dirty(mDialog->config, &cfgErr);
+    g_string_append_printf(strBuf, "%d,%d,", ret, (cfgErr) ? cfgErr->code : 0);
+    if (cfgErr)
+	g_error_free(cfgErr);
+
+    MkdgPropertyHandle *handles=g_new(MkdgPropertyHandle, inRec->count);
+    guint unsavedCount=mkdg_get_dirty_handles(mDialog, MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED, handles);
+    guint i;
+    for(i=0;i<unsavedCount;i++){
+	g_string_append_printf(strBuf, (i>0) ? ";%d" : "%d", handles[i]);
+    }
+    g_free(handles);
+
+    for(i=0;i<2;i++){
+	if (inRec->saveProperties){
+	    g_string_append_printf(strBuf, ",%d/%u", records[i].calls, records[i].count);
+	}else{
+	    gchar *path=g_build_filename(dir, filenames[i], NULL);
+	    gchar *content=NULL;
+	    g_file_get_contents(path, &content, NULL, NULL);
+	    g_string_append_printf(strBuf, ",%s",
+		    (content && strcmp(content, SAVE_DIRTY_UNTOUCHED)==0) ? "untouched" : "written");
+	    g_free(content);
+	    g_free(path);
+	}
+    }
+}
+
+OutputRec saveDirtyTest_run_func(InputRec inputRec, Param param){
+    MkdgSaveDirty_InputRec *inRec=(MkdgSaveDirty_InputRec *) inputRec;
+    static const gchar *pageNames[2][2]={{"page0", NULL}, {"page1", NULL}};
+    const gchar *filenames[2]={"check_property_0.ini", "check_property_1.ini"};
+    gchar *dir=configTest_dir_new();
+    const gchar *searchDirs[]={dir, NULL};
+    MkdgConfigFileInterface configInterface=MKDG_CONFIG_FILE_INTERFACE_KEY_FILE;
+    SaveDirtyRecord records[2];
+    gint i;
+    if (inRec->saveProperties)
+	configInterface.config_file_save_properties=saveDirtyTest_save_properties;
+    memset(records, 0, sizeof(records));
+
+    Mkdg *mDialog=mkdg_new();
+    for(i=0;i<inRec->count;i++){
+	MkdgPropertySpec *spec=mkdg_property_spec_new_full(g_strdup_printf("saveDirty%d", i), MKDG_TYPE_INT,
+		g_strdup("3"), NULL, NULL, NULL, NULL,
+		0.0, 1000.0, 1.0, 1, 0,
+		g_strdup(pageNames[i % 2][0]), NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL);
+	mkdg_add_property(mDialog, mkdg_property_context_new(spec, NULL));
+	mkdg_set_value_by_handle(mDialog, i, NULL);
+	mkdg_get_property_context_by_handle(mDialog, i)->flags&=~MKDG_PROPERTY_CONTEXT_FLAG_UNSAVED;
+    }
+    MkdgConfig *config=mkdg_config_use_key_file(mDialog);
+    for(i=0;i<2;i++){
+	gchar *path=g_build_filename(dir, filenames[i], NULL);
+	g_file_set_contents(path, SAVE_DIRTY_UNTOUCHED, -1, NULL);
+	g_free(path);
+	mkdg_config_add_config_set(config, mkdg_config_set_new_full(pageNames[i], filenames[i], searchDirs,
+		    filenames[i], 1, 0, &configInterface, &records[i]), NULL);
+    }
+
+    gchar **setHandles=g_strsplit(inRec->setHandles, ";", -1);
+    MkdgValue *mValue=mkdg_value_new(MKDG_TYPE_INT, NULL);
+    mkdg_value_set_int(mValue, 7);
+    for(i=0;setHandles[i]!=NULL;i++){
+	mkdg_set_value_by_handle(mDialog, atoi(setHandles[i]), mValue);
+    }
+    mkdg_value_free(mValue);
+    g_strfreev(setHandles);
+
+    GString *strBuf=g_string_new(NULL);
+    if (inRec->failSet>=0)
+	records[inRec->failSet].fail=TRUE;
+    saveDirtyTest_append_save(strBuf, mDialog, inRec, records, dir, filenames);
+    g_string_append_c(strBuf, '|');
+    if (inRec->failSet>=0)
+	records[inRec->failSet].fail=FALSE;
+    saveDirtyTest_append_save(strBuf, mDialog, inRec, records, dir, filenames);
+
+    mkdg_destroy(mDialog);
+    for(i=0;i<2;i++){
+	configTest_file_remove(dir, filenames[i]);
+    }
+    g_free(dir);
+    output_rec_set_string(result, g_string_free(strBuf, FALSE));
+    return result;
+}
+
+gchar *saveDirtyTest_to_string(InputRec inputRec, Param param){
+    MkdgSaveDirty_InputRec *inRec=(MkdgSaveDirty_InputRec *) inputRec;
+    return g_strdup_printf("count=%d,saveProperties=%s\tset=%s\tfailSet=%d", inRec->count,
+	    (inRec->saveProperties) ? "TRUE" : "FALSE", inRec->setHandles, inRec->failSet);
+}
+
+gboolean saveDirtyTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgSaveDirty_TestRec *rec=(MkdgSaveDirty_TestRec *) testSubject->dataSet;
+    for(;rec->in.count>0;rec++){
+	MkdgSaveDirty_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=saveDirtyTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of save dirty test ===*/
+
+TestSubject TEST_COLLECTION[]={
+    {"Zero allocation",
+	ZERO_ALLOC_DATASET,
+	{0},
+	zeroAllocTest_foreach, zeroAllocTest_run_func, int_verify_func},
+    {"Cached default",
+	CACHED_DEFAULT_DATASET,
+	{0},
+	cachedDefaultTest_foreach, cachedDefaultTest_run_func, int_verify_func},
+    {"Valid values",
+	VALID_VALUES_DATASET,
+	{0},
+	validValuesTest_foreach, validValuesTest_run_func, int_verify_func},
+    {"Enumeration",
+	ENUM_DATASET,
+	{0},
+	enumTest_foreach, enumTest_run_func, string_verify_func},
+    {"Flags",
+	FLAGS_DATASET,
+	{0},
+	flagsTest_foreach, flagsTest_run_func, string_verify_func},
+    {"Handle",
+	HANDLE_DATASET,
+	{0},
+	handleTest_foreach, handleTest_run_func, string_verify_func},
+    {"Freeze",
+	FREEZE_DATASET,
+	{0},
+	freezeTest_foreach, freezeTest_run_func, string_verify_func},
+    {"Value store",
+	VALUE_STORE_DATASET,
+	{0},
+	valueStoreTest_foreach, valueStoreTest_run_func, string_verify_func},
+    {"Dirty",
+	DIRTY_DATASET,
+	{0},
+	dirtyTest_foreach, dirtyTest_run_func, string_verify_func},
+    {"Set values",
+	SET_VALUES_DATASET,
+	{0},
+	setValuesTest_foreach, setValuesTest_run_func, string_verify_func},
+    {"Config load",
+	CONFIG_LOAD_DATASET,
+	{0},
+	configLoadTest_foreach, configLoadTest_run_func, string_verify_func},
+    {"Save dirty",
+	SAVE_DIRTY_DATASET,
+	{0},
+	saveDirtyTest_foreach, saveDirtyTest_run_func, string_verify_func},
+    {NULL,NULL, {0}, NULL, NULL, NULL},
+};
+
+int main(int argc, char** argv){
+    int testId=get_testId(argc,argv,TEST_COLLECTION, "MKDG_VERBOSE");
+    if (testId<0){
+	return testId;
+    }
+    if (perform_test_by_id(testId,TEST_COLLECTION))
+	return 0;
+    return 1;
+}
@@ -22,14 +22,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include "MakerDialog.h"
 #include "check_functions.h"
 
 /*=== Start of comp test ===*/
 typedef struct {
-    MkdgType mType;
+    MkdgType mType1;
     const gchar *value1Str;
+    MkdgType mType2;
     const gchar *value2Str;
     const gchar *parseOpt;
     const gchar *cmpOpt;
@@ -41,40 +46,57 @@ typedef struct{
 } MkdgComp_TestRec;
 
 MkdgComp_TestRec COMPARISON_DATASET[]={
-    {{-1}, {MKDG_TYPE_STRING, "default", "hsu", NULL, NULL}},
-    {{0}, {MKDG_TYPE_STRING, "dvorak", "dvorak", NULL, NULL}},
-    {{-1}, {MKDG_TYPE_STRING, "dvorak", "dvorak_hsu", NULL, NULL}},
-    {{-1}, {MKDG_TYPE_INT, "32", "103", NULL, NULL}},
-    {{0}, {MKDG_TYPE_COLOR, "white", "#FFFFFF", NULL, NULL}},
-    {{0}, {MKDG_TYPE_COLOR, "red", "#FF0000", NULL, NULL}},
-    {{-1}, {MKDG_TYPE_COLOR, "blue", "red", NULL, NULL}},
-    {{0},  {MKDG_TYPE_STRING_LIST, "test1;test2","test1;test2", NULL, NULL}},
-    {{-1},  {MKDG_TYPE_STRING_LIST, "test1","test1;test2", NULL, NULL}},
-    {{1},  {MKDG_TYPE_STRING_LIST, "SADF;ASDF","TTT", NULL, NULL}},
-    {{-1}, {MKDG_TYPE_INVALID, NULL, NULL, NULL, NULL}},
+    {{-1}, {MKDG_TYPE_STRING, "default", MKDG_TYPE_STRING, "hsu", NULL, NULL}},
+    {{0}, {MKDG_TYPE_STRING, "dvorak", MKDG_TYPE_STRING, "dvorak", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_STRING, "dvorak", MKDG_TYPE_STRING, "dvorak_hsu", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_INT, "32", MKDG_TYPE_INT, "103", NULL, NULL}},
+    {{0}, {MKDG_TYPE_COLOR, "white", MKDG_TYPE_COLOR, "#FFFFFF", NULL, NULL}},
+    {{0}, {MKDG_TYPE_COLOR, "red", MKDG_TYPE_COLOR, "#FF0000", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_COLOR, "blue", MKDG_TYPE_COLOR, "red", NULL, NULL}},
+    {{-3}, {MKDG_TYPE_COLOR, "blue", MKDG_TYPE_STRING, "blue", NULL, NULL}},
+    {{0},  {MKDG_TYPE_STRING_LIST, "test1;test2", MKDG_TYPE_STRING_LIST, "test1;test2", NULL, NULL}},
+    {{-1},  {MKDG_TYPE_STRING_LIST, "test1", MKDG_TYPE_STRING_LIST, "test1;test2", NULL, NULL}},
+    {{1},  {MKDG_TYPE_STRING_LIST, "SADF;ASDF", MKDG_TYPE_STRING_LIST, "TTT", NULL, NULL}},
+    /* Differ only beyond the precision of double */
+    {{1}, {MKDG_TYPE_INT64, "9007199254740993", MKDG_TYPE_INT64, "9007199254740992", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_UINT64, "18446744073709551614", MKDG_TYPE_UINT64, "18446744073709551615", NULL, NULL}},
+    {{1}, {MKDG_TYPE_UINT64, "18446744073709551615", MKDG_TYPE_INT64, "9223372036854775807", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_INT, "-1", MKDG_TYPE_UINT64, "18446744073709551615", NULL, NULL}},
+    {{1}, {MKDG_TYPE_UINT, "0", MKDG_TYPE_LONG, "-1", NULL, NULL}},
+    {{0}, {MKDG_TYPE_INT, "3", MKDG_TYPE_DOUBLE, "3.0", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_INT, "3", MKDG_TYPE_DOUBLE, "3.5", NULL, NULL}},
+    {{1}, {MKDG_TYPE_DOUBLE, "-2.5", MKDG_TYPE_INT, "-3", NULL, NULL}},
+    {{1}, {MKDG_TYPE_INT64, "9007199254740993", MKDG_TYPE_DOUBLE, "9007199254740992", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_UINT64, "18446744073709551615", MKDG_TYPE_DOUBLE, "1e20", NULL, NULL}},
+    {{1}, {MKDG_TYPE_FLOAT, "0.5", MKDG_TYPE_UINT32, "0", NULL, NULL}},
+    {{0}, {MKDG_TYPE_COLOR, "#FF0000", MKDG_TYPE_UINT, "16711680", NULL, NULL}},
+    {{-1}, {MKDG_TYPE_INVALID, NULL, MKDG_TYPE_INVALID, NULL, NULL, NULL}},
 };
 
 OutputRec compTest_run_func(InputRec inputRec, Param param){
     MkdgComp_InputRec *inRec=(MkdgComp_InputRec *) inputRec;
-    MkdgValue *mValue1=mkdg_value_new(inRec->mType, NULL);
+    MkdgValue *mValue1=mkdg_value_new(inRec->mType1, NULL);
     mkdg_value_from_string(mValue1, inRec->value1Str, inRec->parseOpt);
-    MkdgValue *mValue2=mkdg_value_new(inRec->mType, NULL);
+    MkdgValue *mValue2=mkdg_value_new(inRec->mType2, NULL);
     mkdg_value_from_string(mValue2, inRec->value2Str, inRec->parseOpt);
     output_rec_set_int(result,mkdg_value_compare(mValue1, mValue2, inRec->cmpOpt));
+    mkdg_value_free(mValue1);
+    mkdg_value_free(mValue2);
     return result;
 }
 
 gchar *compTest_to_string(InputRec inputRec, Param param){
     MkdgComp_InputRec *inRec=(MkdgComp_InputRec *) inputRec;
     GString *strBuf=g_string_new(NULL);
-    g_string_printf(strBuf,"mType=%d,value1=%s\tvalue2=%s", inRec->mType, inRec->value1Str, inRec->value2Str);
+    g_string_printf(strBuf,"mType1=%d,value1=%s\tmType2=%d,value2=%s", inRec->mType1, inRec->value1Str,
+	    inRec->mType2, inRec->value2Str);
     return g_string_free(strBuf, FALSE);
 }
 
 gboolean compTest_foreach(TestSubject *testSubject){
     gboolean clean=TRUE;
     MkdgComp_TestRec *rec=(MkdgComp_TestRec *) testSubject->dataSet;
-    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+    for(;rec->in.mType1!=MKDG_TYPE_INVALID;rec++){
 	MkdgComp_InputRec *inRec=&(rec->in);
 	OutputRec expOutRec=rec->out;
 	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
@@ -134,6 +156,9 @@ OutputRec fromStrTest_run_func(InputRec inputRec, Param param){
     MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
     mkdg_value_from_string(mValue, inRec->valueStr, inRec->parseOpt);
     OutputRec result=mValue->data[0];
+    if (inRec->mType==MKDG_TYPE_STRING_LIST){
+	result.v_string_list=mkdg_value_get_string_list(mValue);
+    }
     return result;
 }
 
@@ -150,6 +175,9 @@ gchar *fromStrTest_to_string(InputRec inputRec, Param param){
 	case MKDG_TYPE_DOUBLE:
 	    g_string_printf(strBuf,"mType=DOUBLE, value=%s", inRec->valueStr);
 	    break;
+	case MKDG_TYPE_STRING_LIST:
+	    g_string_printf(strBuf,"mType=STRING_LIST, value=%s", inRec->valueStr);
+	    break;
 	default:
 	    break;
     }
@@ -174,6 +202,9 @@ gboolean fromStrTest_foreach(TestSubject *testSubject){
 	    case MKDG_TYPE_DOUBLE:
 		clean=double_verify_func(actOutRec, expOutRec, testSubject->prompt, inStr);
 		break;
+	    case MKDG_TYPE_STRING_LIST:
+		clean=string_list_verify_func(actOutRec, expOutRec, testSubject->prompt, inStr);
+		break;
 	    default:
 		break;
 	}
@@ -186,6 +217,949 @@ gboolean fromStrTest_foreach(TestSubject *testSubject){
 }
 /*=== End of from string test ===*/
 
+/*=== Start of format into test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *valueStr;
+    const gchar *toStringFormat;
+    gsize bufSize;
+} MkdgFormatInto_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgFormatInto_InputRec in;
+} MkdgFormatInto_TestRec;
+
+MkdgFormatInto_TestRec FORMAT_INTO_DATASET[]={
+    {{.v_string="TRUE"},	{MKDG_TYPE_BOOLEAN,	"1", NULL, 16}},
+    {{.v_string="-2147483648"},	{MKDG_TYPE_INT,		"-2147483648", NULL, 16}},
+    {{.v_string="4294967295"},	{MKDG_TYPE_UINT,	"4294967295", NULL, 16}},
+    {{.v_string="0"},		{MKDG_TYPE_INT32,	"0", NULL, 16}},
+    {{.v_string="-42"},		{MKDG_TYPE_LONG,	"-42", NULL, 16}},
+    {{.v_string="00042"},	{MKDG_TYPE_INT,		"42", "%05d", 16}},
+    {{.v_string="123"},		{MKDG_TYPE_INT,		"12345", NULL, 4}},
+    {{.v_string="42"},		{MKDG_TYPE_INT,		"42", "%s", 16}},
+    {{.v_string="-5"},		{MKDG_TYPE_INT64,	"-5", "%lld", 16}},
+    {{.v_string="ff"},		{MKDG_TYPE_UINT,	"255", "%x", 16}},
+    {{.v_string="3.14"},	{MKDG_TYPE_DOUBLE,	"3.14159", "%.2f", 16}},
+    {{.v_string="abc"},		{MKDG_TYPE_STRING,	"abc", "%d", 16}},
+    {{.v_string="1.5"},		{MKDG_TYPE_DOUBLE,	"1.5", NULL, 16}},
+    {{.v_string="0.1"},		{MKDG_TYPE_DOUBLE,	"0.1", NULL, 16}},
+    {{.v_string="0.30000000000000004"},	{MKDG_TYPE_DOUBLE,	"0.30000000000000004", NULL, 32}},
+    {{.v_string="1e+22"},	{MKDG_TYPE_DOUBLE,	"1e22", NULL, 16}},
+    {{.v_string="-1.25e-07"},	{MKDG_TYPE_DOUBLE,	"-0.000000125", NULL, 16}},
+    {{.v_string="0.1"},		{MKDG_TYPE_FLOAT,	"0.1", NULL, 16}},
+    {{.v_string="hsu"},		{MKDG_TYPE_STRING,	"hsu", NULL, 16}},
+    {{.v_string="[dvorak]"},	{MKDG_TYPE_STRING,	"dvorak", "[%s]", 16}},
+    {{.v_string="dvorak_h"},	{MKDG_TYPE_STRING,	"dvorak_hsu", NULL, 9}},
+    {{.v_string="ASDF;S\\;ADF"},	{MKDG_TYPE_STRING_LIST,	"ASDF;S\\;ADF", NULL, 16}},
+    {{.v_string="White"},	{MKDG_TYPE_COLOR,	"#FFFFFF", NULL, 16}},
+    {{.v_string="#123456"},	{MKDG_TYPE_COLOR,	"#123456", NULL, 16}},
+    {{.v_string="AliceBlue"},	{MKDG_TYPE_COLOR,	"aliceblue", NULL, 16}},
+    {{.v_string="Aqua"},	{MKDG_TYPE_COLOR,	"CYAN", NULL, 16}},
+    {{.v_string="Gray"},	{MKDG_TYPE_COLOR,	"grey", NULL, 16}},
+    {{.v_string="Silver"},	{MKDG_TYPE_COLOR,	"Sliver", NULL, 16}},
+    {{.v_string="RebeccaPurple"},	{MKDG_TYPE_COLOR,	"#663399", NULL, 16}},
+    {{.v_string="LightGoldenrodYellow"},	{MKDG_TYPE_COLOR,	"LightGoldenrodYellow", NULL, 32}},
+    {{.v_string="Black"},	{MKDG_TYPE_COLOR,	"NoSuchColor", NULL, 16}},
+    {{.v_string="3"},		{MKDG_TYPE_ENUM,	"3", NULL, 16}},
+    {{.v_string="base64:aHN1"},	{MKDG_TYPE_BLOB,	"base64:aHN1", NULL, 16}},
+    {{.v_string="base64:aG"},	{MKDG_TYPE_BLOB,	"base64:aGVsbG8gd29ybGQ=", NULL, 10}},
+    {{.v_string="base6"},	{MKDG_TYPE_BLOB,	"base64:aGVsbG8gd29ybGQ=", NULL, 6}},
+    {{0}, 	{MKDG_TYPE_INVALID, 	NULL, NULL, 0}},
+};
+
+OutputRec formatIntoTest_run_func(InputRec inputRec, Param param){
+    MkdgFormatInto_InputRec *inRec=(MkdgFormatInto_InputRec *) inputRec;
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_from_string(mValue, inRec->valueStr, NULL);
+    gchar *buf=g_new(gchar, inRec->bufSize);
+    gsize len=mkdg_value_format_into(mValue, inRec->toStringFormat, buf, inRec->bufSize);
+    gchar *str=mkdg_value_to_string(mValue, inRec->toStringFormat);
+    if (len!=strlen(str)){
+	/* Length should be the same as the untruncated output. */
+	g_free(buf);
+	buf=NULL;
+    }
+    g_free(str);
+    mkdg_value_free(mValue);
+    output_rec_set_string(result, buf);
+    return result;
+}
+
+gchar *formatIntoTest_to_string(InputRec inputRec, Param param){
+    MkdgFormatInto_InputRec *inRec=(MkdgFormatInto_InputRec *) inputRec;
+    GString *strBuf=g_string_new(NULL);
+    g_string_printf(strBuf,"mType=%s, value=%s, format=%s, bufSize=%u", mkdg_type_to_string(inRec->mType),
+	    inRec->valueStr, (inRec->toStringFormat) ? inRec->toStringFormat : "NULL", (guint) inRec->bufSize);
+    return g_string_free(strBuf, FALSE);
+}
+
+gboolean formatIntoTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgFormatInto_TestRec *rec=(MkdgFormatInto_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgFormatInto_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=formatIntoTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(actOutRec.v_string);
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of format into test ===*/
+
+/*=== Start of parse number test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *valueStr;
+    gint base;
+} MkdgParseNumber_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgParseNumber_InputRec in;
+} MkdgParseNumber_TestRec;
+
+/* Expected output is "status:value" */
+MkdgParseNumber_TestRec PARSE_NUMBER_DATASET[]={
+    {{.v_string="0:42"},	{MKDG_TYPE_INT64,	"42", 0}},
+    {{.v_string="0:-42"},	{MKDG_TYPE_INT64,	"  -42 ", 0}},
+    {{.v_string="0:1234567890123456789"},	{MKDG_TYPE_INT64,	"1234567890123456789", 10}},
+    {{.v_string="0:9223372036854775807"},	{MKDG_TYPE_INT64,	"9223372036854775807", 0}},
+    {{.v_string="0:-9223372036854775808"},	{MKDG_TYPE_INT64,	"-9223372036854775808", 0}},
+    {{.v_string="3:9223372036854775807"},	{MKDG_TYPE_INT64,	"9223372036854775808", 0}},
+    {{.v_string="3:-9223372036854775808"},	{MKDG_TYPE_INT64,	"-99999999999999999999", 0}},
+    {{.v_string="0:255"},	{MKDG_TYPE_INT64,	"0xff", 0}},
+    {{.v_string="0:255"},	{MKDG_TYPE_INT64,	"0XFF", 16}},
+    {{.v_string="0:255"},	{MKDG_TYPE_INT64,	"ff", 16}},
+    {{.v_string="0:8"},		{MKDG_TYPE_INT64,	"010", 0}},
+    {{.v_string="0:10"},	{MKDG_TYPE_INT64,	"010", 10}},
+    {{.v_string="0:0"},		{MKDG_TYPE_INT64,	"0", 0}},
+    {{.v_string="1:0"},		{MKDG_TYPE_INT64,	"  ", 0}},
+    {{.v_string="1:0"},		{MKDG_TYPE_INT64,	NULL, 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_INT64,	"12a", 10}},
+    {{.v_string="2:0"},		{MKDG_TYPE_INT64,	"1.0", 0}},
+    {{.v_string="0:9"},		{MKDG_TYPE_INT64,	"09", 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_INT64,	"019", 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_INT64,	"-", 0}},
+    {{.v_string="0:18446744073709551615"},	{MKDG_TYPE_UINT64,	"18446744073709551615", 0}},
+    {{.v_string="0:18446744073709551615"},	{MKDG_TYPE_UINT64,	"0xFFFFFFFFFFFFFFFF", 0}},
+    {{.v_string="0:18446744073709551615"},	{MKDG_TYPE_UINT64,	"01777777777777777777777", 0}},
+    {{.v_string="3:18446744073709551615"},	{MKDG_TYPE_UINT64,	"18446744073709551616", 0}},
+    {{.v_string="3:0"},		{MKDG_TYPE_UINT64,	"-1", 0}},
+    {{.v_string="0:0"},		{MKDG_TYPE_UINT64,	"-0", 0}},
+    {{.v_string="0:1.5"},	{MKDG_TYPE_DOUBLE,	"1.5", 0}},
+    {{.v_string="0:-0.125"},	{MKDG_TYPE_DOUBLE,	"-.125", 0}},
+    {{.v_string="0:1e+22"},	{MKDG_TYPE_DOUBLE,	"1e22", 0}},
+    {{.v_string="0:0.10000000000000001"},	{MKDG_TYPE_DOUBLE,	"0.1", 0}},
+    {{.v_string="0:3.1415926535897931"},	{MKDG_TYPE_DOUBLE,	"3.14159265358979323846", 0}},
+    {{.v_string="0:1e-300"},	{MKDG_TYPE_DOUBLE,	"1e-300", 0}},
+    {{.v_string="3:inf"},	{MKDG_TYPE_DOUBLE,	"1e999", 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_DOUBLE,	"1,5", 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_DOUBLE,	"1.5x", 0}},
+    {{.v_string="2:0"},		{MKDG_TYPE_DOUBLE,	"e5", 0}},
+    {{0}, 	{MKDG_TYPE_INVALID, 	NULL, 0}},
+};
+
+OutputRec parseNumberTest_run_func(InputRec inputRec, Param param){
+    MkdgParseNumber_InputRec *inRec=(MkdgParseNumber_InputRec *) inputRec;
+    MkdgNumberStatus status;
+    gchar *str=NULL;
+    gint64 i64;
+    guint64 u64;
+    gdouble dbl;
+    gchar dblBuf[G_ASCII_DTOSTR_BUF_SIZE];
+    switch(inRec->mType){
+	case MKDG_TYPE_INT64:
+	    status=mkdg_number_parse_int64(inRec->valueStr, inRec->base, &i64);
+	    str=g_strdup_printf("%d:%" G_GINT64_FORMAT, status, i64);
+	    break;
+	case MKDG_TYPE_UINT64:
+	    status=mkdg_number_parse_uint64(inRec->valueStr, inRec->base, &u64);
+	    str=g_strdup_printf("%d:%" G_GUINT64_FORMAT, status, u64);
+	    break;
+	case MKDG_TYPE_DOUBLE:
+	    status=mkdg_number_parse_double(inRec->valueStr, &dbl);
+	    str=g_strdup_printf("%d:%s", status, g_ascii_formatd(dblBuf, G_ASCII_DTOSTR_BUF_SIZE, "%.17g", dbl));
+	    break;
+	default:
+	    break;
+    }
+    output_rec_set_string(result, str);
+    return result;
+}
+
+gchar *parseNumberTest_to_string(InputRec inputRec, Param param){
+    MkdgParseNumber_InputRec *inRec=(MkdgParseNumber_InputRec *) inputRec;
+    GString *strBuf=g_string_new(NULL);
+    g_string_printf(strBuf,"mType=%s, value=%s, base=%d", mkdg_type_to_string(inRec->mType),
+	    (inRec->valueStr) ? inRec->valueStr : "NULL", inRec->base);
+    return g_string_free(strBuf, FALSE);
+}
+
+gboolean parseNumberTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgParseNumber_TestRec *rec=(MkdgParseNumber_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgParseNumber_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=parseNumberTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(actOutRec.v_string);
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of parse number test ===*/
+
+/*=== Start of round trip test ===*/
+typedef enum{
+    ROUND_TRIP_RANDOM_BITS,	//!< Any finite value.
+    ROUND_TRIP_RANDOM_UNIT,	//!< Value in [0,1).
+    ROUND_TRIP_RANDOM_DECIMAL,	//!< Value with few decimal digits, as in config files.
+    ROUND_TRIP_LIMITS,		//!< Largest, smallest normal and smallest subnormal values of both signs.
+} ROUND_TRIP_KIND;
+
+typedef struct {
+    MkdgType mType;
+    ROUND_TRIP_KIND kind;
+    gint count;
+} MkdgRoundTrip_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgRoundTrip_InputRec in;
+} MkdgRoundTrip_TestRec;
+
+/* Expected output is number of values that failed to round trip. */
+MkdgRoundTrip_TestRec ROUND_TRIP_DATASET[]={
+    {{0},	{MKDG_TYPE_DOUBLE,	ROUND_TRIP_RANDOM_BITS,		200000}},
+    {{0},	{MKDG_TYPE_DOUBLE,	ROUND_TRIP_RANDOM_UNIT,		200000}},
+    {{0},	{MKDG_TYPE_DOUBLE,	ROUND_TRIP_RANDOM_DECIMAL,	200000}},
+    {{0},	{MKDG_TYPE_FLOAT,	ROUND_TRIP_RANDOM_BITS,		200000}},
+    {{0},	{MKDG_TYPE_FLOAT,	ROUND_TRIP_RANDOM_UNIT,		200000}},
+    {{0},	{MKDG_TYPE_FLOAT,	ROUND_TRIP_RANDOM_DECIMAL,	200000}},
+    {{0},	{MKDG_TYPE_DOUBLE,	ROUND_TRIP_LIMITS,		6}},
+    {{0},	{MKDG_TYPE_FLOAT,	ROUND_TRIP_LIMITS,		6}},
+    {{0}, 	{MKDG_TYPE_INVALID, 	0, 0}},
+};
+
+static gdouble ROUND_TRIP_DOUBLE_LIMITS[]={
+    DBL_MAX, -DBL_MAX, DBL_MIN, -DBL_MIN, 4.9406564584124654e-324, -4.9406564584124654e-324
+};
+
+static gfloat ROUND_TRIP_FLOAT_LIMITS[]={
+    FLT_MAX, -FLT_MAX, FLT_MIN, -FLT_MIN, 1.40129846e-45f, -1.40129846e-45f
+};
+
+static gdouble roundTripTest_random_double(GRand *rand, ROUND_TRIP_KIND kind, gint i){
+    guint64 bits;
+    gdouble dbl;
+    switch(kind){
+	case ROUND_TRIP_RANDOM_BITS:
+	    do{
+		bits=(((guint64) g_rand_int(rand)) << 32) | g_rand_int(rand);
+		memcpy(&dbl, &bits, sizeof(dbl));
+	    }while(isnan(dbl) || isinf(dbl));
+	    return dbl;
+	case ROUND_TRIP_RANDOM_UNIT:
+	    return g_rand_double(rand);
+	case ROUND_TRIP_LIMITS:
+	    return ROUND_TRIP_DOUBLE_LIMITS[i % G_N_ELEMENTS(ROUND_TRIP_DOUBLE_LIMITS)];
+	default:
+	    break;
+    }
+    return g_rand_int_range(rand, -1000000, 1000000) / 1000.0;
+}
+
+static gfloat roundTripTest_random_float(GRand *rand, ROUND_TRIP_KIND kind, gint i){
+    guint32 bits;
+    gfloat flt;
+    switch(kind){
+	case ROUND_TRIP_RANDOM_BITS:
+	    do{
+		bits=g_rand_int(rand);
+		memcpy(&flt, &bits, sizeof(flt));
+	    }while(isnan(flt) || isinf(flt));
+	    return flt;
+	case ROUND_TRIP_RANDOM_UNIT:
+	    return (gfloat) g_rand_double(rand);
+	case ROUND_TRIP_LIMITS:
+	    return ROUND_TRIP_FLOAT_LIMITS[i % G_N_ELEMENTS(ROUND_TRIP_FLOAT_LIMITS)];
+	default:
+	    break;
+    }
+    return (gfloat) (g_rand_int_range(rand, -1000000, 1000000) / 1000.0);
+}
+
+OutputRec roundTripTest_run_func(InputRec inputRec, Param param){
+    MkdgRoundTrip_InputRec *inRec=(MkdgRoundTrip_InputRec *) inputRec;
+    GRand *rand=g_rand_new_with_seed(20100101);
+    MkdgValue valueHolder, parsedHolder;
+    MkdgValue *mValue=mkdg_value_init_static(&valueHolder, inRec->mType);
+    MkdgValue *mValueParsed=mkdg_value_init_static(&parsedHolder, inRec->mType);
+    gchar buf[MKDG_VALUE_FORMAT_BUFFER_SIZE];
+    gint i, failed=0;
+    for(i=0;i<inRec->count;i++){
+	gboolean same;
+	if (inRec->mType==MKDG_TYPE_FLOAT){
+	    gfloat flt=roundTripTest_random_float(rand, inRec->kind, i);
+	    mkdg_value_set_float(mValue, flt);
+	    mkdg_value_format_into(mValue, NULL, buf, MKDG_VALUE_FORMAT_BUFFER_SIZE);
+	    same=(mkdg_value_from_string(mValueParsed, buf, NULL)!=NULL);
+	    gfloat fltParsed=mkdg_value_get_float(mValueParsed);
+	    same=same && (memcmp(&flt, &fltParsed, sizeof(gfloat))==0);
+	}else{
+	    gdouble dbl=roundTripTest_random_double(rand, inRec->kind, i);
+	    mkdg_value_set_double(mValue, dbl);
+	    mkdg_value_format_into(mValue, NULL, buf, MKDG_VALUE_FORMAT_BUFFER_SIZE);
+	    same=(mkdg_value_from_string(mValueParsed, buf, NULL)!=NULL);
+	    gdouble dblParsed=mkdg_value_get_double(mValueParsed);
+	    same=same && (memcmp(&dbl, &dblParsed, sizeof(gdouble))==0);
+	}
+	if (!same){
+	    if (failed==0)
+		printf("First failed value: %s\n", buf);
+	    failed++;
+	}
+    }
+    g_rand_free(rand);
+    output_rec_set_int(result, failed);
+    return result;
+}
+
+gchar *roundTripTest_to_string(InputRec inputRec, Param param){
+    MkdgRoundTrip_InputRec *inRec=(MkdgRoundTrip_InputRec *) inputRec;
+    GString *strBuf=g_string_new(NULL);
+    g_string_printf(strBuf,"mType=%s, kind=%d, count=%d", mkdg_type_to_string(inRec->mType),
+	    inRec->kind, inRec->count);
+    return g_string_free(strBuf, FALSE);
+}
+
+gboolean roundTripTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgRoundTrip_TestRec *rec=(MkdgRoundTrip_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_INVALID;rec++){
+	MkdgRoundTrip_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=roundTripTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of round trip test ===*/
+
+/*=== Start of string list test ===*/
+typedef struct {
+    const gchar *valueStr;
+    const gchar *findStr;
+    guint count;
+} MkdgStringList_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgStringList_InputRec in;
+} MkdgStringList_TestRec;
+
+/* Output is index of findStr, or -2 if copy or count is wrong */
+MkdgStringList_TestRec STRING_LIST_DATASET[]={
+    {{0},	{"ASDF;SADF", "ASDF", 2}},
+    {{1},	{"ASDF;SADF", "SADF", 2}},
+    {{-1},	{"ASDF;SADF", "asdf", 2}},
+    {{1},	{"ASDF;", "", 2}},
+    {{0},	{"ASDF\\;;SADF", "ASDF;", 2}},
+    {{2},	{"新酷音;輸入法;測試", "測試", 3}},
+    {{-1},	{"", "ASDF", 1}},
+    {{0},	{NULL, NULL, 0}},
+};
+
+OutputRec stringListTest_run_func(InputRec inputRec, Param param){
+    MkdgStringList_InputRec *inRec=(MkdgStringList_InputRec *) inputRec;
+    MkdgValue *mValue=mkdg_value_new(MKDG_TYPE_STRING_LIST, NULL);
+    mkdg_value_from_string(mValue, inRec->valueStr, NULL);
+    MkdgValue *copyValue=mkdg_value_new(MKDG_TYPE_STRING_LIST, NULL);
+    mkdg_value_copy(mValue, copyValue);
+    /* Free the source, so the copy must not refer to it */
+    mkdg_value_free(mValue);
+    gint index=-2;
+    if (mkdg_value_get_string_list_length(copyValue)==inRec->count
+	    && g_strv_length(mkdg_value_get_string_list(copyValue))==inRec->count){
+	index=mkdg_string_list_find(mkdg_value_get_packed_string_list(copyValue), inRec->findStr);
+    }
+    mkdg_value_free(copyValue);
+    output_rec_set_int(result, index);
+    return result;
+}
+
+gchar *stringListTest_to_string(InputRec inputRec, Param param){
+    MkdgStringList_InputRec *inRec=(MkdgStringList_InputRec *) inputRec;
+    return g_strdup_printf("value=%s\tfind=%s", inRec->valueStr, inRec->findStr);
+}
+
+gboolean stringListTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgStringList_TestRec *rec=(MkdgStringList_TestRec *) testSubject->dataSet;
+    for(;rec->in.valueStr!=NULL;rec++){
+	MkdgStringList_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=stringListTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of string list test ===*/
+
+/*=== Start of intern test ===*/
+typedef struct {
+    const gchar *str1;
+    const gchar *str2;
+} MkdgIntern_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgIntern_InputRec in;
+} MkdgIntern_TestRec;
+
+/* Output is comparison of interned values, or -2 if pointers are not shared as expected */
+MkdgIntern_TestRec INTERN_DATASET[]={
+    {{0},	{"dvorak_hsu_layout_for_chewing", "dvorak_hsu_layout_for_chewing"}},
+    {{-1},	{"dvorak_hsu_layout_for_chewing", "dvorak_hsu_layout_for_chewinh"}},
+    {{1},	{"新酷音輸入法測試成功新酷音輸入法", "新酷音輸入法測試"}},
+    {{0},	{"hsu", "hsu"}},
+    {{-1},	{"", "hsu"}},
+    {{0},	{NULL, NULL}},
+};
+
+OutputRec internTest_run_func(InputRec inputRec, Param param){
+    MkdgIntern_InputRec *inRec=(MkdgIntern_InputRec *) inputRec;
+    MkdgValue *mValue1=mkdg_value_intern(mkdg_value_new(MKDG_TYPE_STRING, (gpointer) inRec->str1));
+    MkdgValue *mValue2=mkdg_value_intern(mkdg_value_new(MKDG_TYPE_STRING, (gpointer) inRec->str2));
+    MkdgValue *copyValue=mkdg_value_new(MKDG_TYPE_STRING, NULL);
+    mkdg_value_copy(mValue1, copyValue);
+    gint ret=mkdg_value_compare(mValue1, mValue2, NULL);
+    if (strlen(inRec->str1)>MKDG_VALUE_INLINE_STRING_MAX){
+	/* Long strings are interned and shared by copy */
+	if (mkdg_value_get_string(mValue1)!=g_intern_string(inRec->str1)
+		|| mkdg_value_get_string(copyValue)!=mkdg_value_get_string(mValue1)){
+	    ret=-2;
+	}
+    }
+    if (strcmp(mkdg_value_get_string(copyValue), inRec->str1)!=0){
+	ret=-2;
+    }
+    /* Interned strings must survive the free of values that share them */
+    mkdg_value_free(mValue1);
+    mkdg_value_free(copyValue);
+    mkdg_value_free(mValue2);
+    output_rec_set_int(result, ret);
+    return result;
+}
+
+gchar *internTest_to_string(InputRec inputRec, Param param){
+    MkdgIntern_InputRec *inRec=(MkdgIntern_InputRec *) inputRec;
+    return g_strdup_printf("str1=%s\tstr2=%s", inRec->str1, inRec->str2);
+}
+
+gboolean internTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgIntern_TestRec *rec=(MkdgIntern_TestRec *) testSubject->dataSet;
+    for(;rec->in.str1!=NULL;rec++){
+	MkdgIntern_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=internTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of intern test ===*/
+
+/*=== Start of copy on write test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *valueStr;
+} MkdgCopyOnWrite_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgCopyOnWrite_InputRec in;
+} MkdgCopyOnWrite_TestRec;
+
+/*
+ * Output is 1 if the copy shares the payload, 0 if it does not;
+ * or -2 if the copy is not equal after writable or free of source.
+ */
+MkdgCopyOnWrite_TestRec COPY_ON_WRITE_DATASET[]={
+    {{1},	{MKDG_TYPE_STRING, "dvorak_hsu_layout_for_chewing"}},
+    {{0},	{MKDG_TYPE_STRING, "hsu"}},
+    {{1},	{MKDG_TYPE_STRING_LIST, "新酷音;輸入法;測試"}},
+    {{1},	{MKDG_TYPE_STRING_LIST, ""}},
+    {{0},	{MKDG_TYPE_INT, "-1"}},
+    {{0},	{MKDG_TYPE_NONE, NULL}},
+};
+
+static gconstpointer copyOnWriteTest_payload(MkdgValue *mValue){
+    if (mValue->mType==MKDG_TYPE_STRING)
+	return mkdg_value_get_string(mValue);
+    if (mValue->mType==MKDG_TYPE_STRING_LIST)
+	return mkdg_value_get_packed_string_list(mValue);
+    return NULL;
+}
+
+OutputRec copyOnWriteTest_run_func(InputRec inputRec, Param param){
+    MkdgCopyOnWrite_InputRec *inRec=(MkdgCopyOnWrite_InputRec *) inputRec;
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_from_string(mValue, inRec->valueStr, NULL);
+    MkdgValue *copyValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_copy(mValue, copyValue);
+    gconstpointer payload=copyOnWriteTest_payload(mValue);
+    gint ret=(payload!=NULL && payload==copyOnWriteTest_payload(copyValue)) ? 1 : 0;
+
+    MkdgValue *writableValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_copy(mValue, writableValue);
+    mkdg_value_make_writable(writableValue);
+    if (payload!=NULL && payload==copyOnWriteTest_payload(writableValue)){
+	ret=-2;
+    }
+    if (mkdg_value_compare(writableValue, mValue, NULL)!=0){
+	ret=-2;
+    }
+    /* Static values must not borrow the source's storage */
+    MkdgValue *staticValue=mkdg_value_new_static(inRec->mType, NULL);
+    mkdg_value_copy(mValue, staticValue);
+
+    /* Free the source, so the copy holds the last reference */
+    mkdg_value_free(mValue);
+    gchar *str=mkdg_value_to_string(copyValue, NULL);
+    if (strcmp(str, inRec->valueStr)!=0){
+	ret=-2;
+    }
+    g_free(str);
+    str=mkdg_value_to_string(staticValue, NULL);
+    if (strcmp(str, inRec->valueStr)!=0){
+	ret=-2;
+    }
+    g_free(str);
+    mkdg_value_free(staticValue);
+    mkdg_value_free(writableValue);
+    mkdg_value_free(copyValue);
+    output_rec_set_int(result, ret);
+    return result;
+}
+
+gchar *copyOnWriteTest_to_string(InputRec inputRec, Param param){
+    MkdgCopyOnWrite_InputRec *inRec=(MkdgCopyOnWrite_InputRec *) inputRec;
+    return g_strdup_printf("mType=%s\tvalue=%s", mkdg_type_to_string(inRec->mType), inRec->valueStr);
+}
+
+gboolean copyOnWriteTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgCopyOnWrite_TestRec *rec=(MkdgCopyOnWrite_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_NONE;rec++){
+	MkdgCopyOnWrite_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=copyOnWriteTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of copy on write test ===*/
+
+/*=== Start of hash test ===*/
+typedef struct {
+    MkdgType mType1;
+    const gchar *value1Str;
+    MkdgType mType2;
+    const gchar *value2Str;
+} MkdgHash_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgHash_InputRec in;
+} MkdgHash_TestRec;
+
+/* Output is 1 if equal, 0 if not equal; or -2 if equal values have different hashes */
+MkdgHash_TestRec HASH_DATASET[]={
+    {{1},	{MKDG_TYPE_INT, "5", MKDG_TYPE_INT, "5"}},
+    {{0},	{MKDG_TYPE_INT, "5", MKDG_TYPE_INT, "-5"}},
+    {{1},	{MKDG_TYPE_INT, "5", MKDG_TYPE_UINT64, "5"}},
+    {{1},	{MKDG_TYPE_INT, "-5", MKDG_TYPE_DOUBLE, "-5.0"}},
+    {{0},	{MKDG_TYPE_INT, "5", MKDG_TYPE_DOUBLE, "5.5"}},
+    {{1},	{MKDG_TYPE_DOUBLE, "-0.0", MKDG_TYPE_DOUBLE, "0"}},
+    {{1},	{MKDG_TYPE_UINT64, "18446744073709551615", MKDG_TYPE_UINT64, "18446744073709551615"}},
+    {{1},	{MKDG_TYPE_COLOR, "red", MKDG_TYPE_COLOR, "#FF0000"}},
+    {{1},	{MKDG_TYPE_BOOLEAN, "true", MKDG_TYPE_BOOLEAN, "1"}},
+    {{0},	{MKDG_TYPE_BOOLEAN, "true", MKDG_TYPE_BOOLEAN, "false"}},
+    {{1},	{MKDG_TYPE_STRING, "hsu", MKDG_TYPE_STRING, "hsu"}},
+    {{1},	{MKDG_TYPE_STRING, "dvorak_hsu_layout_for_chewing", MKDG_TYPE_STRING, "dvorak_hsu_layout_for_chewing"}},
+    {{0},	{MKDG_TYPE_STRING, "dvorak_hsu_layout_for_chewing", MKDG_TYPE_STRING, "dvorak_hsu_layout_for_chewinh"}},
+    {{1},	{MKDG_TYPE_STRING_LIST, "新酷音;輸入法", MKDG_TYPE_STRING_LIST, "新酷音;輸入法"}},
+    {{0},	{MKDG_TYPE_STRING_LIST, "新酷音;輸入法", MKDG_TYPE_STRING_LIST, "輸入法;新酷音"}},
+    {{0},	{MKDG_TYPE_STRING, "5", MKDG_TYPE_INT, "5"}},
+    {{1},	{MKDG_TYPE_INT_ARRAY, "1;2;3", MKDG_TYPE_INT_ARRAY, "1, 2, 3"}},
+    {{0},	{MKDG_TYPE_INT_ARRAY, "1;2;3", MKDG_TYPE_INT_ARRAY, "1;2;4"}},
+    {{1},	{MKDG_TYPE_DOUBLE_ARRAY, "-0.0;nan", MKDG_TYPE_DOUBLE_ARRAY, "0;-nan"}},
+    {{0},	{MKDG_TYPE_INT_ARRAY, "1;2", MKDG_TYPE_DOUBLE_ARRAY, "1;2"}},
+    {{0},	{MKDG_TYPE_NONE, NULL, MKDG_TYPE_NONE, NULL}},
+};
+
+OutputRec hashTest_run_func(InputRec inputRec, Param param){
+    MkdgHash_InputRec *inRec=(MkdgHash_InputRec *) inputRec;
+    MkdgValue *mValue1=mkdg_value_new(inRec->mType1, NULL);
+    mkdg_value_from_string(mValue1, inRec->value1Str, NULL);
+    MkdgValue *mValue2=mkdg_value_new(inRec->mType2, NULL);
+    mkdg_value_from_string(mValue2, inRec->value2Str, NULL);
+    gint ret=(mkdg_value_equal(mValue1, mValue2)) ? 1 : 0;
+    if (ret==1 && mkdg_value_hash(mValue1)!=mkdg_value_hash(mValue2)){
+	ret=-2;
+    }
+    /* Hash set finds the equal value */
+    GHashTable *valueSet=g_hash_table_new(mkdg_value_hash, mkdg_value_equal);
+    g_hash_table_insert(valueSet, mValue1, mValue1);
+    if (ret==1 && g_hash_table_lookup(valueSet, mValue2)!=mValue1){
+	ret=-2;
+    }
+    g_hash_table_destroy(valueSet);
+    mkdg_value_free(mValue1);
+    mkdg_value_free(mValue2);
+    output_rec_set_int(result, ret);
+    return result;
+}
+
+gchar *hashTest_to_string(InputRec inputRec, Param param){
+    MkdgHash_InputRec *inRec=(MkdgHash_InputRec *) inputRec;
+    return g_strdup_printf("%s:%s\t%s:%s",
+	    mkdg_type_to_string(inRec->mType1), inRec->value1Str,
+	    mkdg_type_to_string(inRec->mType2), inRec->value2Str);
+}
+
+gboolean hashTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgHash_TestRec *rec=(MkdgHash_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType1!=MKDG_TYPE_NONE;rec++){
+	MkdgHash_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=hashTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of hash test ===*/
+
+/*=== Start of number array test ===*/
+typedef struct {
+    MkdgType mType;
+    const gchar *valueStr;
+    const gchar *testValue;
+    gdouble min;
+    gdouble max;
+} MkdgNumberArray_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgNumberArray_InputRec in;
+} MkdgNumberArray_TestRec;
+
+/*
+ * Output is "string,length,compare,inRange", where string is formatted from a copy,
+ * compare is the result of comparing the value with testValue,
+ * and inRange is whether all elements are between min and max.
+ * Invalid elements are stored as 0, and string is prefixed with '!'.
+ */
+MkdgNumberArray_TestRec NUMBER_ARRAY_DATASET[]={
+    {{.v_string="1;-2;3,3,0,1"},	{MKDG_TYPE_INT_ARRAY, "1;-2;3", "1 -2 3", -5.0, 5.0}},
+    {{.v_string="16;255,2,1,0"},	{MKDG_TYPE_INT_ARRAY, " 0x10, 0xff ", "16;254", 0.0, 100.0}},
+    {{.v_string="9223372036854775807,1,-1,1"},	{MKDG_TYPE_INT_ARRAY, "9223372036854775807", "1;2", -1e19, 1e19}},
+    {{.v_string="1;2,2,1,1"},	{MKDG_TYPE_INT_ARRAY, "1;;2;", "1", 1.0, 2.0}},
+    {{.v_string=",0,0,1"},	{MKDG_TYPE_INT_ARRAY, "", NULL, 1.0, 2.0}},
+    {{.v_string="!1;0;3,3,-1,1"},	{MKDG_TYPE_INT_ARRAY, "1;x;3", "1;1;3", 0.0, 3.0}},
+    {{.v_string="0.1;2.5;-1e+300,3,0,0"},	{MKDG_TYPE_DOUBLE_ARRAY, "0.1;2.5;-1e300", "0.1;2.5;-1e300", -1.0, 3.0}},
+    {{.v_string="0;1.5,2,-1,1"},	{MKDG_TYPE_DOUBLE_ARRAY, "-0.0, 1.5", "0;1.75", 0.0, 2.0}},
+    {{.v_string="1;nan,2,1,0"},	{MKDG_TYPE_DOUBLE_ARRAY, "1;nan", "1;1e308", -1e308, 1e308}},
+    {{.v_string=NULL},	{MKDG_TYPE_NONE, NULL, NULL, 0.0, 0.0}},
+};
+
+OutputRec numberArrayTest_run_func(InputRec inputRec, Param param){
+    MkdgNumberArray_InputRec *inRec=(MkdgNumberArray_InputRec *) inputRec;
+    MkdgValue *mValue=mkdg_value_new(inRec->mType, NULL);
+    gboolean valid=(mkdg_value_from_string(mValue, inRec->valueStr, NULL)) ? TRUE : FALSE;
+    MkdgValue *copyValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_copy(mValue, copyValue);
+    /* Free the source, so the copy must hold its own reference */
+    mkdg_value_free(mValue);
+
+    MkdgValue *testValue=mkdg_value_new(inRec->mType, NULL);
+    mkdg_value_from_string(testValue, inRec->testValue, NULL);
+    gchar *str=mkdg_value_to_string(copyValue, NULL);
+    gchar *resultStr=g_strdup_printf("%s%s,%u,%d,%d", (valid) ? "" : "!", str,
+	    mkdg_value_get_array_length(copyValue), mkdg_value_compare(copyValue, testValue, NULL),
+	    mkdg_number_array_in_range(mkdg_value_get_number_array(copyValue), inRec->min, inRec->max));
+    g_free(str);
+    mkdg_value_free(testValue);
+    mkdg_value_free(copyValue);
+    output_rec_set_string(result, resultStr);
+    return result;
+}
+
+gchar *numberArrayTest_to_string(InputRec inputRec, Param param){
+    MkdgNumberArray_InputRec *inRec=(MkdgNumberArray_InputRec *) inputRec;
+    return g_strdup_printf("%s:%s\ttestValue=%s\trange=[%g, %g]",
+	    mkdg_type_to_string(inRec->mType), inRec->valueStr, inRec->testValue, inRec->min, inRec->max);
+}
+
+gboolean numberArrayTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgNumberArray_TestRec *rec=(MkdgNumberArray_TestRec *) testSubject->dataSet;
+    for(;rec->in.mType!=MKDG_TYPE_NONE;rec++){
+	MkdgNumberArray_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=numberArrayTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(inStr);
+	g_free(actOutRec.v_string);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of number array test ===*/
+
+/*=== Start of blob test ===*/
+typedef enum{
+    BLOB_TEST_FORMAT,
+    BLOB_TEST_COMPARE,
+    BLOB_TEST_REWRITE,
+    BLOB_TEST_SAVE,
+    BLOB_TEST_RELEASE,
+} BlobTestAction;
+
+typedef struct {
+    BlobTestAction action;
+    const gchar *fileContent;
+    const gchar *valueStr;
+} MkdgBlob_InputRec;
+
+typedef struct{
+    OutputRec out;
+    MkdgBlob_InputRec in;
+} MkdgBlob_TestRec;
+
+/*
+ * "@" in valueStr and output stands for a file that holds fileContent.
+ * Output of each action:
+ *  - FORMAT: value as string, with " (loaded)" if its file is mapped;
+ *    NULL if the value is not equal to its copy or to the value parsed back.
+ *  - COMPARE: "equal=E loaded=L" of the value and a blob of the file;
+ *    NULL if equal values have different hashes.
+ *  - REWRITE: "equal=E" of a mapped blob of the file and a new one,
+ *    after the file is rewritten with valueStr.
+ *  - SAVE: "saved:file content:value" after the file is removed and
+ *    the value is saved to it.
+ *  - RELEASE: "destroy count after the blob is freed:after the value is freed"
+ *    of static data valueStr.
+ */
+MkdgBlob_TestRec BLOB_DATASET[]={
+    {{.v_string=""},	{BLOB_TEST_FORMAT, NULL, ""}},
+    {{.v_string="base64:aHN1"},	{BLOB_TEST_FORMAT, NULL, "base64:aHN1"}},
+    {{.v_string="base64:YQBiAGM="},	{BLOB_TEST_FORMAT, NULL, "base64:YQBiAGM="}},
+    {{.v_string="base64:5paw6YW36Z+z6Kme5bqr"},	{BLOB_TEST_FORMAT, NULL, "base64:5paw6YW36Z+z6Kme5bqr"}},
+    {{.v_string="@"},	{BLOB_TEST_FORMAT, "新酷音詞庫", "@"}},
+    {{.v_string="equal=1 loaded=0"},	{BLOB_TEST_COMPARE, "hsu", "@"}},
+    {{.v_string="equal=1 loaded=1"},	{BLOB_TEST_COMPARE, "hsu", "base64:aHN1"}},
+    {{.v_string="equal=0 loaded=1"},	{BLOB_TEST_COMPARE, "hsu", "base64:aHN2"}},
+    {{.v_string="equal=1 loaded=1"},	{BLOB_TEST_COMPARE, "新酷音詞庫", "base64:5paw6YW36Z+z6Kme5bqr"}},
+    {{.v_string="equal=1 loaded=1"},	{BLOB_TEST_COMPARE, "", "base64:"}},
+    {{.v_string="equal=1"},	{BLOB_TEST_REWRITE, "hsu", "hsu"}},
+    {{.v_string="equal=0"},	{BLOB_TEST_REWRITE, "hsu", "hsv"}},
+    {{.v_string="equal=0"},	{BLOB_TEST_REWRITE, "hsu", "hsu_dvorak"}},
+    {{.v_string="1:(none):@"},	{BLOB_TEST_SAVE, "hsu", "@"}},
+    {{.v_string="1:hsv:base64:aHN2"},	{BLOB_TEST_SAVE, "hsu", "base64:aHN2"}},
+    {{.v_string="0:1"},	{BLOB_TEST_RELEASE, NULL, "hsu"}},
+    {{.v_string="0:1"},	{BLOB_TEST_RELEASE, NULL, ""}},
+    {{NULL},	{BLOB_TEST_FORMAT, NULL, NULL}},
+};
+
+static gint blobTest_destroyCount=0;
+
+static void blobTest_destroy(gpointer data){
+    blobTest_destroyCount++;
+}
+
+static MkdgValue *blobTest_value_new(const gchar *valueStr, const gchar *path){
+    MkdgValue *mValue=mkdg_value_new(MKDG_TYPE_BLOB, NULL);
+    mkdg_value_from_string(mValue, (strcmp(valueStr, "@")==0) ? path : valueStr, NULL);
+    return mValue;
+}
+
+static gchar *blobTest_value_to_string(MkdgValue *mValue, const gchar *path){
+    gchar *str=mkdg_value_to_string(mValue, NULL);
+    if (strcmp(str, path)==0){
+	g_free(str);
+	str=g_strdup("@");
+    }
+    return str;
+}
+
+static gchar *blobTest_run_action(MkdgBlob_InputRec *inRec, const gchar *path){
+    MkdgValue *mValue=NULL;
+    MkdgValue *mValue2=NULL;
+    gchar *str=NULL;
+    gchar *ret=NULL;
+    gchar *content=NULL;
+    switch(inRec->action){
+	case BLOB_TEST_FORMAT:
+	    mValue=blobTest_value_new(inRec->valueStr, path);
+	    mValue2=mkdg_value_new(MKDG_TYPE_BLOB, NULL);
+	    mkdg_value_copy(mValue, mValue2);
+	    str=blobTest_value_to_string(mValue, path);
+	    if (mkdg_value_get_blob(mValue2)==mkdg_value_get_blob(mValue)){
+		mkdg_value_free(mValue2);
+		mValue2=blobTest_value_new(str, path);
+		MkdgBlob *blob=mkdg_value_get_blob(mValue);
+		if (mkdg_value_equal(mValue, mValue2)){
+		    ret=g_strconcat(str,
+			    (blob && mkdg_blob_get_path(blob) && mkdg_blob_is_loaded(blob)) ? " (loaded)" : "", NULL);
+		}
+	    }
+	    break;
+	case BLOB_TEST_COMPARE:
+	    mValue=blobTest_value_new(inRec->valueStr, path);
+	    mValue2=blobTest_value_new("@", path);
+	    gboolean equal=mkdg_value_equal(mValue, mValue2);
+	    gboolean loaded=mkdg_blob_is_loaded(mkdg_value_get_blob(mValue2));
+	    /* Hash maps the file, so check it after loaded */
+	    if (!equal || mkdg_value_hash(mValue)==mkdg_value_hash(mValue2)){
+		ret=g_strdup_printf("equal=%d loaded=%d", equal, loaded);
+	    }
+	    break;
+	case BLOB_TEST_REWRITE:
+	    mValue=blobTest_value_new("@", path);
+	    mkdg_blob_load(mkdg_value_get_blob(mValue), NULL);
+	    g_file_set_contents(path, inRec->valueStr, -1, NULL);
+	    mValue2=blobTest_value_new("@", path);
+	    ret=g_strdup_printf("equal=%d", mkdg_value_equal(mValue, mValue2));
+	    break;
+	case BLOB_TEST_SAVE:
+	    mValue=blobTest_value_new(inRec->valueStr, path);
+	    mkdg_blob_load(mkdg_value_get_blob(mValue), NULL);
+	    g_remove(path);
+	    gboolean saved=mkdg_blob_save(mkdg_value_get_blob(mValue), path, NULL);
+	    str=blobTest_value_to_string(mValue, path);
+	    g_file_get_contents(path, &content, NULL, NULL);
+	    ret=g_strdup_printf("%d:%s:%s", saved, (content) ? content : "(none)", str);
+	    break;
+	case BLOB_TEST_RELEASE:
+	    blobTest_destroyCount=0;
+	    MkdgBlob *blob=mkdg_blob_new_static(inRec->valueStr, strlen(inRec->valueStr), blobTest_destroy, NULL);
+	    mValue=mkdg_value_new(MKDG_TYPE_BLOB, blob);
+	    mkdg_blob_free(blob);
+	    gint count=blobTest_destroyCount;
+	    mkdg_value_free(mValue);
+	    mValue=NULL;
+	    ret=g_strdup_printf("%d:%d", count, blobTest_destroyCount);
+	    break;
+    }
+    g_free(content);
+    g_free(str);
+    if (mValue2)
+	mkdg_value_free(mValue2);
+    if (mValue)
+	mkdg_value_free(mValue);
+    return ret;
+}
+
+OutputRec blobTest_run_func(InputRec inputRec, Param param){
+    MkdgBlob_InputRec *inRec=(MkdgBlob_InputRec *) inputRec;
+    gchar *path=g_build_filename(g_get_tmp_dir(), "check_types_blob.dat", NULL);
+    gchar *ret=NULL;
+    if (!inRec->fileContent || g_file_set_contents(path, inRec->fileContent, -1, NULL)){
+	ret=blobTest_run_action(inRec, path);
+    }
+    g_remove(path);
+    g_free(path);
+    output_rec_set_string(result, ret);
+    return result;
+}
+
+gchar *blobTest_to_string(InputRec inputRec, Param param){
+    MkdgBlob_InputRec *inRec=(MkdgBlob_InputRec *) inputRec;
+    return g_strdup_printf("action=%d, fileContent=%s\tvalue=%s", inRec->action,
+	    (inRec->fileContent) ? inRec->fileContent : "NULL", inRec->valueStr);
+}
+
+gboolean blobTest_foreach(TestSubject *testSubject){
+    gboolean clean=TRUE;
+    MkdgBlob_TestRec *rec=(MkdgBlob_TestRec *) testSubject->dataSet;
+    for(;rec->in.valueStr!=NULL;rec++){
+	MkdgBlob_InputRec *inRec=&(rec->in);
+	OutputRec expOutRec=rec->out;
+	OutputRec actOutRec=testSubject->run(inRec, testSubject->param);
+	gchar *inStr=blobTest_to_string(inRec, testSubject->param);
+	if (!testSubject->verify(actOutRec, expOutRec, testSubject->prompt, inStr)){
+	    clean=FALSE;
+	}
+	g_free(actOutRec.v_string);
+	g_free(inStr);
+	if (!clean)
+	    return FALSE;
+    }
+    printf("All sub-test completed.\n");
+    return TRUE;
+}
+/*=== End of blob test ===*/
+
 TestSubject TEST_COLLECTION[]={
     {"Comparison functions",
 	COMPARISON_DATASET,
@@ -195,6 +1169,42 @@ TestSubject TEST_COLLECTION[]={
 	FROM_STR_DATASET,
 	{0},
 	fromStrTest_foreach, fromStrTest_run_func, int_verify_func},
+    {"Format into",
+	FORMAT_INTO_DATASET,
+	{0},
+	formatIntoTest_foreach, formatIntoTest_run_func, string_verify_func},
+    {"Parse number",
+	PARSE_NUMBER_DATASET,
+	{0},
+	parseNumberTest_foreach, parseNumberTest_run_func, string_verify_func},
+    {"Round trip",
+	ROUND_TRIP_DATASET,
+	{0},
+	roundTripTest_foreach, roundTripTest_run_func, int_verify_func},
+    {"String list",
+	STRING_LIST_DATASET,
+	{0},
+	stringListTest_foreach, stringListTest_run_func, int_verify_func},
+    {"Intern",
+	INTERN_DATASET,
+	{0},
+	internTest_foreach, internTest_run_func, int_verify_func},
+    {"Copy on write",
+	COPY_ON_WRITE_DATASET,
+	{0},
+	copyOnWriteTest_foreach, copyOnWriteTest_run_func, int_verify_func},
+    {"Hash",
+	HASH_DATASET,
+	{0},
+	hashTest_foreach, hashTest_run_func, int_verify_func},
+    {"Number array",
+	NUMBER_ARRAY_DATASET,
+	{0},
+	numberArrayTest_foreach, numberArrayTest_run_func, string_verify_func},
+    {"Blob",
+	BLOB_DATASET,
+	{0},
+	blobTest_foreach, blobTest_run_func, string_verify_func},
     {NULL,NULL, {0}, NULL, NULL, NULL},
 };
 
@@ -87,6 +87,15 @@ OutputRec stringTest_run_func(InputRec inputRec, Param param){
     return result;
 }
 
+OutputRec stringPackedTest_run_func(InputRec inputRec, Param param){
+    String_TestRec *recs=(String_TestRec *) inputRec;
+    gchar **packed=mkdg_string_split_set_packed(recs->str,recs->delimiters,recs->escapeChar, recs->emptyToken, recs->maxTokens);
+    /* Copy to a vector that g_strfreev() can free */
+    output_rec_set_pointer(result,g_strdupv(packed));
+    g_free(packed);
+    return result;
+}
+
 gboolean stringTest_foreach(TestSubject *testSubject){
     gboolean clean=TRUE;
     String_TestRec *rec=(String_TestRec *) testSubject->dataSet;
@@ -115,7 +124,7 @@ String_TestRec STRINGLIST_TEST_DATASET[]={
     {'\\',":;", FALSE, 2, "abc:\\;d\\;ef\\:/ghi\\;", STRLIST_02a},
     {'\\',":;", TRUE, 2, "abc:\\;d\\;ef\\:/ghi\\;", STRLIST_02b},
     {'+',"-:",  FALSE, -1, "test-ab-這是\\測試成功+--\\++-good", STRLIST_03a},
-    {'+',"-:",  TRUE, -1, "-test-ab-這是\\測試成功+--\\++-good", STRLIST_03b},
+    {'+',"-:",  TRUE, -1, "-test-ab--這是\\測試成功+--\\++-good", STRLIST_03b},
     {'+',"-:",  FALSE, 2, "test-ab+-+:這是\\測試成功+-+-\\+++:good", STRLIST_04a},
     {'+',"-:",  TRUE, 2, "-test+:ab+-+:這是\\測試成功+-+-\\+++:good", STRLIST_04b},
     {'\0', NULL,  FALSE, -1, NULL, NULL},
@@ -157,6 +166,10 @@ TestSubject TEST_COLLECTION[]={
 	STRINGLIST_TEST_DATASET,
 	{0},
 	stringListTest_foreach, stringListTest_run_func, string_verify_func},
+    {"mkdg_string_split_set_packed()",
+	STRING_TEST_DATASET,
+	{0},
+	stringTest_foreach, stringPackedTest_run_func, string_list_verify_func},
     {NULL,NULL, {0}, NULL, NULL, NULL},
 };
 